@@ -10,7 +10,8 @@
 // Ahora acepta el handle directamente, no un puntero a un handle.
 void termistor_init(adc_oneshot_unit_handle_t adc_handle);// inicializa el canal ADC para el termistor
 
-// Función para leer la temperatura en grados Celsius
+// Función para leer la temperatura en grados Celsius.
+// Devuelve NAN si el termistor está abierto o en corto, o si falla la lectura.
 float termistor_get_temperature_celsius(void);// lee la temperatura en grados Celsius
 
 #endif /* TERMISTOR_H_ */
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <math.h>
 #include <stdio.h>
 #include <string.h> // Necesario para la manipulación de strings si decides pasar comandos directos
 #include "freertos/FreeRTOS.h"
@@ -145,10 +146,14 @@ void app_sensors_task(void *pvParameters) {
         // ----------------------------------------------------------------------
         
         // La funcionalidad de control del LED NO SE ELIMINA, se ejecuta siempre.
-        float r_color_intensity = get_red_intensity(current_temperature);
-        float g_color_intensity = get_green_intensity(current_temperature);
-        float b_color_intensity = get_blue_intensity(current_temperature);
-        float w_color_intensity = get_white_intensity(current_temperature);
+        // Sin lectura del termistor (NAN) no hay color: el LED queda apagado.
+        float r_color_intensity = 0.0f, g_color_intensity = 0.0f, b_color_intensity = 0.0f, w_color_intensity = 0.0f;
+        if (!isnan(current_temperature)) {
+            r_color_intensity = get_red_intensity(current_temperature);
+            g_color_intensity = get_green_intensity(current_temperature);
+            b_color_intensity = get_blue_intensity(current_temperature);
+            w_color_intensity = get_white_intensity(current_temperature);
+        }
 
     uint32_t final_r_duty, final_g_duty, final_b_duty;
     if (w_color_intensity > 0.0f) {
@@ -188,7 +193,11 @@ void app_sensors_task(void *pvParameters) {
         // 5. Lógica de Impresión (CONTROLADA POR 'is_monitoring_enabled')
         if (is_monitoring_enabled) { //  Condición para activar/desactivar
             ESP_LOGI(TAG, "--- Lectura ---");
-            ESP_LOGI(TAG, "Temperatura del Termistor: %.2f C", current_temperature);
+            if (isnan(current_temperature)) {
+                ESP_LOGW(TAG, "Temperatura del Termistor: sin lectura (abierto, en corto o error del ADC)");
+            } else {
+                ESP_LOGI(TAG, "Temperatura del Termistor: %.2f C", current_temperature);
+            }
             ESP_LOGI(TAG, "Valor del Potenciómetro (Brillo): %.2f (0.0 a 1.0)", normalized_pot_value);
             // Impresión de los niveles de brillo de los LEDs eliminada intencionalmente
         } else {
@@ -1,6 +1,7 @@
 #include "potenciometro.h"
 #include "esp_log.h"
 #include "esp_adc/adc_oneshot.h"
+#include "filtro_adc.h"
 
 static const char *POT_TAG = "POTENCIOMETRO";
 
@@ -12,6 +13,8 @@ static adc_channel_t pot_channel = ADC_CHANNEL_9;
 // --- Configuración del Canal ---
 // Asumimos que el potenciómetro está conectado al GPIO35 (ADC1 Channel 7).
 #define POT_ADC_CHANNEL ADC_CHANNEL_7 
+// Lecturas por medición: se promedian las 4 centrales (los picos no entran)
+#define POT_LECTURAS    8
 
 // Función de inicialización (solo configura el canal, no inicializa la unidad)
 void potenciometro_init(adc_oneshot_unit_handle_t adc_handle) {
@@ -37,14 +40,20 @@ float potenciometro_get_normalized_value(void) {
         return 0.0f;
     }
 
-    int raw_val;
-    // Leer el valor crudo del ADC
-    esp_err_t ret = adc_oneshot_read(global_adc_handle, pot_channel, &raw_val);
+    // Leer varias muestras crudas del ADC
+    int32_t muestras[POT_LECTURAS];
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < POT_LECTURAS && ret == ESP_OK; i++) {
+        int v = 0;
+        ret = adc_oneshot_read(global_adc_handle, pot_channel, &v);
+        muestras[i] = v;
+    }
     
     if (ret != ESP_OK) {
         ESP_LOGE(POT_TAG, "Error al leer ADC: %s", esp_err_to_name(ret));
         return 0.0f;
     }
+    int raw_val = (int)filtro_media_recortada(muestras, POT_LECTURAS, 2);
 
     // Normalización: Dividir el valor crudo (máximo 4095 para 12 bits) por el máximo.
     // Usamos 4095.0f para asegurar el cálculo flotante.
@@ -1,6 +1,7 @@
 #include "termistor.h"
 #include "esp_log.h"
 #include "esp_adc/adc_oneshot.h"
+#include "filtro_adc.h"
 #include <math.h> // Necesario para la función log() y pow()
 
 static const char *TERM_TAG = "TERMISTOR";
@@ -16,6 +17,8 @@ static adc_channel_t termistor_channel = ADC_CHANNEL_9;
 #define V_REF                   3.3f 
 // Resolucion maxima del ADC (12 bits)
 #define ADC_MAX_VAL             4095.0f 
+// Lecturas por medición: se promedian las 4 centrales (los picos no entran)
+#define TERMISTOR_LECTURAS      8
 // Resistor fijo en el divisor de voltaje (comunmente 10k Ohm)
 #define SERIES_RESISTOR         10000.0f 
 
@@ -43,17 +46,32 @@ void termistor_init(adc_oneshot_unit_handle_t adc_handle) {
 // Función para obtener la temperatura en Celsius
 float termistor_get_temperature_celsius(void) {
     if (global_adc_handle == NULL) {
-        ESP_LOGE(TERM_TAG, "ADC handle no inicializado. Devuelve 0.0");
-        return 0.0f;
+        ESP_LOGE(TERM_TAG, "ADC handle no inicializado. Devuelve NAN");
+        return NAN;
     }
 
-    int raw_val;
-    // Leer el valor crudo del ADC
-    esp_err_t ret = adc_oneshot_read(global_adc_handle, termistor_channel, &raw_val);
+    // Leer varias muestras crudas del ADC
+    int32_t muestras[TERMISTOR_LECTURAS];
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < TERMISTOR_LECTURAS && ret == ESP_OK; i++) {
+        int v = 0;
+        ret = adc_oneshot_read(global_adc_handle, termistor_channel, &v);
+        muestras[i] = v;
+    }
     
     if (ret != ESP_OK) {
         ESP_LOGE(TERM_TAG, "Error al leer ADC: %s", esp_err_to_name(ret));
-        return 0.0f;
+        return NAN;
+    }
+    int raw_val = (int)filtro_media_recortada(muestras, TERMISTOR_LECTURAS, 2);
+
+    // En los extremos la fórmula de abajo no tiene solución: con 0 divide
+    // por cero (R infinita, termistor abierto) y con el tope da R = 0 (en
+    // corto, log(0)). Se trata igual que un error de lectura: NAN, que no
+    // se confunde con una temperatura.
+    if (raw_val <= 0 || raw_val >= (int)ADC_MAX_VAL) {
+        ESP_LOGE(TERM_TAG, "Termistor %s (crudo %d)", raw_val <= 0 ? "abierto" : "en corto", raw_val);
+        return NAN;
     }
 
     // 1. Calcular la Resistencia del Termistor (R_th)
@@ -0,0 +1,476 @@
+// Ida y vuelta de CborEnc con un decodificador mínimo y comparación de
+// tamaño/tiempo contra el JSON de /api/status. Devuelve 1 si algún valor
+// no vuelve igual.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "CborEnc.h"
+
+#define REPETICIONES 100000
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+static double ahora_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// ---------------------------------------------------------------
+// Decodificador mínimo (solo lo que produce CborEnc)
+// ---------------------------------------------------------------
+typedef enum { D_UINT, D_NINT, D_TEXT, D_ARRAY, D_MAP, D_BOOL, D_NULL, D_FLOAT, D_ERROR } dtype_t;
+
+typedef struct {
+    dtype_t type;
+    uint64_t arg;        // Valor, largo o cantidad de elementos
+    double f;
+    const uint8_t *text;
+} ditem_t;
+
+static float half_to_float(uint16_t h)
+{
+    int exp = (h >> 10) & 0x1F;
+    int mant = h & 0x3FF;
+    float v = (exp == 0) ? ldexpf(mant, -24)
+            : (exp == 31) ? (mant ? NAN : INFINITY)
+            : ldexpf(mant + 1024, exp - 25);
+    return (h & 0x8000) ? -v : v;
+}
+
+static ditem_t decode(const uint8_t **p, const uint8_t *end)
+{
+    ditem_t it = { .type = D_ERROR };
+    if (*p >= end) return it;
+    uint8_t ib = *(*p)++;
+    uint8_t major = ib >> 5, info = ib & 0x1F;
+
+    if (major == 7) {
+        if (info == 20 || info == 21) { it.type = D_BOOL; it.arg = info == 21; }
+        else if (info == 22) it.type = D_NULL;
+        else if (info == 25 && end - *p >= 2) {
+            it.type = D_FLOAT;
+            it.f = half_to_float((uint16_t)((*p)[0] << 8 | (*p)[1]));
+            *p += 2;
+        } else if (info == 26 && end - *p >= 4) {
+            uint32_t bits = (uint32_t)(*p)[0] << 24 | (*p)[1] << 16 | (*p)[2] << 8 | (*p)[3];
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            it.type = D_FLOAT;
+            it.f = f;
+            *p += 4;
+        }
+        return it;
+    }
+
+    uint64_t arg = info;
+    int extra = info == 24 ? 1 : info == 25 ? 2 : info == 26 ? 4 : info == 27 ? 8 : 0;
+    if (info > 27 || end - *p < extra) return it;
+    if (extra) {
+        arg = 0;
+        for (int i = 0; i < extra; i++) arg = arg << 8 | *(*p)++;
+        // Forma más corta: un argumento que entraba en menos bytes es un error
+        if (arg < (extra == 1 ? 24 : 1ull << (4 * extra))) return it;
+    }
+    it.arg = arg;
+    switch (major) {
+        case 0: it.type = D_UINT; break;
+        case 1: it.type = D_NINT; break;
+        case 3:
+            if ((uint64_t)(end - *p) < arg) return it;
+            it.type = D_TEXT;
+            it.text = *p;
+            *p += arg;
+            break;
+        case 4: it.type = D_ARRAY; break;
+        case 5: it.type = D_MAP; break;
+        default: break;
+    }
+    return it;
+}
+
+// ---------------------------------------------------------------
+// Valores sueltos
+// ---------------------------------------------------------------
+static void probar_enteros(void)
+{
+    static const int64_t casos[] = {
+        0, 1, 23, 24, 255, 256, 65535, 65536, 4294967295LL, 4294967296LL, INT64_MAX,
+        -1, -24, -25, -256, -257, -65536, -65537, -4294967296LL, -4294967297LL, INT64_MIN,
+    };
+    uint8_t buf[16];
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        cbor_enc_t e;
+        cbor_enc_init(&e, buf, sizeof(buf));
+        cbor_put_int(&e, casos[i]);
+        const uint8_t *p = buf;
+        ditem_t it = decode(&p, buf + cbor_enc_size(&e));
+        int64_t v = it.type == D_UINT ? (int64_t)it.arg : it.type == D_NINT ? -1 - (int64_t)it.arg : 0;
+        CHECK((it.type == D_UINT || it.type == D_NINT) && v == casos[i] && p == buf + cbor_enc_size(&e),
+              "int %lld", (long long)casos[i]);
+    }
+    cbor_enc_t e;
+    cbor_enc_init(&e, buf, sizeof(buf));
+    cbor_put_uint(&e, UINT64_MAX);
+    const uint8_t *p = buf;
+    ditem_t it = decode(&p, buf + cbor_enc_size(&e));
+    CHECK(it.type == D_UINT && it.arg == UINT64_MAX, "uint máximo");
+}
+
+static size_t float_ida_vuelta(float f, float *out)
+{
+    uint8_t buf[8];
+    cbor_enc_t e;
+    cbor_enc_init(&e, buf, sizeof(buf));
+    cbor_put_float(&e, f);
+    const uint8_t *p = buf;
+    ditem_t it = decode(&p, buf + cbor_enc_size(&e));
+    *out = it.type == D_FLOAT ? (float)it.f
+         : it.type == D_UINT ? (float)it.arg
+         : it.type == D_NINT ? (float)(-1 - (int64_t)it.arg) : NAN;
+    return cbor_enc_size(&e);
+}
+
+static void probar_floats(void)
+{
+    // Casos con el tamaño esperado (1..5 bytes según la forma elegida)
+    static const struct { float f; size_t len; } casos[] = {
+        { 0.0f, 1 }, { 25.0f, 2 }, { -70000.0f, 5 }, { 0.5f, 3 }, { 22.5f, 3 }, { -0.25f, 3 },
+        { 65504.5f, 5 }, { 25.37f, 5 }, { -0.1f, 5 }, { 1e-5f, 5 }, { 3e9f, 5 },
+        { INFINITY, 5 }, { -INFINITY, 5 },
+    };
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        float back;
+        size_t len = float_ida_vuelta(casos[i].f, &back);
+        CHECK(back == casos[i].f && len == casos[i].len, "float %g: %zu bytes, vuelve %g", casos[i].f, len, back);
+    }
+
+    float back;
+    float_ida_vuelta(NAN, &back);
+    CHECK(isnan(back), "NaN");
+
+    // Aleatorios: todo float finito tiene que volver bit a bit (-0 vuelve como 0)
+    int half = 0, single = 0;
+    for (int i = 0; i < 1000000; i++) {
+        uint32_t bits = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+        if (i % 4 == 0) bits &= 0xC7FFE000; // Candidatos a half
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        if (!isfinite(f)) continue;
+        size_t len = float_ida_vuelta(f, &back);
+        if (len == 3) half++;
+        if (len == 5) single++;
+        if (!(back == f)) {
+            CHECK(0, "float aleatorio %a vuelve %a", f, back);
+            break;
+        }
+    }
+    printf("floats aleatorios: %d en half, %d en single\n", half, single);
+}
+
+static void probar_texto_y_overflow(void)
+{
+    char largo[301];
+    memset(largo, 'x', 300);
+    largo[300] = '\0';
+    const char *casos[] = { "", "temp", "12345678901234567890123", "123456789012345678901234", largo };
+    uint8_t buf[400];
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        cbor_enc_t e;
+        cbor_enc_init(&e, buf, sizeof(buf));
+        cbor_put_text(&e, casos[i]);
+        const uint8_t *p = buf;
+        ditem_t it = decode(&p, buf + cbor_enc_size(&e));
+        CHECK(it.type == D_TEXT && it.arg == strlen(casos[i]) && memcmp(it.text, casos[i], it.arg) == 0,
+              "texto de %zu", strlen(casos[i]));
+    }
+
+    // Cualquier capacidad menor al total termina en overflow (tamaño 0)
+    for (size_t cap = 0; cap < 12; cap++) {
+        cbor_enc_t e;
+        cbor_enc_init(&e, buf, cap);
+        cbor_put_map(&e, 1);
+        cbor_put_text(&e, "temp");
+        cbor_put_float(&e, 25.37f);
+        CHECK(cbor_enc_size(&e) == (cap >= 11 ? 11 : 0), "overflow con cap %zu", cap);
+    }
+}
+
+// ---------------------------------------------------------------
+// /api/status: CBOR contra JSON
+// ---------------------------------------------------------------
+typedef struct {
+    bool active;
+    uint8_t days, priority, zones;
+    uint16_t start_min, end_min;
+    float t_zero, t_hundred;
+} horario_t;
+
+typedef struct {
+    float temp, sd;
+    bool pir, win, fault;
+    uint8_t pwm;
+    int mode;
+} zona_t;
+
+typedef struct {
+    float temp, a_min, a_max, fps;
+    bool fault, pir, online, motion;
+    int pwm, mode, man_pwm, wake_ms;
+    long long last_sync;
+    uint32_t dropped, i2c_err, hold_s, sessions, false_vac, missed, occ_s;
+    horario_t sched[16];
+    int sched_count;
+    zona_t zones[4];
+    int zone_count;
+} estado_t;
+
+// Mismo orden y claves que status_get_cbor()
+static size_t status_cbor(const estado_t *s, uint8_t *buf, size_t cap)
+{
+    cbor_enc_t enc;
+    cbor_enc_init(&enc, buf, cap);
+    cbor_put_map(&enc, 17);
+    cbor_put_text(&enc, "temp");      cbor_put_float(&enc, s->temp);
+    cbor_put_text(&enc, "fault");     cbor_put_bool(&enc, s->fault);
+    cbor_put_text(&enc, "pir");       cbor_put_bool(&enc, s->pir);
+    cbor_put_text(&enc, "pwm");       cbor_put_int(&enc, s->pwm);
+    cbor_put_text(&enc, "mode");      cbor_put_int(&enc, s->mode);
+    cbor_put_text(&enc, "man_pwm");   cbor_put_int(&enc, s->man_pwm);
+    cbor_put_text(&enc, "a_min");     cbor_put_float(&enc, s->a_min);
+    cbor_put_text(&enc, "a_max");     cbor_put_float(&enc, s->a_max);
+    cbor_put_text(&enc, "wake_ms");   cbor_put_int(&enc, s->wake_ms);
+    cbor_put_text(&enc, "time_sync"); cbor_put_text(&enc, "synced");
+    cbor_put_text(&enc, "last_sync"); cbor_put_int(&enc, s->last_sync);
+    cbor_put_text(&enc, "display");
+    cbor_put_map(&enc, 4);
+    cbor_put_text(&enc, "online");    cbor_put_bool(&enc, s->online);
+    cbor_put_text(&enc, "fps");       cbor_put_float(&enc, s->fps);
+    cbor_put_text(&enc, "dropped");   cbor_put_uint(&enc, s->dropped);
+    cbor_put_text(&enc, "i2c_err");   cbor_put_uint(&enc, s->i2c_err);
+    cbor_put_text(&enc, "occ");
+    cbor_put_map(&enc, 6);
+    cbor_put_text(&enc, "motion");    cbor_put_bool(&enc, s->motion);
+    cbor_put_text(&enc, "hold_s");    cbor_put_uint(&enc, s->hold_s);
+    cbor_put_text(&enc, "sessions");  cbor_put_uint(&enc, s->sessions);
+    cbor_put_text(&enc, "false_vac"); cbor_put_uint(&enc, s->false_vac);
+    cbor_put_text(&enc, "missed");    cbor_put_uint(&enc, s->missed);
+    cbor_put_text(&enc, "occ_s");     cbor_put_uint(&enc, s->occ_s);
+    cbor_put_text(&enc, "sched_fmt");
+    cbor_put_array(&enc, 8);
+    static const char *const fields[] = { "act", "days", "prio", "sm", "em", "t0", "t100", "zones" };
+    for (int i = 0; i < 8; i++) cbor_put_text(&enc, fields[i]);
+    cbor_put_text(&enc, "schedules");
+    cbor_put_array(&enc, s->sched_count);
+    for (int i = 0; i < s->sched_count; i++) {
+        const horario_t *h = &s->sched[i];
+        cbor_put_array(&enc, 8);
+        cbor_put_bool(&enc, h->active);
+        cbor_put_uint(&enc, h->days);
+        cbor_put_uint(&enc, h->priority);
+        cbor_put_uint(&enc, h->start_min);
+        cbor_put_uint(&enc, h->end_min);
+        cbor_put_float(&enc, h->t_zero);
+        cbor_put_float(&enc, h->t_hundred);
+        cbor_put_uint(&enc, h->zones);
+    }
+    cbor_put_text(&enc, "zone_fmt");
+    cbor_put_array(&enc, 7);
+    static const char *const zone_fields[] = { "temp", "pir", "pwm", "mode", "win", "sd", "fault" };
+    for (int i = 0; i < 7; i++) cbor_put_text(&enc, zone_fields[i]);
+    cbor_put_text(&enc, "zones");
+    cbor_put_array(&enc, s->zone_count);
+    for (int z = 0; z < s->zone_count; z++) {
+        const zona_t *zs = &s->zones[z];
+        cbor_put_array(&enc, 7);
+        cbor_put_float(&enc, zs->temp);
+        cbor_put_bool(&enc, zs->pir);
+        cbor_put_uint(&enc, zs->pwm);
+        cbor_put_int(&enc, zs->mode);
+        cbor_put_bool(&enc, zs->win);
+        cbor_put_float(&enc, zs->sd);
+        cbor_put_bool(&enc, zs->fault);
+    }
+    return cbor_enc_size(&enc);
+}
+
+// Números como cJSON_PrintUnformatted(): entero si lo es, si no %1.15g y,
+// si no vuelve igual, %1.17g (los float llegan como double)
+typedef struct { char *p, *end; } jw_t;
+
+static void jw_raw(jw_t *w, const char *s)
+{
+    size_t n = strlen(s);
+    if (w->end - w->p > (long)n) { memcpy(w->p, s, n); w->p += n; }
+}
+
+static void jw_num(jw_t *w, const char *key, double d)
+{
+    char tmp[32];
+    if (key) { jw_raw(w, "\""); jw_raw(w, key); jw_raw(w, "\":"); }
+    if (isnan(d) || isinf(d)) strcpy(tmp, "null");
+    else if (d == (double)(int)d) snprintf(tmp, sizeof(tmp), "%d", (int)d);
+    else {
+        snprintf(tmp, sizeof(tmp), "%1.15g", d);
+        if (strtod(tmp, NULL) != d) snprintf(tmp, sizeof(tmp), "%1.17g", d);
+    }
+    jw_raw(w, tmp);
+    jw_raw(w, ",");
+}
+
+static void jw_bool(jw_t *w, const char *key, bool b)
+{
+    jw_raw(w, "\""); jw_raw(w, key); jw_raw(w, "\":");
+    jw_raw(w, b ? "true," : "false,");
+}
+
+static void jw_open(jw_t *w, const char *key, const char *brace)
+{
+    if (key) { jw_raw(w, "\""); jw_raw(w, key); jw_raw(w, "\":"); }
+    jw_raw(w, brace);
+}
+
+static void jw_close(jw_t *w, char brace)
+{
+    if (w->p[-1] == ',') w->p--;
+    *w->p++ = brace;
+    *w->p++ = ',';
+}
+
+// Mismas claves que la rama JSON de status_get_handler()
+static size_t status_json(const estado_t *s, char *buf, size_t cap)
+{
+    jw_t w = { buf, buf + cap };
+    jw_open(&w, NULL, "{");
+    jw_num(&w, "temp", s->temp);
+    jw_bool(&w, "fault", s->fault);
+    jw_bool(&w, "pir", s->pir);
+    jw_num(&w, "pwm", s->pwm);
+    jw_num(&w, "mode", s->mode);
+    jw_num(&w, "man_pwm", s->man_pwm);
+    jw_num(&w, "a_min", s->a_min);
+    jw_num(&w, "a_max", s->a_max);
+    jw_num(&w, "wake_ms", s->wake_ms);
+    jw_raw(&w, "\"time_sync\":\"synced\",");
+    jw_num(&w, "last_sync", (double)s->last_sync);
+    jw_open(&w, "display", "{");
+    jw_bool(&w, "online", s->online);
+    jw_num(&w, "fps", s->fps);
+    jw_num(&w, "dropped", s->dropped);
+    jw_num(&w, "i2c_err", s->i2c_err);
+    jw_close(&w, '}');
+    jw_open(&w, "occ", "{");
+    jw_bool(&w, "motion", s->motion);
+    jw_num(&w, "hold_s", s->hold_s);
+    jw_num(&w, "sessions", s->sessions);
+    jw_num(&w, "false_vac", s->false_vac);
+    jw_num(&w, "missed", s->missed);
+    jw_num(&w, "occ_s", s->occ_s);
+    jw_close(&w, '}');
+    jw_open(&w, "schedules", "[");
+    for (int i = 0; i < s->sched_count; i++) {
+        const horario_t *h = &s->sched[i];
+        jw_open(&w, NULL, "{");
+        jw_bool(&w, "act", h->active);
+        jw_num(&w, "days", h->days);
+        jw_num(&w, "prio", h->priority);
+        jw_num(&w, "sm", h->start_min);
+        jw_num(&w, "em", h->end_min);
+        jw_num(&w, "sh", h->start_min / 60);
+        jw_num(&w, "eh", h->end_min / 60);
+        jw_num(&w, "t0", h->t_zero);
+        jw_num(&w, "t100", h->t_hundred);
+        jw_num(&w, "zones", h->zones);
+        jw_close(&w, '}');
+    }
+    jw_close(&w, ']');
+    jw_open(&w, "zones", "[");
+    for (int z = 0; z < s->zone_count; z++) {
+        const zona_t *zs = &s->zones[z];
+        jw_open(&w, NULL, "{");
+        jw_num(&w, "temp", zs->temp);
+        jw_num(&w, "sd", zs->sd);
+        jw_bool(&w, "fault", zs->fault);
+        jw_bool(&w, "pir", zs->pir);
+        jw_num(&w, "pwm", zs->pwm);
+        jw_num(&w, "mode", zs->mode);
+        jw_bool(&w, "win", zs->win);
+        jw_close(&w, '}');
+    }
+    jw_close(&w, ']');
+    jw_close(&w, '}');
+    w.p--; // Sin la coma final
+    return (size_t)(w.p - buf);
+}
+
+// Recorre el CBOR completo y cuenta elementos: tiene que consumir todo el buffer
+static int contar(const uint8_t **p, const uint8_t *end)
+{
+    ditem_t it = decode(p, end);
+    if (it.type == D_ERROR) return -1000000;
+    int n = 1;
+    uint64_t hijos = it.type == D_ARRAY ? it.arg : it.type == D_MAP ? 2 * it.arg : 0;
+    for (uint64_t i = 0; i < hijos; i++) n += contar(p, end);
+    return n;
+}
+
+static void comparar_status(int sched_count)
+{
+    estado_t s = {
+        .temp = 25.37f, .a_min = 20.0f, .a_max = 30.0f, .fps = 9.8f,
+        .pir = true, .online = true, .motion = true,
+        .pwm = 42, .mode = 2, .man_pwm = 50, .wake_ms = -1, .last_sync = 1760860800,
+        .dropped = 3, .hold_s = 120, .sessions = 17, .false_vac = 1, .occ_s = 5400,
+        .sched_count = sched_count, .zone_count = 4,
+    };
+    for (int i = 0; i < sched_count; i++) {
+        s.sched[i] = (horario_t){ i % 3 != 0, 0x3E, (uint8_t)(i % 3), 0x0F,
+                                  (uint16_t)(60 * (i % 24)), (uint16_t)(60 * (i % 24) + 90),
+                                  18.0f + 0.5f * i, 28.0f + 0.25f * i };
+    }
+    for (int z = 0; z < 4; z++) {
+        s.zones[z] = (zona_t){ 24.1f + 0.37f * z, 0.02f, z == 0, z == 1, false, (uint8_t)(25 * z), 2 };
+    }
+
+    uint8_t cbor[1024];
+    char json[4096];
+    size_t ncbor = 0, njson = 0;
+    volatile size_t sink = 0;
+
+    double t0 = ahora_ns();
+    for (int r = 0; r < REPETICIONES; r++) sink += ncbor = status_cbor(&s, cbor, sizeof(cbor));
+    double t_cbor = (ahora_ns() - t0) / REPETICIONES;
+
+    t0 = ahora_ns();
+    for (int r = 0; r < REPETICIONES; r++) sink += njson = status_json(&s, json, sizeof(json));
+    double t_json = (ahora_ns() - t0) / REPETICIONES;
+    (void)sink;
+
+    const uint8_t *p = cbor;
+    int items = contar(&p, cbor + ncbor);
+    CHECK(ncbor > 0 && p == cbor + ncbor && items > 0, "status con %d horarios no decodifica", sched_count);
+
+    printf("%2d horarios: CBOR %4zu B %6.0f ns | JSON %4zu B %6.0f ns | CBOR/JSON %.0f %% del tamaño\n",
+           sched_count, ncbor, t_cbor, njson, t_json, 100.0 * ncbor / njson);
+}
+
+int main(void)
+{
+    srand(1);
+    probar_enteros();
+    probar_floats();
+    probar_texto_y_overflow();
+
+    printf("status (JSON con el formato de números de cJSON, sin su árbol en el heap):\n");
+    comparar_status(0);
+    comparar_status(3);
+    comparar_status(16);
+
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
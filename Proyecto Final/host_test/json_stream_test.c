@@ -0,0 +1,306 @@
+// JsonStream: casos fijos, fuzz por mutación y throughput con el esquema de
+// /api/settings. Devuelve 1 si algún caso falla o el fuzz rompe un invariante.
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "JsonStream.h"
+#include "Settings.h"
+#include "Schedule.h"
+
+#define FUZZ_ITERACIONES 200000
+#define BENCH_BYTES      (64 * 1024 * 1024)
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+static double ahora_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// Copia del esquema de /api/settings (http_server.c)
+typedef struct {
+    settings_t cfg;
+    uint16_t sched_count;
+    schedule_t schedules[SCHEDULE_MAX_WINDOWS];
+} settings_req_t;
+
+static const json_field_t settings_fields[] = {
+    { "mode",       JSON_FIELD_INT,   SETTINGS_MODE_MANUAL, SETTINGS_MODE_PROG, 0, offsetof(settings_req_t, cfg.system_mode) },
+    { "manual_pwm", JSON_FIELD_INT,   0,                    100,                0, offsetof(settings_req_t, cfg.manual_pwm) },
+    { "auto_tmin",  JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN,    SETTINGS_TEMP_MAX,  0, offsetof(settings_req_t, cfg.auto_tmin) },
+    { "auto_tmax",  JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN,    SETTINGS_TEMP_MAX,  0, offsetof(settings_req_t, cfg.auto_tmax) },
+};
+
+static const json_order_t settings_order[] = {
+    { offsetof(settings_req_t, cfg.auto_tmin), offsetof(settings_req_t, cfg.auto_tmax), "auto_tmin/auto_tmax" },
+};
+
+static const json_field_t schedule_fields[] = {
+    { "act",   JSON_FIELD_BOOL,  0,                 1,                   0,  offsetof(schedule_t, active) },
+    { "days",  JSON_FIELD_U8,    0,                 SCHEDULE_ALL_DAYS,   0,  offsetof(schedule_t, days) },
+    { "prio",  JSON_FIELD_U8,    0,                 255,                 0,  offsetof(schedule_t, priority) },
+    { "zones", JSON_FIELD_U8,    0,                 SCHEDULE_ALL_ZONES,  0,  offsetof(schedule_t, zones) },
+    { "sm",    JSON_FIELD_U16,   0,                 MINUTES_PER_DAY - 1, 0,  offsetof(schedule_t, start_min) },
+    { "em",    JSON_FIELD_U16,   0,                 MINUTES_PER_DAY,     0,  offsetof(schedule_t, end_min) },
+    { "sh",    JSON_FIELD_U16,   0,                 23,                  60, offsetof(schedule_t, start_min) },
+    { "eh",    JSON_FIELD_U16,   0,                 24,                  60, offsetof(schedule_t, end_min) },
+    { "t0",    JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN, SETTINGS_TEMP_MAX,   0,  offsetof(schedule_t, t_zero) },
+    { "t100",  JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN, SETTINGS_TEMP_MAX,   0,  offsetof(schedule_t, t_hundred) },
+};
+
+static const json_order_t schedule_order[] = {
+    { offsetof(schedule_t, t_zero), offsetof(schedule_t, t_hundred), "t0/t100" },
+};
+
+static const json_schema_t settings_schema = {
+    .fields = settings_fields,
+    .n_fields = sizeof(settings_fields) / sizeof(settings_fields[0]),
+    .order = settings_order,
+    .n_order = sizeof(settings_order) / sizeof(settings_order[0]),
+    .array_key = "schedules",
+    .item_fields = schedule_fields,
+    .n_item_fields = sizeof(schedule_fields) / sizeof(schedule_fields[0]),
+    .item_order = schedule_order,
+    .n_item_order = sizeof(schedule_order) / sizeof(schedule_order[0]),
+    .array_offset = offsetof(settings_req_t, schedules),
+    .count_offset = offsetof(settings_req_t, sched_count),
+    .stride = sizeof(schedule_t),
+    .max_items = SCHEDULE_MAX_WINDOWS,
+};
+
+static const schedule_t sched_default = {
+    false, SCHEDULE_ALL_DAYS, 0, SCHEDULE_ALL_ZONES, 8 * 60, 12 * 60, 20.0, 30.0,
+};
+
+static const settings_req_t base = {
+    .cfg = { SETTINGS_MODE_MANUAL, 50, 20.0f, 30.0f },
+};
+
+// Parsea en trozos de 'paso' bytes (0 = todo junto)
+static esp_err_t parsear(const char *doc, size_t len, size_t paso, settings_req_t *out, json_stream_t *js)
+{
+    *out = base;
+    json_stream_init(js, &settings_schema, out, &sched_default);
+    if (paso == 0) paso = len ? len : 1;
+    esp_err_t err = ESP_OK;
+    for (size_t i = 0; i < len && err == ESP_OK; i += paso) {
+        err = json_stream_feed(js, doc + i, len - i < paso ? len - i : paso);
+    }
+    if (err == ESP_OK) err = json_stream_finish(js);
+    return err;
+}
+
+// ---------------------------------------------------------------
+// Casos fijos: aceptados o rechazados con el mensaje esperado
+// ---------------------------------------------------------------
+static const struct {
+    const char *doc;
+    const char *err;     // NULL = aceptado; si no, prefijo de err_msg
+} casos[] = {
+    { "{\"mode\":1,\"manual_pwm\":40}",                          NULL },
+    { "{\"mode\":1.0}",                                          NULL },
+    { "{\"mode\":1e0}",                                          NULL },
+    { "{\"mode\":null,\"auto_tmin\":21.5}",                      NULL },
+    { "{\"otra\":{\"x\":[1,\"a\",{\"mode\":9}]},\"mode\":2}",    NULL },
+    { "{\"schedules\":[]}",                                      NULL },
+    { "{\"schedules\":null}",                                    NULL },
+    { "{\"schedules\":[{\"sh\":8,\"eh\":12,\"t0\":20,\"t100\":30}]}", NULL },
+    { "{\"mode\":1.9}",                                          "se esperaba un entero: mode" },
+    { "{\"manual_pwm\":50.5}",                                   "se esperaba un entero: manual_pwm" },
+    { "{\"schedules\":[{\"sm\":60.25}]}",                        "se esperaba un entero: sm" },
+    { "{\"schedules\":[{\"sh\":7.5}]}",                          "se esperaba un entero: sh" },
+    { "{\"schedules\":[1]}",                                     "se esperaba un objeto: schedules" },
+    { "{\"schedules\":[{},\"x\"]}",                              "se esperaba un objeto: schedules" },
+    { "{\"schedules\":[null]}",                                  "se esperaba un objeto: schedules" },
+    { "{\"schedules\":[[]]}",                                    "se esperaba un objeto: schedules" },
+    { "{\"schedules\":[{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}]}", "demasiados elementos: schedules" },
+    { "{\"mode\":3}",                                            "fuera de rango: mode" },
+    { "{\"mode\":\"1\"}",                                        "tipo invalido: mode" },
+    { "{\"mode\":[1]}",                                          "tipo invalido: mode" },
+    { "{\"auto_tmin\":30,\"auto_tmax\":20}",                     "minimo >= maximo" },
+    { "{\"schedules\":[{\"t0\":30,\"t100\":30}]}",               "minimo >= maximo" },
+    { "{\"mode\":1,}",                                           "se esperaba una clave" },
+    { "{\"mode\":tru}",                                          "literal invalido" },
+    { "{\"mode\":1}x",                                           "datos despues del objeto" },
+    { "[1]",                                                     "se esperaba un objeto" },
+    { "{\"mode\":1",                                             "JSON incompleto" },
+};
+
+static void probar_casos(void)
+{
+    for (size_t c = 0; c < sizeof(casos) / sizeof(casos[0]); c++) {
+        const char *doc = casos[c].doc;
+        size_t len = strlen(doc);
+        // El resultado no puede depender de cómo llegan los trozos
+        for (size_t paso = 0; paso <= len; paso++) {
+            settings_req_t out;
+            json_stream_t js;
+            esp_err_t err = parsear(doc, len, paso, &out, &js);
+            bool ok = casos[c].err ? (err != ESP_OK && strncmp(js.err_msg, casos[c].err, strlen(casos[c].err)) == 0)
+                                   : err == ESP_OK;
+            if (!ok) {
+                CHECK(0, "%s (paso %zu): err=%d \"%s\"", doc, paso, err, js.err_msg);
+                break;
+            }
+        }
+    }
+
+    // Valores guardados
+    settings_req_t out;
+    json_stream_t js;
+    const char *doc = "{\"mode\":2,\"manual_pwm\":75,\"auto_tmin\":18.5,\"auto_tmax\":26,"
+                      "\"schedules\":[{\"act\":1,\"sh\":7,\"em\":615,\"days\":62,\"t0\":19.25,\"t100\":27}]}";
+    esp_err_t err = parsear(doc, strlen(doc), 7, &out, &js);
+    CHECK(err == ESP_OK && out.cfg.system_mode == 2 && out.cfg.manual_pwm == 75 &&
+          out.cfg.auto_tmin == 18.5f && out.cfg.auto_tmax == 26.0f && out.sched_count == 1 &&
+          out.schedules[0].active && out.schedules[0].start_min == 420 && out.schedules[0].end_min == 615 &&
+          out.schedules[0].days == 62 && out.schedules[0].zones == SCHEDULE_ALL_ZONES &&
+          out.schedules[0].t_zero == 19.25f && out.schedules[0].t_hundred == 27.0f,
+          "valores de %s", doc);
+}
+
+// ---------------------------------------------------------------
+// Fuzz: mutaciones de documentos válidos. Invariantes:
+//  - nunca lee ni escribe fuera de 'out' (compilar con SAN=1)
+//  - mismo resultado todo junto y byte a byte
+//  - si acepta, todos los campos quedan dentro del esquema
+// ---------------------------------------------------------------
+static const char *semillas[] = {
+    "{\"mode\":2,\"manual_pwm\":75,\"auto_tmin\":18.5,\"auto_tmax\":26}",
+    "{\"schedules\":[{\"act\":true,\"days\":127,\"prio\":1,\"zones\":3,\"sm\":480,\"em\":720,\"t0\":20,\"t100\":30},"
+    "{\"act\":false,\"sh\":14,\"eh\":18,\"t0\":22.5,\"t100\":32}]}",
+    "{\"x\":[{\"y\":null},-1.5e3,\"\\\"s\\\\\"],\"mode\":0,\"schedules\":[{}]}",
+};
+
+static const char alfabeto[] = "{}[]:,\"\\ 0123456789.-+eE truefalsnl";
+
+static size_t mutar(char *buf, size_t len, size_t cap)
+{
+    int n = 1 + rand() % 4;
+    for (int k = 0; k < n; k++) {
+        size_t pos = len ? (size_t)rand() % len : 0;
+        switch (rand() % 5) {
+            case 0: // Reemplazar
+                if (len) buf[pos] = alfabeto[rand() % (sizeof(alfabeto) - 1)];
+                break;
+            case 1: // Insertar
+                if (len < cap) {
+                    memmove(buf + pos + 1, buf + pos, len - pos);
+                    buf[pos] = alfabeto[rand() % (sizeof(alfabeto) - 1)];
+                    len++;
+                }
+                break;
+            case 2: // Borrar
+                if (len) { memmove(buf + pos, buf + pos + 1, len - pos - 1); len--; }
+                break;
+            case 3: // Duplicar un tramo (arreglos largos, anidamiento)
+                {
+                    size_t tramo = 1 + rand() % 24;
+                    if (pos + tramo <= len && len + tramo <= cap) {
+                        memmove(buf + pos + tramo, buf + pos, len - pos);
+                        len += tramo;
+                    }
+                }
+                break;
+            case 4: // Cortar
+                len = pos;
+                break;
+        }
+    }
+    return len;
+}
+
+static bool dentro_del_esquema(const settings_req_t *o)
+{
+    if (o->cfg.system_mode < SETTINGS_MODE_MANUAL || o->cfg.system_mode > SETTINGS_MODE_PROG) return false;
+    if (o->cfg.manual_pwm < 0 || o->cfg.manual_pwm > 100) return false;
+    if (!(o->cfg.auto_tmin < o->cfg.auto_tmax)) return false;
+    if (o->sched_count > SCHEDULE_MAX_WINDOWS) return false;
+    for (int i = 0; i < o->sched_count; i++) {
+        const schedule_t *s = &o->schedules[i];
+        if (s->days > SCHEDULE_ALL_DAYS || s->start_min >= MINUTES_PER_DAY || s->end_min > MINUTES_PER_DAY) return false;
+        if (!(s->t_zero < s->t_hundred)) return false;
+    }
+    return true;
+}
+
+static void fuzz(void)
+{
+    char buf[1024];
+    int aceptados = 0;
+    for (int it = 0; it < FUZZ_ITERACIONES; it++) {
+        const char *semilla = semillas[rand() % (sizeof(semillas) / sizeof(semillas[0]))];
+        size_t len = strlen(semilla);
+        memcpy(buf, semilla, len);
+        len = mutar(buf, len, sizeof(buf));
+
+        // Copia exacta en el heap: ASan detecta cualquier lectura pasada del final
+        char *doc = malloc(len ? len : 1);
+        memcpy(doc, buf, len);
+
+        settings_req_t a, b;
+        json_stream_t ja, jb;
+        esp_err_t ea = parsear(doc, len, 0, &a, &ja);
+        esp_err_t eb = parsear(doc, len, 1 + rand() % 5, &b, &jb);
+
+        if (ea != eb || (ea == ESP_OK && memcmp(&a, &b, sizeof(a)) != 0) ||
+            (ea != ESP_OK && strcmp(ja.err_msg, jb.err_msg) != 0)) {
+            CHECK(0, "resultado distinto según los trozos: %.*s", (int)len, doc);
+        } else if (ea == ESP_OK) {
+            aceptados++;
+            if (!dentro_del_esquema(&a)) CHECK(0, "aceptado fuera del esquema: %.*s", (int)len, doc);
+        } else if (ja.err_msg[0] == '\0') {
+            CHECK(0, "error sin mensaje: %.*s", (int)len, doc);
+        }
+        free(doc);
+        if (malas > 10) break;
+    }
+    printf("fuzz: %d documentos, %d aceptados\n", FUZZ_ITERACIONES, aceptados);
+}
+
+// ---------------------------------------------------------------
+// Throughput con el POST más grande que manda la web (16 horarios)
+// ---------------------------------------------------------------
+static void bench(void)
+{
+    char doc[4096];
+    int n = snprintf(doc, sizeof(doc), "{\"mode\":2,\"manual_pwm\":40,\"auto_tmin\":20.5,\"auto_tmax\":28,\"schedules\":[");
+    for (int i = 0; i < SCHEDULE_MAX_WINDOWS; i++) {
+        n += snprintf(doc + n, sizeof(doc) - n,
+                      "%s{\"act\":%s,\"days\":%d,\"prio\":%d,\"zones\":%d,\"sm\":%d,\"em\":%d,\"t0\":%.2f,\"t100\":%.2f}",
+                      i ? "," : "", i % 3 ? "true" : "false", 0x3E, i % 3, 0x0F, 60 * i, 60 * i + 90,
+                      18 + 0.25 * i, 28 + 0.5 * i);
+    }
+    n += snprintf(doc + n, sizeof(doc) - n, "]}");
+
+    static const size_t pasos[] = { 1, 64, 536, 0 };
+    for (size_t p = 0; p < sizeof(pasos) / sizeof(pasos[0]); p++) {
+        int reps = BENCH_BYTES / n;
+        settings_req_t out;
+        json_stream_t js;
+        double t0 = ahora_ns();
+        for (int r = 0; r < reps; r++) {
+            if (parsear(doc, n, pasos[p], &out, &js) != ESP_OK) { CHECK(0, "bench: %s", js.err_msg); return; }
+        }
+        double ns = (ahora_ns() - t0) / reps;
+        char paso[16];
+        snprintf(paso, sizeof(paso), pasos[p] ? "%zu B" : "entero", pasos[p]);
+        printf("documento de %d B en trozos de %-6s: %6.2f us/doc, %6.1f MB/s\n", n, paso, ns / 1000, n / ns * 1000);
+    }
+}
+
+int main(void)
+{
+    srand(1);
+    probar_casos();
+    fuzz();
+    bench();
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
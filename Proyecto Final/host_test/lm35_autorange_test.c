@@ -0,0 +1,203 @@
+// Temp_LM35.c contra un ADC simulado: calibración ideal (el fondo de escala
+// de cada atenuación), ruido gaussiano de 4 cuentas y una lectura cada
+// 100 ms. Se compila dos veces, con CONFIG_VENT_LM35_AUTORANGE en 1 y en 0:
+//   rampa     20 -> 120 -> 20 °C a 1 °C/s: dónde cambia de atenuación y el
+//             peor error (ninguna lectura fuera de rango llega a la salida)
+//   borde     oscilando entre 87 y 90 °C, justo en el límite de 0 dB:
+//             cuántas veces conmuta
+//   quieto    25 °C: desvío de la salida y lecturas del ADC por medición
+// Devuelve 1 si algo no cumple.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Temp_LM35.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "nvs.h"
+#include "sdkconfig.h"
+
+#define TICK_MS    100
+#define RUIDO_LSB  4.0
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+// ---------------------------------------------------------------
+// ADC simulado
+// ---------------------------------------------------------------
+static const int fondo_mv[] = { 1100, 1500, 2200, 3300 };
+static adc_atten_t aten[8];
+static double tension_mv;
+static long lecturas;
+static int64_t reloj_us;
+
+static double gauss(void)
+{
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+esp_err_t adc_oneshot_new_unit(const adc_oneshot_unit_init_cfg_t *cfg, adc_oneshot_unit_handle_t *h)
+{
+    (void)cfg;
+    *h = NULL;
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_config_channel(adc_oneshot_unit_handle_t h, adc_channel_t ch, const adc_oneshot_chan_cfg_t *cfg)
+{
+    (void)h;
+    aten[ch] = cfg->atten;
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t h, adc_channel_t ch, int *raw)
+{
+    (void)h;
+    lecturas++;
+    long q = lround(tension_mv / fondo_mv[aten[ch]] * 4095 + RUIDO_LSB * gauss());
+    *raw = q < 0 ? 0 : q > 4095 ? 4095 : (int)q;
+    return ESP_OK;
+}
+
+struct adc_cali_scheme { adc_atten_t aten; };
+static struct adc_cali_scheme esquemas[4];
+
+esp_err_t adc_cali_create_scheme_line_fitting(const adc_cali_line_fitting_config_t *cfg, adc_cali_handle_t *h)
+{
+    esquemas[cfg->atten].aten = cfg->atten;
+    *h = &esquemas[cfg->atten];
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_delete_scheme_line_fitting(adc_cali_handle_t h) { (void)h; return ESP_OK; }
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t h, int raw, int *mv)
+{
+    *mv = (int)lround(raw * fondo_mv[h->aten] / 4095.0);
+    return ESP_OK;
+}
+
+void esp_rom_delay_us(uint32_t us) { (void)us; }
+int64_t esp_timer_get_time(void) { return reloj_us; }
+
+// Sin calibración guardada
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *h) { (void)ns; (void)mode; *h = 1; return ESP_OK; }
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *key, void *v, size_t *len)
+{
+    (void)h; (void)key; (void)v; (void)len;
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *key, const void *v, size_t len) { (void)h; (void)key; (void)v; (void)len; return ESP_OK; }
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *key) { (void)h; (void)key; return ESP_OK; }
+esp_err_t nvs_commit(nvs_handle_t h) { (void)h; return ESP_OK; }
+void nvs_close(nvs_handle_t h) { (void)h; }
+
+// ---------------------------------------------------------------
+// Escenarios
+// ---------------------------------------------------------------
+static float leer(double temp_c)
+{
+    tension_mv = temp_c * 10;
+    reloj_us += TICK_MS * 1000;
+    return temp_sensor_read_celsius();
+}
+
+// De la temperatura actual a 'temp_c' a 1 °C/s, como la cápsula
+static double actual_c = 20;
+
+static void llevar_a(double temp_c)
+{
+    while (fabs(actual_c - temp_c) > 0.05) {
+        actual_c += actual_c < temp_c ? 0.1 : -0.1;
+        leer(actual_c);
+    }
+    actual_c = temp_c;
+}
+
+static void probar_rampa(void)
+{
+    const int pasos = 1000;     // 100 °C a 0.1 °C por lectura
+    for (int i = 0; i < 100; i++) leer(20);
+
+    double peor = 0, sube_c = NAN, baja_c = NAN;
+    int cambios = 0;
+    for (int i = 1; i <= 2 * pasos; i++) {
+        double t = i <= pasos ? 20 + i * 0.1 : 120 - (i - pasos) * 0.1;
+        adc_atten_t antes = aten[LM35_ADC_CHANNEL];
+        float y = leer(t);
+        adc_atten_t despues = aten[LM35_ADC_CHANNEL];
+        if (despues != antes) {
+            cambios++;
+            if (despues > antes) sube_c = t;
+            else baja_c = t;
+        }
+        if (!isnan(y) && fabs(y - t) > peor) peor = fabs(y - t);
+        CHECK(!isnan(y), "sin lectura a %.1f C", t);
+    }
+    printf("rampa:  %d cambios de atenuación (sube a %.1f C, baja a %.1f C), error max %.2f C\n",
+           cambios, sube_c, baja_c, peor);
+
+#if CONFIG_VENT_LM35_AUTORANGE
+    // 0 dB llega a 90 °C; baja recién 5 °C por debajo
+    CHECK(cambios == 2, "%d cambios de atenuación en la rampa", cambios);
+    CHECK(sube_c > 89.5 && sube_c < 91.5, "sube a %.1f C", sube_c);
+    CHECK(baja_c > 83.5 && baja_c < 85.5, "baja a %.1f C", baja_c);
+#else
+    CHECK(cambios == 0, "con el rango fijo cambió %d veces", cambios);
+#endif
+    // Una lectura saturada daría un salto de varios grados
+    CHECK(peor < 1.0, "error %.2f C en la rampa", peor);
+}
+
+static void probar_borde(void)
+{
+    llevar_a(88.5);
+    int cambios = 0;
+    for (int i = 0; i < 1000; i++) {
+        adc_atten_t antes = aten[LM35_ADC_CHANNEL];
+        leer(88.5 + 1.5 * sin(2 * M_PI * i / 200.0));     // Período de 20 s
+        if (aten[LM35_ADC_CHANNEL] != antes) cambios++;
+    }
+    printf("borde:  %d cambios en 1000 lecturas entre 87 y 90 C\n", cambios);
+    // Sube una vez y la histéresis lo deja arriba
+    CHECK(cambios <= 1, "%d cambios cerca del límite de 0 dB", cambios);
+}
+
+static void probar_quieto(void)
+{
+    llevar_a(25);
+    for (int i = 0; i < 600; i++) leer(25);
+    const int n = 2000;
+    double s = 0, s2 = 0;
+    lecturas = 0;
+    for (int i = 0; i < n; i++) {
+        double y = leer(25);
+        s += y;
+        s2 += y * y;
+    }
+    double media = s / n, desvio = sqrt(s2 / n - media * media);
+    printf("quieto: media %.3f C, desvío %.4f C, %ld lecturas del ADC por medición\n", media, desvio, lecturas / n);
+    CHECK(fabs(media - 25) < 0.05, "media %.3f C a 25 C", media);
+#if CONFIG_VENT_LM35_AUTORANGE
+    // Un tercio de las lecturas del rango fijo con el mismo ruido que este
+    // (0.015 °C en esta simulación)
+    CHECK(lecturas / n == 10, "%ld lecturas por medición", lecturas / n);
+    CHECK(desvio < 0.02, "desvío %.4f C", desvio);
+#else
+    CHECK(lecturas / n == 30, "%ld lecturas por medición", lecturas / n);
+#endif
+}
+
+int main(void)
+{
+    srand(1);
+    printf("autorrango %s\n", CONFIG_VENT_LM35_AUTORANGE ? "activo" : "apagado (12 dB fijo)");
+    temp_sensor_init();
+    probar_rampa();
+    probar_borde();
+    probar_quieto();
+
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
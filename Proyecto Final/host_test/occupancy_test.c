@@ -0,0 +1,197 @@
+// Occupancy.c contra trazas de PIR sintéticas (pulsos de 2.5-6 s como los
+// de un HC-SR501), con el lazo de control cada 100 ms y la simulación a
+// 1 ms. Cada escenario alimenta la misma traza a dos pines: uno recibe
+// todas las interrupciones y el otro pierde flancos como en light sleep,
+// y se compara cuánto difieren. Devuelve 1 si algo no cumple.
+#include <stdio.h>
+#include <stdlib.h>
+#include "Occupancy.h"
+#include "soc/gpio_reg.h"
+
+#define TICK_MS        100
+#define MAX_PULSOS     20000
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+// ---------------------------------------------------------------
+// GPIO simulado: nivel de cada pin y el handler que registró Occupancy.c
+// ---------------------------------------------------------------
+static uint32_t pines;
+static int64_t reloj_us;
+static void (*isr[40])(void *);
+static void *isr_arg[40];
+
+uint32_t host_reg_read(uint32_t reg) { return reg == GPIO_IN_REG ? pines : 0; }
+int64_t esp_timer_get_time(void) { return reloj_us; }
+esp_err_t gpio_install_isr_service(int flags) { (void)flags; return ESP_OK; }
+esp_err_t gpio_set_intr_type(gpio_num_t pin, int type) { (void)pin; (void)type; return ESP_OK; }
+esp_err_t gpio_intr_enable(gpio_num_t pin) { (void)pin; return ESP_OK; }
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, void (*h)(void *), void *arg)
+{
+    isr[pin] = h;
+    isr_arg[pin] = arg;
+    return ESP_OK;
+}
+
+static void poner_pin(int pin, bool nivel, bool interrumpir)
+{
+    if (nivel) pines |= 1u << pin;
+    else pines &= ~(1u << pin);
+    if (interrumpir) isr[pin](isr_arg[pin]);
+}
+
+// ---------------------------------------------------------------
+// Trazas: pulsos [a, b) en ms desde el inicio del escenario
+// ---------------------------------------------------------------
+typedef struct { int64_t a, b; } pulso_t;
+static pulso_t pulsos[MAX_PULSOS];
+static int n_pulsos;
+
+static unsigned semilla = 12345;
+static double azar(void)
+{
+    semilla = semilla * 1103515245u + 12345u;
+    return (semilla >> 8) / 16777216.0;
+}
+
+// Movimiento entre 'desde' y 'hasta' (s) con pausas de gap_min..gap_max s
+static void actividad(int desde, int hasta, double gap_min, double gap_max)
+{
+    int64_t t = desde * 1000LL;
+    while (t < hasta * 1000LL && n_pulsos < MAX_PULSOS) {
+        int64_t largo = 2500 + (int64_t)(azar() * 3500);
+        pulsos[n_pulsos++] = (pulso_t){ t, t + largo };
+        t += largo + (int64_t)((gap_min + azar() * (gap_max - gap_min)) * 1000);
+    }
+}
+
+// ---------------------------------------------------------------
+// Escenario: 'ref' recibe todo; 'prueba' pierde cada flanco con
+// probabilidad 'p_perdida' (o, con 'tarde', lo recibe un tick después)
+// ---------------------------------------------------------------
+typedef struct {
+    int pir_cambios, ref_cambios;
+    double pir_on, ref_on;          // Fracción del tiempo
+    int64_t difiere_ms;             // Tiempo con ref y prueba distintos
+    int perdidos;
+} resultado_t;
+
+static resultado_t correr(int pin_ref, int pin_prueba, int duracion_s, double p_perdida, bool tarde)
+{
+    int ref = occupancy_add_pin(pin_ref);
+    int prueba = occupancy_add_pin(pin_prueba);
+    int64_t base_us = reloj_us;
+
+    resultado_t r = { 0 };
+    bool nivel = false, pir_ant = false, ref_ant = false;
+    int64_t pir_on_ms = 0, ref_on_ms = 0;
+    int64_t atrasado_hasta = -1;    // Flanco de 'prueba' pendiente (modo 'tarde')
+    int pi = 0;
+
+    for (int64_t ms = 0; ms < duracion_s * 1000LL; ms++) {
+        reloj_us = base_us + ms * 1000 + 1;
+        while (pi < n_pulsos && pulsos[pi].b <= ms) pi++;
+        bool l = (pi < n_pulsos && pulsos[pi].a <= ms);
+
+        if (l != nivel) {
+            nivel = l;
+            poner_pin(pin_ref, l, true);
+            if (tarde) {
+                poner_pin(pin_prueba, l, false);
+                atrasado_hasta = ms + TICK_MS;
+            } else {
+                bool perdido = azar() < p_perdida;
+                r.perdidos += perdido;
+                poner_pin(pin_prueba, l, !perdido);
+            }
+        }
+        if (atrasado_hasta >= 0 && ms >= atrasado_hasta) {
+            isr[pin_prueba](isr_arg[pin_prueba]);
+            atrasado_hasta = -1;
+        }
+
+        if (ms % TICK_MS == 0) {
+            occupancy_update(reloj_us);
+            bool o_ref = occupancy_is_occupied(ref);
+            bool o_prueba = occupancy_is_occupied(prueba);
+            r.pir_cambios += (nivel != pir_ant);
+            r.ref_cambios += (o_ref != ref_ant);
+            pir_ant = nivel;
+            ref_ant = o_ref;
+            pir_on_ms += nivel * TICK_MS;
+            ref_on_ms += o_ref * TICK_MS;
+            if (o_ref != o_prueba) r.difiere_ms += TICK_MS;
+        }
+    }
+    r.pir_on = (double)pir_on_ms / (duracion_s * 1000.0);
+    r.ref_on = (double)ref_on_ms / (duracion_s * 1000.0);
+
+    // Al final hubo más de OCC_HOLD_MAX_S sin movimiento: nadie puede
+    // quedar ocupado (con un flanco de bajada perdido sin corrección, sí)
+    CHECK(!occupancy_is_occupied(ref) && !occupancy_is_occupied(prueba), "quedó ocupado al final");
+    return r;
+}
+
+static void escenario(const char *nombre, int pin, int duracion_s, double p_perdida, bool tarde)
+{
+    resultado_t r = correr(pin, pin + 1, duracion_s, p_perdida, tarde);
+
+    occupancy_stats_t ref, prueba;
+    occupancy_get_stats(occupancy_add_pin(pin), &ref);
+    occupancy_get_stats(occupancy_add_pin(pin + 1), &prueba);
+
+    printf("%-32s cambios PIR %4d -> motor %3d | encendido PIR %5.1f %% -> %5.1f %% | "
+           "sesiones %3u vacíos falsos %2u espera %3u s\n",
+           nombre, r.pir_cambios, r.ref_cambios, 100 * r.pir_on, 100 * r.ref_on,
+           (unsigned)ref.sessions, (unsigned)ref.false_vacancies, (unsigned)ref.hold_s);
+
+    if (tarde) {
+        // Interrupción atendida un tick tarde: no es un flanco perdido
+        CHECK(prueba.missed_edges == 0, "%s: %u correcciones con la ISR solo atrasada", nombre, (unsigned)prueba.missed_edges);
+        CHECK(prueba.edges == ref.edges, "%s: flancos %u vs %u", nombre, (unsigned)prueba.edges, (unsigned)ref.edges);
+        printf("%-32s ISR un tick tarde: correcciones %u, diferencia %lld ms\n", "",
+               (unsigned)prueba.missed_edges, (long long)r.difiere_ms);
+    } else if (p_perdida > 0) {
+        // Cada flanco perdido se corrige en dos ticks como mucho
+        double limite_ms = r.perdidos * 2.0 * TICK_MS;
+        printf("%-32s %d flancos perdidos, %u corregidos, diferencia %lld ms (límite %.0f ms)\n", "",
+               r.perdidos, (unsigned)prueba.missed_edges, (long long)r.difiere_ms, limite_ms);
+        CHECK(r.difiere_ms <= limite_ms, "%s: difiere %lld ms", nombre, (long long)r.difiere_ms);
+        CHECK(prueba.missed_edges > 0, "%s: ningún flanco corregido", nombre);
+    }
+    CHECK(ref.missed_edges == 0, "%s: la referencia corrigió %u flancos", nombre, (unsigned)ref.missed_edges);
+    CHECK(r.ref_cambios <= r.pir_cambios, "%s: el motor cambia más que el PIR", nombre);
+}
+
+int main(void)
+{
+    // Cada escenario usa dos de los OCC_MAX_SENSORS pines: 'ref' es la
+    // referencia (recibe todas las interrupciones) y sus números son los
+    // que se imprimen
+    const int fin = 4 * 3600;
+    const int quieto = OCC_HOLD_MAX_S + 60;     // Silencio final
+
+    // Dos horas sentado, una vacía, media hora más
+    n_pulsos = 0;
+    actividad(60, 2 * 3600, 5, 90);
+    actividad(3 * 3600, 3 * 3600 + 1800, 5, 60);
+    escenario("oficina, 20 % flancos perdidos", 4, fin, 0.20, false);
+    escenario("oficina, ISR atrasada", 6, fin, 0, true);
+
+    // Una pasada cada ~10 min
+    n_pulsos = 0;
+    for (int t = 300; t < fin - quieto; t += 600 + (int)(azar() * 300)) {
+        pulsos[n_pulsos++] = (pulso_t){ t * 1000LL, t * 1000LL + 2500 };
+    }
+    escenario("pasillo, 50 % flancos perdidos", 8, fin, 0.50, false);
+
+    // Leyendo: quieto, se mueve cada 1-3 min
+    n_pulsos = 0;
+    actividad(60, 3 * 3600, 60, 200);
+    escenario("lectura, 20 % flancos perdidos", 10, fin, 0.20, false);
+
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+// Dibujo de líneas en el cuadro del OLED (Display.c + Fonts.c generado):
+// compara display_print_page() con un render columna a columna como el
+// anterior, comprueba el recorte y mide el costo por línea y por tick de
+// la pantalla principal. Sin tarea del display ni I2C: solo el cuadro en
+// preparación. Devuelve 1 si alguna comprobación falla.
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Display.h"
+#include "Widgets.h"
+#include "driver/i2c_master.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#define REPETICIONES 1000000
+#define OLED_WIDTH   128
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+static double ahora_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// ---------------------------------------------------------------
+// Lo que Display.c y Widgets.c usan de ESP-IDF
+// ---------------------------------------------------------------
+int64_t esp_timer_get_time(void) { return (int64_t)(ahora_ns() / 1000); }
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *cfg, i2c_master_bus_handle_t *bus)
+{
+    (void)cfg;
+    *bus = (void *)1;
+    return ESP_OK;
+}
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus, const i2c_device_config_t *cfg,
+                                    i2c_master_dev_handle_t *dev) { (void)bus; (void)cfg; *dev = NULL; return ESP_OK; }
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev, const uint8_t *buf, size_t len, int timeout_ms) { (void)dev; (void)buf; (void)len; (void)timeout_ms; return ESP_OK; }
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t bus, uint16_t addr, int timeout_ms) { (void)bus; (void)addr; (void)timeout_ms; return ESP_OK; }
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus) { (void)bus; return ESP_OK; }
+
+// La tarea del display no corre: solo interesa armar el cuadro
+int xTaskCreatePinnedToCore(void (*fn)(void *), const char *name, uint32_t stack, void *arg,
+                            int prio, TaskHandle_t *handle, int core)
+{
+    (void)fn; (void)name; (void)stack; (void)arg; (void)prio; (void)core;
+    *handle = (void *)1;
+    return pdPASS;
+}
+uint32_t ulTaskNotifyTake(int clear, TickType_t wait) { (void)clear; (void)wait; return 0; }
+void xTaskNotifyGive(TaskHandle_t task) { (void)task; }
+TickType_t xTaskGetTickCount(void) { return 0; }
+void vTaskDelay(TickType_t ticks) { (void)ticks; }
+
+// ---------------------------------------------------------------
+// Referencia: una columna por vez con chequeo de borde, como el render
+// anterior a las tablas por página
+// ---------------------------------------------------------------
+static uint8_t ref_row[OLED_WIDTH];
+
+static __attribute__((noinline)) void ref_line(const char *str, bool inverted)
+{
+    memset(ref_row, 0, sizeof(ref_row));
+    int x = 0;
+    for (; *str && x < OLED_WIDTH; str++) {
+        const uint8_t *g = font_glyph(&font_5x7, *str);
+        for (int i = 0; i < font_5x7.width; i++) {
+            if (x < OLED_WIDTH) ref_row[x++] = g ? g[i] : 0;
+        }
+    }
+    if (inverted) {
+        for (int i = 0; i < OLED_WIDTH; i++) ref_row[i] ^= 0xFF;
+    }
+}
+
+// ---------------------------------------------------------------
+// Comprobaciones
+// ---------------------------------------------------------------
+static void probar_fuentes(void)
+{
+    // Las medidas que documentan Fonts.h, Display.c y el README
+    CHECK(font_5x7.width == 6 && font_5x7.pages == 1, "font_5x7 es %dx%d", font_5x7.width, font_5x7.pages * 8);
+    CHECK(font_10x16.width == 11 && font_10x16.pages == 2, "font_10x16 es %dx%d", font_10x16.width, font_10x16.pages * 8);
+    CHECK(font_digits.width == 17 && font_digits.pages == 3, "font_digits es %dx%d", font_digits.width, font_digits.pages * 8);
+
+    // Dígitos: solo el subconjunto de la temperatura
+    CHECK(font_glyph(&font_digits, '7') != NULL, "falta el 7 en font_digits");
+    CHECK(font_glyph(&font_digits, FONT_DEGREE[0]) != NULL, "falta el símbolo de grados");
+    CHECK(font_glyph(&font_digits, 'x') == NULL, "font_digits tiene 'x'");
+}
+
+static void probar_lineas(void)
+{
+    // Todo el ASCII imprimible en tramos de 21 caracteres, normal e invertido
+    char texto[96];
+    for (int c = 0x20; c < 0x7F; c++) texto[c - 0x20] = (char)c;
+    texto[0x7F - 0x20] = '\0';
+
+    for (int desde = 0; desde < 0x7F - 0x20; desde += 7) {
+        char linea[32];
+        snprintf(linea, sizeof(linea), "%.21s", texto + desde);
+        for (int inv = 0; inv <= 1; inv++) {
+            display_print_page(4, linea, inv);
+            ref_line(linea, inv);
+            CHECK(memcmp(display_page_buffer(4), ref_row, OLED_WIDTH) == 0,
+                  "línea \"%s\" (invertida %d) distinta de la referencia", linea, inv);
+        }
+    }
+
+    // Una línea corta borra lo que había a la derecha
+    display_print_page(4, "WWWWWWWWWWWWWWWWWWWWW", false);
+    display_print_page(4, "A", false);
+    ref_line("A", false);
+    CHECK(memcmp(display_page_buffer(4), ref_row, OLED_WIDTH) == 0, "la línea corta no borra el resto");
+}
+
+static void probar_recorte(void)
+{
+    // Dígitos de 3 páginas desde la columna 120: no puede pasar a la
+    // página siguiente ni a la columna 0 de la fila de abajo
+    for (int p = 0; p < 8; p++) memset(display_page_buffer(p), 0xA5, OLED_WIDTH);
+    int x = display_draw_text(120, 3, &font_digits, "88", false);
+    CHECK(x == 120 + font_digits.width, "columna siguiente %d", x);
+    for (int p = 3; p < 6; p++) {
+        CHECK(display_page_buffer(p)[119] == 0xA5, "pisó la columna 119 de la página %d", p);
+    }
+    CHECK(display_page_buffer(6)[0] == 0xA5, "se desbordó a la página 6");
+    CHECK(display_page_buffer(2)[OLED_WIDTH - 1] == 0xA5, "tocó la página 2");
+
+    // Una fuente que no entra en las páginas que quedan no dibuja nada
+    x = display_draw_text(0, 6, &font_digits, "8", false);
+    CHECK(x == 0 && display_page_buffer(7)[0] == 0xA5, "dibujó digits desde la página 6");
+}
+
+// ---------------------------------------------------------------
+// Tiempos
+// ---------------------------------------------------------------
+static void medir(void)
+{
+    const char *linea = "MODO: AUTO  T:25.5C >";   // 21 caracteres
+    volatile uint8_t sumidero = 0;
+    double t0, t1;
+
+    t0 = ahora_ns();
+    for (int i = 0; i < REPETICIONES; i++) {
+        ref_line(linea, i & 1);
+        sumidero += ref_row[3];
+    }
+    t1 = ahora_ns();
+    double ref = (t1 - t0) / REPETICIONES;
+
+    t0 = ahora_ns();
+    for (int i = 0; i < REPETICIONES; i++) {
+        display_print_page(i & 7, linea, i & 1);
+        sumidero += display_page_buffer(i & 7)[3];
+    }
+    t1 = ahora_ns();
+    double nueva = (t1 - t0) / REPETICIONES;
+
+    t0 = ahora_ns();
+    for (int i = 0; i < REPETICIONES; i++) {
+        display_draw_text(0, i & 6, &font_10x16, "AUTO 25.5C", false);
+    }
+    t1 = ahora_ns();
+    double grande = (t1 - t0) / REPETICIONES;
+
+    t0 = ahora_ns();
+    for (int i = 0; i < REPETICIONES; i++) {
+        display_draw_text(0, 3, &font_digits, "25.5" FONT_DEGREE "C", false);
+    }
+    t1 = ahora_ns();
+    double digitos = (t1 - t0) / REPETICIONES;
+
+    printf("línea 5x7 (21 car.): columna a columna %6.1f ns | memcpy por página %6.1f ns\n", ref, nueva);
+    printf("línea 10x16 (10 car., 2 páginas):                   %6.1f ns\n", grande);
+    printf("temperatura 17x24 (6 car., 3 páginas):              %6.1f ns\n", digitos);
+
+    // Pantalla principal completa, como en cada tick de control: sin
+    // cambios y con la temperatura cambiando en cada llamada
+    display_print_page(0, "", false);   // Fuerza el primer redibujado completo
+    for (int i = 0; i < 8; i++) widget_spark_feed(24.0f + i * 0.3f);
+
+    t0 = ahora_ns();
+    for (int i = 0; i < REPETICIONES; i++) {
+        display_update_ui("AUTO", "12", 40, 25.5f, false, false);
+        display_submit();
+    }
+    t1 = ahora_ns();
+    double quieta = (t1 - t0) / REPETICIONES;
+
+    t0 = ahora_ns();
+    for (int i = 0; i < REPETICIONES; i++) {
+        display_update_ui("AUTO", "12", 40, 20.0f + (i % 100) * 0.1f, false, false);
+        display_submit();
+    }
+    t1 = ahora_ns();
+    double cambia = (t1 - t0) / REPETICIONES;
+
+    display_stats_t st;
+    display_get_stats(&st);
+    printf("tick de la pantalla principal + display_submit(): %6.1f ns (temperatura cambiando: %6.1f ns)\n",
+           quieta, cambia);
+    CHECK(st.submitted == 2 * REPETICIONES, "entregados %u", (unsigned)st.submitted);
+    (void)sumidero;
+}
+
+int main(void)
+{
+    display_init();     // Solo marca el servicio como listo; la tarea no corre
+
+    probar_fuentes();
+    probar_lineas();
+    probar_recorte();
+    medir();
+
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
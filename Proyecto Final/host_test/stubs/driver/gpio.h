@@ -0,0 +1,17 @@
+// Lo mínimo de driver/gpio.h para compilar los módulos de main/ en el host.
+// Las funciones las define cada prueba.
+#pragma once
+
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_21 21
+#define GPIO_NUM_22 22
+
+#define GPIO_INTR_ANYEDGE 3
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags);
+esp_err_t gpio_set_intr_type(gpio_num_t pin, int type);
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, void (*handler)(void *), void *arg);
+esp_err_t gpio_intr_enable(gpio_num_t pin);
@@ -0,0 +1,37 @@
+// Lo mínimo de driver/i2c_master.h para compilar Display.c en el host. Las
+// funciones las define cada prueba.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef void *i2c_master_bus_handle_t;
+typedef void *i2c_master_dev_handle_t;
+
+typedef struct {
+    int clk_source;
+    int i2c_port;
+    int scl_io_num;
+    int sda_io_num;
+    int glitch_ignore_cnt;
+    struct {
+        int enable_internal_pullup;
+    } flags;
+} i2c_master_bus_config_t;
+
+typedef struct {
+    int dev_addr_length;
+    uint16_t device_address;
+    uint32_t scl_speed_hz;
+} i2c_device_config_t;
+
+#define I2C_CLK_SRC_DEFAULT 0
+#define I2C_ADDR_BIT_LEN_7  0
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *cfg, i2c_master_bus_handle_t *bus);
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus, const i2c_device_config_t *cfg,
+                                    i2c_master_dev_handle_t *dev);
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev, const uint8_t *buf, size_t len, int timeout_ms);
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t bus, uint16_t addr, int timeout_ms);
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus);
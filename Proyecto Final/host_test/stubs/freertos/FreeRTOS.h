@@ -0,0 +1,25 @@
+// FreeRTOS para el host, con un solo hilo: las secciones críticas no hacen
+// nada y las tareas no se ejecutan (xTaskCreatePinnedToCore lo define cada
+// prueba).
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+typedef int portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portMAX_DELAY                UINT32_MAX
+#define pdTRUE                       1
+#define pdPASS                       1
+#define pdMS_TO_TICKS(ms)            ((TickType_t)(ms))
+
+#define portENTER_CRITICAL(mux)      ((void)(mux))
+#define portEXIT_CRITICAL(mux)       ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)  ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)   ((void)(mux))
+
+// En ESP-IDF llega por FreeRTOS.h (esp_rom_sys.h)
+void esp_rom_delay_us(uint32_t us);
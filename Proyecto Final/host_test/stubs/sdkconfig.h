@@ -0,0 +1,14 @@
+// Valores por defecto de main/Kconfig.projbuild
+#pragma once
+
+#define CONFIG_VENT_OCC_HOLD_S      120
+#define CONFIG_VENT_OCC_RETRIGGER_S 30
+
+// 0 en el Makefile para compilar el driver con el rango fijo
+#ifndef CONFIG_VENT_LM35_AUTORANGE
+#define CONFIG_VENT_LM35_AUTORANGE  1
+#endif
+
+// components/cali_adc/Kconfig
+#define CONFIG_CALI_ADC_PASO_LOG2   4
+#define CONFIG_CALI_ADC_MAX_TABLAS  4
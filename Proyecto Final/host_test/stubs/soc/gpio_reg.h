@@ -0,0 +1,4 @@
+#pragma once
+
+#define GPIO_IN_REG  0x3FF4403C
+#define GPIO_IN1_REG 0x3FF44040
@@ -0,0 +1,8 @@
+// Registros del SoC: la prueba decide qué devuelve cada lectura
+#pragma once
+
+#include <stdint.h>
+
+uint32_t host_reg_read(uint32_t reg);
+
+#define REG_READ(reg) host_reg_read(reg)
@@ -0,0 +1,155 @@
+#include "Auth.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "StaticMutex.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "mbedtls/sha256.h"
+
+static const char *TAG = "AUTH";
+
+#define AUTH_KEY_LEN   32
+#define AUTH_BLOCK_LEN 64   // Bloque de SHA-256
+#define AUTH_MAC_HEX   32   // 16 bytes de HMAC
+
+// Estados de SHA-256 tras procesar (clave ^ ipad) y (clave ^ opad):
+// cada HMAC solo agrega el mensaje y el hash interno
+static mbedtls_sha256_context inner;
+static mbedtls_sha256_context outer;
+static bool ready;
+
+static static_mutex_t lock;
+
+static void auth_lock(void)
+{
+    static_mutex_take(&lock);
+}
+
+static void auth_unlock(void)
+{
+    static_mutex_give(&lock);
+}
+
+static uint32_t now_s(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+// Llamar con el lock tomado
+static void new_key(void)
+{
+    uint8_t key[AUTH_KEY_LEN];
+    uint8_t pad[AUTH_BLOCK_LEN];
+    esp_fill_random(key, sizeof(key));
+
+    memset(pad, 0x36, sizeof(pad));
+    for (int i = 0; i < AUTH_KEY_LEN; i++) pad[i] ^= key[i];
+    mbedtls_sha256_free(&inner);
+    mbedtls_sha256_init(&inner);
+    mbedtls_sha256_starts(&inner, 0);
+    mbedtls_sha256_update(&inner, pad, sizeof(pad));
+
+    memset(pad, 0x5C, sizeof(pad));
+    for (int i = 0; i < AUTH_KEY_LEN; i++) pad[i] ^= key[i];
+    mbedtls_sha256_free(&outer);
+    mbedtls_sha256_init(&outer);
+    mbedtls_sha256_starts(&outer, 0);
+    mbedtls_sha256_update(&outer, pad, sizeof(pad));
+
+    memset(key, 0, sizeof(key));
+    memset(pad, 0, sizeof(pad));
+}
+
+// mac_hex = primeros 16 bytes de HMAC(clave, vencimiento || nonce) en hex
+static void sign(uint32_t expires, uint32_t nonce, char mac_hex[AUTH_MAC_HEX + 1])
+{
+    uint8_t msg[8];
+    uint8_t digest[32];
+    memcpy(msg, &expires, 4);
+    memcpy(msg + 4, &nonce, 4);
+
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_clone(&ctx, &inner);
+    mbedtls_sha256_update(&ctx, msg, sizeof(msg));
+    mbedtls_sha256_finish(&ctx, digest);
+
+    mbedtls_sha256_clone(&ctx, &outer);
+    mbedtls_sha256_update(&ctx, digest, sizeof(digest));
+    mbedtls_sha256_finish(&ctx, digest);
+    mbedtls_sha256_free(&ctx);
+
+    for (int i = 0; i < AUTH_MAC_HEX / 2; i++) {
+        snprintf(mac_hex + 2 * i, 3, "%02x", digest[i]);
+    }
+}
+
+static bool parse_hex32(const char *s, uint32_t *out)
+{
+    char tmp[9];
+    memcpy(tmp, s, 8);
+    tmp[8] = '\0';
+    char *end;
+    *out = strtoul(tmp, &end, 16);
+    return *end == '\0';
+}
+
+void auth_init(void)
+{
+    auth_lock();
+    if (!ready) {
+        mbedtls_sha256_init(&inner);
+        mbedtls_sha256_init(&outer);
+        new_key();
+        ready = true;
+    }
+    auth_unlock();
+}
+
+pin_result_t auth_login(const char *pin, char token[AUTH_TOKEN_LEN + 1])
+{
+    pin_result_t res = pin_check(pin);
+    if (res != PIN_OK) return res;
+
+    uint32_t expires = now_s() + AUTH_SESSION_TTL_S;
+    uint32_t nonce = esp_random();
+    char mac[AUTH_MAC_HEX + 1];
+
+    auth_lock();
+    sign(expires, nonce, mac);
+    auth_unlock();
+
+    snprintf(token, AUTH_TOKEN_LEN + 1, "%08lx%08lx%s", (unsigned long)expires, (unsigned long)nonce, mac);
+    ESP_LOGI(TAG, "Sesión iniciada (vence en %d s)", AUTH_SESSION_TTL_S);
+    return PIN_OK;
+}
+
+bool auth_verify(const char *token)
+{
+    if (!ready || token == NULL || strlen(token) != AUTH_TOKEN_LEN) return false;
+
+    uint32_t expires, nonce;
+    if (!parse_hex32(token, &expires) || !parse_hex32(token + 8, &nonce)) return false;
+    if ((int32_t)(expires - now_s()) <= 0) return false;
+
+    char mac[AUTH_MAC_HEX + 1];
+    auth_lock();
+    sign(expires, nonce, mac);
+    auth_unlock();
+
+    // Tiempo constante: no revela cuántos caracteres coinciden
+    volatile uint8_t diff = 0;
+    for (int i = 0; i < AUTH_MAC_HEX; i++) diff |= mac[i] ^ token[16 + i];
+    return diff == 0;
+}
+
+void auth_revoke_all(void)
+{
+    auth_lock();
+    new_key();
+    auth_unlock();
+    ESP_LOGI(TAG, "Sesiones cerradas");
+}
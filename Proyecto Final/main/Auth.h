@@ -0,0 +1,39 @@
+#ifndef AUTH_H
+#define AUTH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Pin.h"
+
+// Sesiones para la API: login con el PIN del teclado y un token
+// HMAC-SHA256 sin estado en el servidor. Token (48 caracteres hex):
+//   vencimiento (8) | nonce (8) | HMAC(clave, vencimiento || nonce) truncado (32)
+// La clave es aleatoria por arranque: reiniciar cierra todas las sesiones.
+
+#define AUTH_SESSION_TTL_S (60 * 60)
+#define AUTH_TOKEN_LEN     48
+
+/**
+ * @brief Genera la clave y precalcula los bloques ipad/opad del HMAC.
+ * Solo actúa la primera vez (reiniciar el servidor no cierra sesiones).
+ */
+void auth_init(void);
+
+/**
+ * @brief Verifica el PIN (con la misma espera por errores que el teclado)
+ * y, si es correcto, emite un token.
+ */
+pin_result_t auth_login(const char *pin, char token[AUTH_TOKEN_LEN + 1]);
+
+/**
+ * @brief Firma y vencimiento. Cuesta dos bloques de SHA-256: no hay
+ * derivación de claves por petición.
+ */
+bool auth_verify(const char *token);
+
+/**
+ * @brief Cambia la clave: invalida todos los tokens emitidos.
+ */
+void auth_revoke_all(void);
+
+#endif // AUTH_H
@@ -0,0 +1,52 @@
+#include "BootProfile.h"
+#include <stdio.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "BOOT";
+
+typedef struct {
+    const char *name;
+    int64_t t_us;
+} boot_stage_t;
+
+static boot_stage_t stages[BOOT_PROFILE_MAX_STAGES];
+static int stage_count = 0;
+static portMUX_TYPE stages_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void boot_profile_mark(const char *stage)
+{
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&stages_mux);
+    if (stage_count < BOOT_PROFILE_MAX_STAGES) {
+        stages[stage_count++] = (boot_stage_t){ stage, now };
+    }
+    taskEXIT_CRITICAL(&stages_mux);
+}
+
+void boot_profile_report(void)
+{
+    int64_t prev = 0;
+    ESP_LOGI(TAG, "%-12s %8s %8s", "etapa", "ms", "total");
+    for (int i = 0; i < stage_count; i++) {
+        ESP_LOGI(TAG, "%-12s %8.1f %8.1f", stages[i].name,
+                 (stages[i].t_us - prev) / 1000.0, stages[i].t_us / 1000.0);
+        prev = stages[i].t_us;
+    }
+}
+
+size_t boot_profile_to_json(char *buf, size_t len)
+{
+    size_t n = 0;
+    int64_t prev = 0;
+    n += snprintf(buf + n, len - n, "{");
+    for (int i = 0; i < stage_count && n < len; i++) {
+        n += snprintf(buf + n, len - n, "%s\"%s\":%.1f", i ? "," : "", stages[i].name,
+                      (stages[i].t_us - prev) / 1000.0);
+        prev = stages[i].t_us;
+    }
+    if (n < len) n += snprintf(buf + n, len - n, "}");
+    return n < len ? n : len - 1;
+}
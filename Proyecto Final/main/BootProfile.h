@@ -0,0 +1,25 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stddef.h>
+
+#define BOOT_PROFILE_MAX_STAGES 16
+
+/**
+ * @brief Registra el fin de una etapa de arranque (marca de esp_timer).
+ * Se puede llamar desde cualquier tarea; el nombre debe ser un literal.
+ */
+void boot_profile_mark(const char *stage);
+
+/**
+ * @brief Imprime por log los ms de cada etapa y el acumulado.
+ */
+void boot_profile_report(void);
+
+/**
+ * @brief Escribe el reporte como JSON ({"etapa":ms,...}) en buf.
+ * @return Bytes escritos (sin contar el '\0').
+ */
+size_t boot_profile_to_json(char *buf, size_t len);
+
+#endif // BOOT_PROFILE_H
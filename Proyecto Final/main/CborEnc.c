@@ -0,0 +1,120 @@
+#include "CborEnc.h"
+#include <string.h>
+
+// Tipos mayores de CBOR (3 bits altos del byte inicial)
+#define CBOR_UINT   0x00
+#define CBOR_NINT   0x20
+#define CBOR_TEXT   0x60
+#define CBOR_ARRAY  0x80
+#define CBOR_MAP    0xA0
+
+#define CBOR_FALSE  0xF4
+#define CBOR_TRUE   0xF5
+#define CBOR_NULL   0xF6
+#define CBOR_HALF   0xF9
+#define CBOR_SINGLE 0xFA
+
+void cbor_enc_init(cbor_enc_t *enc, uint8_t *buf, size_t cap)
+{
+    enc->buf = buf;
+    enc->cap = cap;
+    enc->len = 0;
+    enc->overflow = false;
+}
+
+static uint8_t *reserve(cbor_enc_t *enc, size_t n)
+{
+    if (enc->overflow || enc->cap - enc->len < n) {
+        enc->overflow = true;
+        return NULL;
+    }
+    uint8_t *p = enc->buf + enc->len;
+    enc->len += n;
+    return p;
+}
+
+// Cabecera: tipo mayor + argumento en 0, 1, 2, 4 u 8 bytes (big endian)
+static void put_head(cbor_enc_t *enc, uint8_t major, uint64_t arg)
+{
+    uint8_t *p;
+    if (arg < 24) {
+        if ((p = reserve(enc, 1))) p[0] = major | (uint8_t)arg;
+    } else if (arg <= 0xFF) {
+        if ((p = reserve(enc, 2))) { p[0] = major | 24; p[1] = (uint8_t)arg; }
+    } else if (arg <= 0xFFFF) {
+        if ((p = reserve(enc, 3))) { p[0] = major | 25; p[1] = arg >> 8; p[2] = arg; }
+    } else if (arg <= 0xFFFFFFFF) {
+        if ((p = reserve(enc, 5))) {
+            p[0] = major | 26;
+            for (int i = 0; i < 4; i++) p[1 + i] = arg >> (24 - 8 * i);
+        }
+    } else {
+        if ((p = reserve(enc, 9))) {
+            p[0] = major | 27;
+            for (int i = 0; i < 8; i++) p[1 + i] = arg >> (56 - 8 * i);
+        }
+    }
+}
+
+void cbor_put_map(cbor_enc_t *enc, size_t count)   { put_head(enc, CBOR_MAP, count); }
+void cbor_put_array(cbor_enc_t *enc, size_t count) { put_head(enc, CBOR_ARRAY, count); }
+void cbor_put_uint(cbor_enc_t *enc, uint64_t value) { put_head(enc, CBOR_UINT, value); }
+
+void cbor_put_int(cbor_enc_t *enc, int64_t value)
+{
+    // Negativos: se codifica -1 - n
+    if (value < 0) put_head(enc, CBOR_NINT, (uint64_t)(-1 - value));
+    else put_head(enc, CBOR_UINT, (uint64_t)value);
+}
+
+void cbor_put_bool(cbor_enc_t *enc, bool value)
+{
+    uint8_t *p = reserve(enc, 1);
+    if (p) p[0] = value ? CBOR_TRUE : CBOR_FALSE;
+}
+
+void cbor_put_null(cbor_enc_t *enc)
+{
+    uint8_t *p = reserve(enc, 1);
+    if (p) p[0] = CBOR_NULL;
+}
+
+void cbor_put_text(cbor_enc_t *enc, const char *str)
+{
+    size_t n = strlen(str);
+    put_head(enc, CBOR_TEXT, n);
+    uint8_t *p = reserve(enc, n);
+    if (p) memcpy(p, str, n);
+}
+
+void cbor_put_float(cbor_enc_t *enc, float value)
+{
+    if (value > -2147483648.0f && value < 2147483648.0f && value == (float)(int32_t)value) {
+        cbor_put_int(enc, (int32_t)value);
+        return;
+    }
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits >> 31;
+    int32_t exp = (int32_t)((bits >> 23) & 0xFF) - 127;
+    uint32_t mant = bits & 0x7FFFFF;
+
+    uint8_t *p;
+    // Half normal exacto: exponente -14..15 y los 13 bits bajos de la mantisa en 0
+    if (exp >= -14 && exp <= 15 && (mant & 0x1FFF) == 0) {
+        uint16_t half = (uint16_t)((sign << 15) | ((uint32_t)(exp + 15) << 10) | (mant >> 13));
+        if ((p = reserve(enc, 3))) { p[0] = CBOR_HALF; p[1] = half >> 8; p[2] = half; }
+        return;
+    }
+
+    if ((p = reserve(enc, 5))) {
+        p[0] = CBOR_SINGLE;
+        for (int i = 0; i < 4; i++) p[1 + i] = bits >> (24 - 8 * i);
+    }
+}
+
+size_t cbor_enc_size(const cbor_enc_t *enc)
+{
+    return enc->overflow ? 0 : enc->len;
+}
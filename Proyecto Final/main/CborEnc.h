@@ -0,0 +1,42 @@
+#ifndef CBOR_ENC_H
+#define CBOR_ENC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Codificador CBOR (RFC 8949) mínimo: escribe directo sobre un buffer del
+// llamador, sin memoria dinámica. Si el buffer no alcanza se marca
+// 'overflow' y las escrituras siguientes se ignoran.
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+} cbor_enc_t;
+
+void cbor_enc_init(cbor_enc_t *enc, uint8_t *buf, size_t cap);
+
+// Contenedores de longitud conocida: después van 'count' elementos
+// (en un mapa, 'count' pares clave/valor)
+void cbor_put_map(cbor_enc_t *enc, size_t count);
+void cbor_put_array(cbor_enc_t *enc, size_t count);
+
+void cbor_put_uint(cbor_enc_t *enc, uint64_t value);
+void cbor_put_int(cbor_enc_t *enc, int64_t value);
+void cbor_put_bool(cbor_enc_t *enc, bool value);
+void cbor_put_null(cbor_enc_t *enc);
+void cbor_put_text(cbor_enc_t *enc, const char *str);
+
+/**
+ * @brief Escribe un float en la forma más corta que no pierde precisión:
+ * entero si no tiene decimales, si no half (16 bits) o single (32 bits).
+ */
+void cbor_put_float(cbor_enc_t *enc, float value);
+
+/**
+ * @brief Bytes escritos, o 0 si hubo overflow.
+ */
+size_t cbor_enc_size(const cbor_enc_t *enc);
+
+#endif // CBOR_ENC_H
@@ -1,123 +1,315 @@
 #include "Display.h"
 #include "driver/i2c_master.h"
 #include "esp_log.h"
+#include <math.h>
 #include <string.h>
 #include <stdio.h> 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
+#include "tasks_common.h"
+#include "Fonts.h"
+#include "Widgets.h"
 
 static const char *TAG = "OLED";
+static i2c_master_bus_handle_t bus_handle = NULL;
 static i2c_master_dev_handle_t dev_handle;
-static bool display_ok = false;
+static bool dev_added = false;   // Dispositivo agregado al bus (se pueden mandar comandos)
+static bool display_ok = false;  // Servicio iniciado (se aceptan cuadros)
+static volatile bool panel_up = false; // El panel responde (lo decide la tarea del display)
 
 #define I2C_TIMEOUT_MS 50 
+#define I2C_PROBE_TIMEOUT_MS 10
+// Reconexión: sondeo de la dirección cada 100 ms, 200 ms ... hasta 5 s.
+// Mientras tanto el panel caído no ocupa el bus.
+#define PANEL_RETRY_BASE_MS 100
+#define PANEL_RETRY_MAX_MS  5000
 #define SH1106_OFFSET 0x02 
 
-// Fuente 5x7 (Resumida para ahorrar espacio, mantén tu array completo si lo tienes localmente)
-// Asegúrate de que este array coincida con el que ya tenías funcionando.
-const uint8_t font5x7[][5] = {
-    {0x00, 0x00, 0x00, 0x00, 0x00}, // Space
-    {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
-    {0x07, 0x00, 0x07, 0x00, 0x00}, // "
-    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
-    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $
-    {0x23, 0x13, 0x08, 0x64, 0x62}, // %
-    {0x36, 0x49, 0x55, 0x22, 0x50}, // &
-    {0x00, 0x05, 0x03, 0x00, 0x00}, // '
-    {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
-    {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
-    {0x14, 0x08, 0x3E, 0x08, 0x14}, // *
-    {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
-    {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
-    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
-    {0x00, 0x60, 0x60, 0x00, 0x00}, // .
-    {0x20, 0x10, 0x08, 0x04, 0x02}, // /
-    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
-    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
-    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
-    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
-    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
-    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
-    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
-    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
-    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
-    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
-    {0x00, 0x36, 0x36, 0x00, 0x00}, // :
-    {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
-    {0x08, 0x14, 0x22, 0x41, 0x00}, // <
-    {0x14, 0x14, 0x14, 0x14, 0x14}, // =
-    {0x00, 0x41, 0x22, 0x14, 0x08}, // >
-    {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
-    {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
-    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
-    {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
-    {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
-    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
-    {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
-    {0x7F, 0x09, 0x09, 0x09, 0x01}, // F
-    {0x3E, 0x41, 0x49, 0x49, 0x7A}, // G
-    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
-    {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
-    {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
-    {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
-    {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
-    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // M
-    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
-    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
-    {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
-    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
-    {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
-    {0x46, 0x49, 0x49, 0x49, 0x31}, // S
-    {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
-    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
-    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
-    {0x3F, 0x40, 0x38, 0x40, 0x3F}, // W
-    {0x63, 0x14, 0x08, 0x14, 0x63}, // X
-    {0x07, 0x08, 0x70, 0x08, 0x07}, // Y
-    {0x61, 0x51, 0x49, 0x45, 0x43}, // Z    
+// Cuadro completo: las 8 páginas tal como las recibe el SH1106
+typedef struct {
+    uint8_t fb[OLED_PAGES][OLED_WIDTH];
+} frame_t;
+
+// Doble buffer: la tarea de control arma 'draft' sin tocar el I2C y lo
+// copia al buzón con display_submit(). Si la tarea del display no llegó a
+// tomar el anterior se pisa (gana el último) y se cuenta como descartado.
+static frame_t draft;
+static frame_t mailbox;
+static bool mailbox_full = false;
+static portMUX_TYPE mailbox_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t display_task_handle = NULL;
+
+// Solo la tarea del display: lo que muestra el panel. Una página que no
+// cambió no se reenvía (1 KB por pantalla completa a 400 kHz son ~25 ms;
+// una línea son ~3 ms)
+static frame_t shown;
+static uint8_t shown_valid = 0;       // Bit i: 'shown' vale para la página i
+static bool panel_on = true;          // Último 0xAF/0xAE aplicado (init_cmds termina en 0xAF)
+
+// Pedido de encendido/apagado para la tarea del display (bajo mailbox_mux).
+// 'power_seq' cuenta pedidos y 'power_done' el último ya resuelto.
+static bool power_want = true;
+static uint32_t power_seq = 0;
+static volatile uint32_t power_done = 0;
+
+static display_stats_t stats;
+
+// Pantalla principal ya armada en 'draft' (la pisa display_print_page)
+#define LOCK_ICON_X (OLED_WIDTH - 8)
+#define WARN_ICON_X (OLED_WIDTH - 8)
+#define FAN_BAR_X   54
+static bool main_ui_drawn = false;
+static char shown_temp[16];
+
+static const uint8_t init_cmds[] = {
+    0xAE, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40,
+    0xA1, 0xC8, 0xDA, 0x12, 0x81, 0xCF, 0xD9, 0xF1,
+    0xDB, 0x40, 0xA4, 0xA6, 0xAF
 };
 
-static void send_cmd(uint8_t cmd) {
-    if (!display_ok) return;
+// Solo desde la tarea del display
+static esp_err_t send_cmd(uint8_t cmd) {
     uint8_t data[] = {0x00, cmd};
-    i2c_master_transmit(dev_handle, data, sizeof(data), I2C_TIMEOUT_MS);
+    return i2c_master_transmit(dev_handle, data, sizeof(data), I2C_TIMEOUT_MS);
 }
 
-static void send_data(uint8_t *data, size_t len) {
-    if (!display_ok) return;
-    uint8_t *buf = malloc(len + 1);
-    if (!buf) return;
-    buf[0] = 0x40; 
-    memcpy(buf + 1, data, len);
-    i2c_master_transmit(dev_handle, buf, len + 1, I2C_TIMEOUT_MS);
-    free(buf);
+// Envía una página (solo desde la tarea del display). Dos transacciones:
+// posición (3 comandos juntos) y los 128 bytes de la línea.
+static esp_err_t flush_page(int page, const uint8_t *cols) {
+    uint8_t pos[] = {0x00, 0xB0 + page, 0x00 + SH1106_OFFSET, 0x10};
+    esp_err_t err = i2c_master_transmit(dev_handle, pos, sizeof(pos), I2C_TIMEOUT_MS);
+    if (err != ESP_OK) return err;
+
+    static uint8_t tx[1 + OLED_WIDTH];
+    tx[0] = 0x40;
+    memcpy(tx + 1, cols, OLED_WIDTH);
+    return i2c_master_transmit(dev_handle, tx, sizeof(tx), I2C_TIMEOUT_MS);
 }
 
-static void print_line(int page, const char *str) {
-    if (!display_ok) return;
-    
-    send_cmd(0xB0 + page); 
-    send_cmd(0x00 + SH1106_OFFSET); 
-    send_cmd(0x10); 
-    
-    uint8_t buffer[128] = {0};
-    int idx = 0;
-    while (*str && idx < 127) {
-        char c = *str++;
-        int f_idx = 0;
-        
-        if (c >= 32 && c <= 90) {
-            f_idx = c - 32;
-        } else if (c >= 'a' && c <= 'z') {
-            f_idx = (c - 32) - 32; 
+// Envía las páginas que difieren de lo que ya muestra el panel. Ante el
+// primer error corta (no gasta un timeout por página) y devuelve false.
+static bool flush_frame(const frame_t *f, uint32_t *sent, uint32_t *errors) {
+    for (int p = 0; p < OLED_PAGES; p++) {
+        uint8_t bit = 1 << p;
+        if ((shown_valid & bit) && memcmp(shown.fb[p], f->fb[p], OLED_WIDTH) == 0) continue;
+
+        if (flush_page(p, f->fb[p]) == ESP_OK) {
+            memcpy(shown.fb[p], f->fb[p], OLED_WIDTH);
+            shown_valid |= bit;
+            (*sent)++;
         } else {
-            f_idx = 0; 
+            shown_valid &= ~bit;
+            (*errors)++;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sondea el panel y, si contesta, lo reinicializa con init_cmds. Un sondeo
+// que vence por tiempo indica el bus trabado (un esclavo que quedó con SDA
+// en bajo al cortarse a mitad de un byte): i2c_master_bus_reset() lo libera
+// con pulsos de SCL y un STOP.
+static bool panel_connect(void) {
+    esp_err_t err = i2c_master_probe(bus_handle, OLED_I2C_ADDRESS, I2C_PROBE_TIMEOUT_MS);
+    if (err != ESP_OK) {
+        if (err != ESP_ERR_NOT_FOUND) {
+            i2c_master_bus_reset(bus_handle);
+            taskENTER_CRITICAL(&mailbox_mux);
+            stats.bus_resets++;
+            taskEXIT_CRITICAL(&mailbox_mux);
+        }
+        return false;
+    }
+
+    if (!dev_added) {
+        i2c_device_config_t dev_cfg = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address = OLED_I2C_ADDRESS,
+            .scl_speed_hz = 400000,
+        };
+        if (i2c_master_bus_add_device(bus_handle, &dev_cfg, &dev_handle) != ESP_OK) return false;
+        dev_added = true;
+    }
+
+    // Todos los comandos en una transacción (byte de control 0x00 = siguen comandos)
+    uint8_t tx[1 + sizeof(init_cmds)];
+    tx[0] = 0x00;
+    memcpy(tx + 1, init_cmds, sizeof(init_cmds));
+    if (i2c_master_transmit(dev_handle, tx, sizeof(tx), I2C_TIMEOUT_MS) != ESP_OK) return false;
+
+    // No se limpia aquí: el próximo cuadro reescribe las 8 páginas
+    shown_valid = 0;
+    panel_on = true;
+    return true;
+}
+
+static void display_task(void *pvParameters) {
+    int64_t window_start = esp_timer_get_time();
+    uint32_t window_frames = 0;
+    static frame_t f;               // 1 KB: fuera de la pila de la tarea
+    bool dirty = false;             // 'f' todavía no llegó al panel
+    bool ever_up = false;
+    uint32_t retry_ms = PANEL_RETRY_BASE_MS;
+    int64_t next_try = 0;           // Próximo sondeo con el panel caído
+
+    for (;;) {
+        TickType_t wait = pdMS_TO_TICKS(1000);
+        if (!panel_up) {
+            int64_t left_ms = (next_try - esp_timer_get_time()) / 1000;
+            if (left_ms < 0) left_ms = 0;
+            if (left_ms < 1000) wait = pdMS_TO_TICKS(left_ms);
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        taskENTER_CRITICAL(&mailbox_mux);
+        if (mailbox_full) {
+            f = mailbox;
+            mailbox_full = false;
+            dirty = true;
+        }
+        bool want_on = power_want;
+        uint32_t seq = power_seq;
+        taskEXIT_CRITICAL(&mailbox_mux);
+
+        // Supervisor: con el panel caído solo se sondea cuando vence la espera
+        if (!panel_up && esp_timer_get_time() >= next_try) {
+            if (panel_connect()) {
+                panel_up = true;
+                retry_ms = PANEL_RETRY_BASE_MS;
+                if (ever_up) {
+                    ESP_LOGI(TAG, "OLED reconectada");
+                    taskENTER_CRITICAL(&mailbox_mux);
+                    stats.reconnects++;
+                    taskEXIT_CRITICAL(&mailbox_mux);
+                } else {
+                    ESP_LOGI(TAG, "OLED SH1106 Inicializada Correctamente.");
+                }
+                ever_up = true;
+            } else {
+                next_try = esp_timer_get_time() + (int64_t)retry_ms * 1000;
+                retry_ms = (retry_ms * 2 > PANEL_RETRY_MAX_MS) ? PANEL_RETRY_MAX_MS : retry_ms * 2;
+            }
+        }
+
+        // Encendido/apagado pedido con display_set_power(). Con el panel
+        // caído queda pendiente y se aplica al reconectar.
+        if (panel_up && want_on != panel_on) {
+            if (send_cmd(want_on ? 0xAF : 0xAE) == ESP_OK) {
+                panel_on = want_on;
+                if (want_on) {
+                    shown_valid = 0; // Redibujar todo al volver
+                    dirty = true;
+                }
+            } else {
+                panel_up = false;
+                next_try = esp_timer_get_time() + PANEL_RETRY_BASE_MS * 1000;
+                retry_ms = PANEL_RETRY_BASE_MS * 2;
+            }
+        }
+        if (!panel_up || want_on == panel_on) power_done = seq;
+
+        uint32_t sent = 0, errors = 0;
+        bool drawn = false;
+        if (panel_up && dirty) {
+            if (flush_frame(&f, &sent, &errors)) {
+                dirty = false;
+                drawn = true;
+                window_frames++;
+            } else {
+                ESP_LOGW(TAG, "OLED sin respuesta, reintentando en %d ms", PANEL_RETRY_BASE_MS);
+                panel_up = false;
+                next_try = esp_timer_get_time() + PANEL_RETRY_BASE_MS * 1000;
+                retry_ms = PANEL_RETRY_BASE_MS * 2;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        taskENTER_CRITICAL(&mailbox_mux);
+        stats.online = panel_up;
+        stats.flushed += drawn;
+        stats.pages_sent += sent;
+        stats.i2c_errors += errors;
+        if (now - window_start >= 1000000) {
+            stats.fps = window_frames * 1e6f / (now - window_start);
+            window_frames = 0;
+            window_start = now;
+        }
+        taskEXIT_CRITICAL(&mailbox_mux);
+    }
+}
+
+// Solo arma el cuadro en memoria: el I2C lo maneja la tarea del display.
+// Cada carácter es un memcpy por página desde la tabla en flash; lo que no
+// entra a la derecha se recorta.
+int display_draw_text(int x, int page, const font_t *font, const char *str, bool inverted) {
+    if (page < 0 || page + font->pages > OLED_PAGES) return x;
+    for (; *str && x < OLED_WIDTH; str++) {
+        const uint8_t *glyph = font_glyph(font, *str);
+        int w = font->width;
+        if (x + w > OLED_WIDTH) w = OLED_WIDTH - x;
+        for (int p = 0; p < font->pages; p++) {
+            uint8_t *dst = &draft.fb[page + p][x];
+            if (glyph) memcpy(dst, glyph + p * font->width, w);
+            else memset(dst, 0, w);
+            if (inverted) {
+                for (int i = 0; i < w; i++) dst[i] ^= 0xFF;
+            }
         }
-        
-        for (int i=0; i<5; i++) if (idx < 128) buffer[idx++] = font5x7[f_idx][i];
-        if (idx < 128) buffer[idx++] = 0x00; 
+        x += font->width;
+    }
+    return x;
+}
+
+void display_clear_pages(int first, int count) {
+    if (first < 0 || count <= 0 || first + count > OLED_PAGES) return;
+    memset(draft.fb[first], 0, (size_t)count * OLED_WIDTH);
+}
+
+// Texto 5x7 desde la columna 0 y el resto de la página en blanco hasta x_end
+static void print_text(int page, int x_end, const char *str) {
+    if (page < 0 || page >= OLED_PAGES) return;
+    int end = display_draw_text(0, page, &font_5x7, str, false);
+    if (end < x_end) memset(draft.fb[page] + end, 0, x_end - end);
+}
+
+static void print_line(int page, const char *str, bool inverted) {
+    if (page < 0 || page >= OLED_PAGES) return;
+    uint8_t *row = draft.fb[page];
+    print_text(page, OLED_WIDTH, str);
+    if (inverted) {
+        for (int i = 0; i < OLED_WIDTH; i++) row[i] ^= 0xFF;
     }
-    send_data(buffer, 128);
+}
+
+void display_print_page(int page, const char *text, bool inverted) {
+    main_ui_drawn = false;
+    print_line(page, text, inverted);
+}
+
+uint8_t *display_page_buffer(int page) {
+    if (page < 0 || page >= OLED_PAGES) return NULL;
+    return draft.fb[page];
+}
+
+void display_submit(void) {
+    if (!display_ok) return;
+
+    taskENTER_CRITICAL(&mailbox_mux);
+    if (mailbox_full) stats.dropped++;
+    mailbox = draft;                  // 1 KB: ~1 us con el bus de la CPU
+    mailbox_full = true;
+    stats.submitted++;
+    taskEXIT_CRITICAL(&mailbox_mux);
+
+    xTaskNotifyGive(display_task_handle);
+}
+
+void display_get_stats(display_stats_t *out) {
+    taskENTER_CRITICAL(&mailbox_mux);
+    *out = stats;
+    taskEXIT_CRITICAL(&mailbox_mux);
 }
 
 void display_init(void) {
@@ -130,46 +322,72 @@ void display_init(void) {
         .flags.enable_internal_pullup = true,
     };
 
-    i2c_master_bus_handle_t bus_handle;
-    ESP_ERROR_CHECK(i2c_new_master_bus(&i2c_mst_config, &bus_handle));
+    esp_err_t err = i2c_new_master_bus(&i2c_mst_config, &bus_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo crear el bus I2C: %s", esp_err_to_name(err));
+        return;
+    }
 
-    i2c_device_config_t dev_cfg = {
-        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
-        .device_address = OLED_I2C_ADDRESS,
-        .scl_speed_hz = 400000,
-    };
+    // El panel se busca (y se reinicializa si se desconecta) desde la tarea
+    // del display: display_init no espera al I2C aunque no haya pantalla.
+    // Se marca lista al final para que la tarea de control no entregue
+    // cuadros antes de que exista la tarea que los dibuja.
+    xTaskCreatePinnedToCore(display_task, "display", DISPLAY_TASK_STACK_SIZE, NULL,
+                            DISPLAY_TASK_PRIORITY, &display_task_handle, DISPLAY_TASK_CORE_ID);
+    display_ok = true;
+}
 
-    esp_err_t err = i2c_master_bus_add_device(bus_handle, &dev_cfg, &dev_handle);
-    if (err == ESP_OK) {
-        display_ok = true;
-        uint8_t init_cmds[] = {
-            0xAE, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40,
-            0xA1, 0xC8, 0xDA, 0x12, 0x81, 0xCF, 0xD9, 0xF1,
-            0xDB, 0x40, 0xA4, 0xA6, 0xAF
-        };
-        for (int i = 0; i < sizeof(init_cmds); i++) send_cmd(init_cmds[i]);
-        
-        // Limpiar pantalla
-        for (int i = 0; i < 8; i++) print_line(i, "                ");
-        
-        ESP_LOGI(TAG, "OLED SH1106 Inicializada Correctamente.");
-    } else {
-        ESP_LOGE(TAG, "Error al encontrar la pantalla OLED.");
-        display_ok = false;
+// Solo deja el pedido: el 0xAF/0xAE lo manda la tarea del display
+void display_set_power(bool on) {
+    if (!display_ok) return;
+
+    taskENTER_CRITICAL(&mailbox_mux);
+    power_want = on;
+    power_seq++;
+    taskEXIT_CRITICAL(&mailbox_mux);
+
+    xTaskNotifyGive(display_task_handle);
+}
+
+bool display_power_wait(uint32_t timeout_ms) {
+    if (!display_ok) return true;
+
+    taskENTER_CRITICAL(&mailbox_mux);
+    uint32_t seq = power_seq;
+    taskEXIT_CRITICAL(&mailbox_mux);
+
+    TickType_t start = xTaskGetTickCount();
+    while ((int32_t)(power_done - seq) < 0) {
+        if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(timeout_ms)) return false;
+        vTaskDelay(1);
     }
+    return true;
 }
 
-// FUNCION ACTUALIZADA: AHORA CREA MÁSCARA DE ASTERISCOS
-void display_update_ui(const char *status, const char *password, int motor_percent, float temp) {
+// Pantalla principal. Las páginas 0-2 se reescriben en cada tick (el
+// display solo reenvía las que cambiaron); temperatura, barra, candado y
+// gráfico solo se tocan cuando cambia lo que muestran.
+//   0: estado + candado   1: PASS   2: FAN + barra
+//   3-5: temperatura 17x24          6-7: últimos 32 min
+void display_update_ui(const char *status, const char *password, int motor_percent, float temp, bool locked, bool sensor_fault) {
     if (!display_ok) return;
 
     char buffer[32];
 
-    // Línea 0: Estado
+    // Viene del menú (u otra pantalla): todo se dibuja de nuevo
+    if (!main_ui_drawn) {
+        display_clear_pages(0, OLED_PAGES);
+        widgets_invalidate();
+        shown_temp[0] = '\0';
+        main_ui_drawn = true;
+    }
+
+    // Línea 0: Estado y candado a la derecha
     snprintf(buffer, sizeof(buffer), "EST: %s", status);
-    print_line(0, buffer);
+    print_text(0, LOCK_ICON_X, buffer);
+    widget_lock_icon(LOCK_ICON_X, 0, locked);
 
-    // Línea 2: PASSWORD CON ASTERISCOS
+    // Línea 1: PASSWORD CON ASTERISCOS
     // Creamos un string con tantos asteriscos como caracteres tenga el password
     char masked_pass[10] = "";
     int pass_len = strlen(password);
@@ -181,16 +399,23 @@ void display_update_ui(const char *status, const char *password, int motor_perce
     masked_pass[pass_len] = '\0'; // Terminar string
 
     snprintf(buffer, sizeof(buffer), "PASS: %s", masked_pass);
-    print_line(2, buffer);
+    print_text(1, WARN_ICON_X, buffer);
+    widget_warning_icon(WARN_ICON_X, 1, sensor_fault); // Sensor de temperatura en falla
 
-    // Línea 4: Motor y Temperatura
-    snprintf(buffer, sizeof(buffer), "FAN:%d%% %.1fC", motor_percent, temp);
-    print_line(4, buffer);
-    
-    // Limpieza estética
-    print_line(1, "                ");
-    print_line(3, "                ");
-    print_line(5, "                ");
-    print_line(6, "                ");
-    print_line(7, "                ");
+    // Línea 2: Motor (texto + barra)
+    snprintf(buffer, sizeof(buffer), "FAN%4d%%", motor_percent);
+    print_text(2, FAN_BAR_X, buffer);
+    widget_bar(FAN_BAR_X, 2, OLED_WIDTH - FAN_BAR_X, motor_percent);
+
+    // Páginas 3-5: temperatura con dígitos grandes (solo si cambió el texto)
+    if (isnan(temp)) strlcpy(buffer, "--.-" FONT_DEGREE "C", sizeof(buffer)); // Sin lectura válida
+    else snprintf(buffer, sizeof(buffer), "%.1f" FONT_DEGREE "C", temp);
+    if (strcmp(buffer, shown_temp) != 0) {
+        display_clear_pages(3, 3);
+        display_draw_text(0, 3, &font_digits, buffer, false);
+        strlcpy(shown_temp, buffer, sizeof(shown_temp));
+    }
+
+    // Páginas 6-7: historia de la temperatura (widget_spark_feed en main.c)
+    widget_spark(6);
 }
\ No newline at end of file
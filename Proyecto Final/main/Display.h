@@ -2,16 +2,64 @@
 #define DISPLAY_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "driver/gpio.h"
+#include "Fonts.h"
 
 // Configuración de Pines I2C (OLED)
 #define I2C_MASTER_SCL_IO    GPIO_NUM_22
 #define I2C_MASTER_SDA_IO    GPIO_NUM_21
 #define OLED_I2C_ADDRESS     0x3C  // Dirección estándar
 
+// Geometría del panel: páginas de 8 filas y una columna por byte
+#define OLED_PAGES           8
+#define OLED_WIDTH           128
+
 // Funciones públicas
 void display_init(void);
-// Agregamos el parámetro 'float temp' al final
-void display_update_ui(const char *status, const char *password, int motor_percent, float temp);
+// Enciende/apaga el panel (0xAF/0xAE) sin perder la configuración. No
+// espera al I2C: el comando lo manda la tarea del display.
+void display_set_power(bool on);
+// Espera a que la tarea del display aplique el último display_set_power()
+// (o lo deje pendiente por panel caído). false si venció 'timeout_ms'.
+// Solo para el camino de deep sleep, que apaga el panel antes de dormir.
+bool display_power_wait(uint32_t timeout_ms);
+// Agregamos el parámetro 'float temp' al final; 'locked' elige el candado y
+// 'sensor_fault' muestra la advertencia (temp NAN se ve como "--.-")
+void display_update_ui(const char *status, const char *password, int motor_percent, float temp, bool locked, bool sensor_fault);
+
+// Escribe una línea (página de 8 px, 21 caracteres) en el cuadro en
+// preparación. 'inverted' = resaltada. No toca el I2C.
+void display_print_page(int page, const char *text, bool inverted);
+
+// Dibuja 'text' con 'font' desde la columna x y la página 'page' (la de
+// arriba si la fuente ocupa varias). Solo pisa las celdas de los
+// caracteres; lo que no entra se recorta. Devuelve la columna siguiente.
+int display_draw_text(int x, int page, const font_t *font, const char *text, bool inverted);
+
+// Borra 'count' páginas del cuadro en preparación desde 'first'.
+void display_clear_pages(int first, int count);
+
+// Los OLED_WIDTH bytes de una página del cuadro en preparación (para los widgets,
+// solo desde la tarea de control). NULL si la página no existe.
+uint8_t *display_page_buffer(int page);
+
+// Entrega el cuadro a la tarea del display y vuelve enseguida (nunca espera
+// al bus). Solo se envían por I2C las páginas que cambiaron.
+void display_submit(void);
+
+typedef struct {
+    float fps;              // Cuadros dibujados en el último segundo
+    uint32_t submitted;     // Entregados con display_submit()
+    uint32_t flushed;       // Dibujados
+    uint32_t dropped;       // Pisados en el buzón antes de dibujarse
+    uint32_t pages_sent;    // Páginas enviadas (las que no cambiaron no cuentan)
+    uint32_t i2c_errors;    // Transacciones fallidas
+    bool online;            // El panel responde
+    uint32_t reconnects;    // Veces que volvió tras caerse
+    uint32_t bus_resets;    // Recuperaciones del bus (SCL trabado)
+} display_stats_t;
+
+void display_get_stats(display_stats_t *out);
 
 #endif // DISPLAY_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef FONTS_H
+#define FONTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fuentes del OLED. Las tablas (Fonts.c) las genera tools/gen_fonts.py al
+// compilar y quedan en flash. Cada glifo ocupa 'pages' tiras de 'width'
+// bytes (una por página de 8 px, columna a columna, bit 0 arriba) con el
+// espacio entre letras incluido: se dibuja con un memcpy por página.
+
+#define FONT_FIRST_CHAR 0x20
+#define FONT_LAST_CHAR  0x7F
+#define FONT_DEGREE     "\x7F"   // Símbolo de grados, p. ej. "25.0" FONT_DEGREE "C"
+
+typedef struct {
+    uint8_t width;              // Columnas por carácter
+    uint8_t pages;              // Alto en páginas de 8 px
+    const uint8_t *glyphs;      // width * pages bytes por glifo
+    const uint8_t *index;       // NULL = están todos (32..127); si no, ranura
+                                // de cada carácter o 0xFF si falta
+} font_t;
+
+extern const font_t font_5x7;      // 21 caracteres por línea
+extern const font_t font_10x16;    // 11 caracteres, 2 páginas
+extern const font_t font_digits;   // 17x24 (15 px + 2 de espacio), 3 páginas: " %+-.0-9:C" y grados
+
+// Glifo de 'c' o NULL si la fuente no lo tiene
+static inline const uint8_t *font_glyph(const font_t *font, char c)
+{
+    uint8_t code = (uint8_t)c;
+    if (code < FONT_FIRST_CHAR || code > FONT_LAST_CHAR) return NULL;
+    uint8_t slot = code - FONT_FIRST_CHAR;
+    if (font->index != NULL) {
+        slot = font->index[slot];
+        if (slot == 0xFF) return NULL;
+    }
+    return font->glyphs + (uint32_t)slot * font->width * font->pages;
+}
+
+#endif // FONTS_H
@@ -0,0 +1,310 @@
+#include "JsonStream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    ST_VALUE,           // Se espera un valor
+    ST_VALUE_OR_END,    // Recién abierto '[': valor o ']'
+    ST_KEY_OR_END,      // Recién abierto '{': clave o '}'
+    ST_KEY,             // Tras ',' en un objeto
+    ST_COLON,
+    ST_AFTER,           // Tras un valor: ',' o cierre
+    ST_STRING,
+    ST_NUMBER,
+    ST_LITERAL,
+    ST_END,
+    ST_ERROR,
+};
+
+#define FIELD_NONE  -1
+#define FIELD_ARRAY -2
+
+static esp_err_t fail(json_stream_t *js, const char *what, const char *key)
+{
+    js->state = ST_ERROR;
+    js->err = ESP_ERR_INVALID_ARG;
+    if (key) snprintf(js->err_msg, sizeof(js->err_msg), "%s: %s", what, key);
+    else snprintf(js->err_msg, sizeof(js->err_msg), "%s", what);
+    return js->err;
+}
+
+void json_stream_init(json_stream_t *js, const json_schema_t *schema, void *out, const void *item_default)
+{
+    memset(js, 0, sizeof(*js));
+    js->schema = schema;
+    js->out = out;
+    js->item_default = item_default;
+    js->state = ST_VALUE;
+    js->field1 = FIELD_NONE;
+    js->field3 = FIELD_NONE;
+    js->item = -1;
+}
+
+static int find_field(const json_field_t *fields, int n, const char *key)
+{
+    for (int i = 0; i < n; i++) {
+        if (strcmp(fields[i].key, key) == 0) return i;
+    }
+    return FIELD_NONE;
+}
+
+// ¿Estamos dentro de un elemento del arreglo del esquema? ( { [ { )
+static bool in_array_item(const json_stream_t *js)
+{
+    return js->depth == 3 && js->field1 == FIELD_ARRAY && js->stack[1] == '[' && js->stack[2] == '{';
+}
+
+static uint8_t *item_ptr(const json_stream_t *js)
+{
+    const json_schema_t *s = js->schema;
+    return (uint8_t *)js->out + s->array_offset + (size_t)js->item * s->stride;
+}
+
+static void on_key(json_stream_t *js)
+{
+    const json_schema_t *s = js->schema;
+    if (js->tok_trunc) {
+        if (js->depth == 1) js->field1 = FIELD_NONE;
+        else if (in_array_item(js)) js->field3 = FIELD_NONE;
+        return;
+    }
+    if (js->depth == 1) {
+        if (s->array_key && strcmp(js->tok, s->array_key) == 0) js->field1 = FIELD_ARRAY;
+        else js->field1 = find_field(s->fields, s->n_fields, js->tok);
+    } else if (in_array_item(js)) {
+        js->field3 = find_field(s->item_fields, s->n_item_fields, js->tok);
+    }
+}
+
+static esp_err_t store(json_stream_t *js, const json_field_t *f, uint8_t *base, bool is_string)
+{
+    double v;
+    if (is_string) return fail(js, "tipo invalido", f->key);
+
+    if (strcmp(js->tok, "null") == 0) return ESP_OK; // Como si no estuviera
+    if (strcmp(js->tok, "true") == 0) v = 1;
+    else if (strcmp(js->tok, "false") == 0) v = 0;
+    else {
+        if (js->tok[0] != '-' && (js->tok[0] < '0' || js->tok[0] > '9')) return fail(js, "tipo invalido", f->key);
+        char *end;
+        v = strtod(js->tok, &end);
+        if (*end != '\0' || js->tok_trunc) return fail(js, "numero invalido", f->key);
+        if (f->type == JSON_FIELD_BOOL) v = (v != 0);
+    }
+
+    if (!(v >= f->min && v <= f->max)) return fail(js, "fuera de rango", f->key);
+    // Los enteros no se truncan: 1.9 en un campo entero es un error
+    if (f->type != JSON_FIELD_FLOAT && v != (double)(int32_t)v) return fail(js, "se esperaba un entero", f->key);
+    if (f->scale != 0) v *= f->scale;
+
+    uint8_t *p = base + f->offset;
+    switch (f->type) {
+        case JSON_FIELD_BOOL:  *(bool *)p = (v != 0); break;
+        case JSON_FIELD_INT:   *(int32_t *)p = (int32_t)v; break;
+        case JSON_FIELD_INT8:  *(int8_t *)p = (int8_t)v; break;
+        case JSON_FIELD_U8:    *p = (uint8_t)v; break;
+        case JSON_FIELD_U16:   *(uint16_t *)p = (uint16_t)v; break;
+        case JSON_FIELD_FLOAT: *(float *)p = (float)v; break;
+    }
+    return ESP_OK;
+}
+
+// Fin de un valor escalar (string, número o literal)
+static esp_err_t on_scalar(json_stream_t *js, bool is_string)
+{
+    const json_schema_t *s = js->schema;
+    if (js->depth == 1) {
+        if (js->field1 == FIELD_ARRAY) {
+            if (strcmp(js->tok, "null") == 0 && !is_string) return ESP_OK;
+            return fail(js, "se esperaba un arreglo", s->array_key);
+        }
+        if (js->field1 >= 0) {
+            esp_err_t err = store(js, &s->fields[js->field1], js->out, is_string);
+            if (err == ESP_OK) js->present |= 1u << js->field1;
+            return err;
+        }
+    } else if (js->depth == 2 && js->field1 == FIELD_ARRAY && js->stack[1] == '[') {
+        return fail(js, "se esperaba un objeto", s->array_key);
+    } else if (in_array_item(js) && js->field3 >= 0) {
+        return store(js, &s->item_fields[js->field3], item_ptr(js), is_string);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t check_order(json_stream_t *js, const json_order_t *order, int n, const uint8_t *base)
+{
+    for (int i = 0; i < n; i++) {
+        float lo = *(const float *)(base + order[i].lo);
+        float hi = *(const float *)(base + order[i].hi);
+        if (!(lo < hi)) return fail(js, "minimo >= maximo", order[i].name);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t open_container(json_stream_t *js, char c)
+{
+    const json_schema_t *s = js->schema;
+    if (js->depth == 0 && c != '{') return fail(js, "se esperaba un objeto", NULL);
+    if (js->depth >= JSON_STREAM_MAX_DEPTH) return fail(js, "anidamiento excesivo", NULL);
+
+    if (js->depth == 1) {
+        if (js->field1 >= 0) return fail(js, "tipo invalido", s->fields[js->field1].key);
+        if (js->field1 == FIELD_ARRAY) {
+            if (c != '[') return fail(js, "se esperaba un arreglo", s->array_key);
+            js->array_present = true;
+            *(uint16_t *)((uint8_t *)js->out + s->count_offset) = 0;
+        }
+    } else if (js->depth == 2 && js->field1 == FIELD_ARRAY && js->stack[1] == '[') {
+        if (c != '{') return fail(js, "se esperaba un objeto", s->array_key);
+        uint16_t *count = (uint16_t *)((uint8_t *)js->out + s->count_offset);
+        if (*count >= s->max_items) return fail(js, "demasiados elementos", s->array_key);
+        js->field3 = FIELD_NONE;
+        js->item = (*count)++;
+        if (js->item_default) memcpy(item_ptr(js), js->item_default, s->stride);
+    } else if (in_array_item(js) && js->field3 >= 0) {
+        return fail(js, "tipo invalido", s->item_fields[js->field3].key);
+    }
+
+    js->stack[js->depth++] = c;
+    js->state = (c == '{') ? ST_KEY_OR_END : ST_VALUE_OR_END;
+    return ESP_OK;
+}
+
+static esp_err_t close_container(json_stream_t *js, char c)
+{
+    char open = (c == '}') ? '{' : '[';
+    if (js->depth == 0 || js->stack[js->depth - 1] != open) return fail(js, "cierre inesperado", NULL);
+
+    if (in_array_item(js)) {
+        esp_err_t err = check_order(js, js->schema->item_order, js->schema->n_item_order, item_ptr(js));
+        if (err != ESP_OK) return err;
+    }
+
+    js->depth--;
+    js->state = (js->depth == 0) ? ST_END : ST_AFTER;
+    return ESP_OK;
+}
+
+static void tok_push(json_stream_t *js, char c)
+{
+    if (js->tok_len < JSON_STREAM_TOKEN_MAX - 1) js->tok[js->tok_len++] = c;
+    else js->tok_trunc = true;
+}
+
+static void tok_start(json_stream_t *js)
+{
+    js->tok_len = 0;
+    js->tok_trunc = false;
+}
+
+static void tok_end(json_stream_t *js)
+{
+    js->tok[js->tok_len] = '\0';
+}
+
+static bool is_ws(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+esp_err_t json_stream_feed(json_stream_t *js, const char *data, size_t len)
+{
+    size_t i = 0;
+    while (i < len) {
+        char c = data[i];
+        esp_err_t err = ESP_OK;
+
+        switch (js->state) {
+            case ST_ERROR:
+                return js->err;
+
+            case ST_VALUE_OR_END:
+                if (c == ']') { err = close_container(js, c); break; }
+                /* fallthrough */
+            case ST_VALUE:
+                if (is_ws(c)) break;
+                if (c == '{' || c == '[') err = open_container(js, c);
+                else if (js->depth == 0) err = fail(js, "se esperaba un objeto", NULL);
+                else if (c == '"') { tok_start(js); js->in_key = false; js->state = ST_STRING; }
+                else if (c == '-' || (c >= '0' && c <= '9')) { tok_start(js); tok_push(js, c); js->state = ST_NUMBER; }
+                else if (c >= 'a' && c <= 'z') { tok_start(js); tok_push(js, c); js->state = ST_LITERAL; }
+                else err = fail(js, "caracter inesperado", NULL);
+                break;
+
+            case ST_KEY_OR_END:
+                if (c == '}') { err = close_container(js, c); break; }
+                /* fallthrough */
+            case ST_KEY:
+                if (is_ws(c)) break;
+                if (c != '"') { err = fail(js, "se esperaba una clave", NULL); break; }
+                tok_start(js);
+                js->in_key = true;
+                js->state = ST_STRING;
+                break;
+
+            case ST_COLON:
+                if (is_ws(c)) break;
+                if (c == ':') js->state = ST_VALUE;
+                else err = fail(js, "se esperaba ':'", NULL);
+                break;
+
+            case ST_AFTER:
+                if (is_ws(c)) break;
+                if (c == ',') js->state = (js->stack[js->depth - 1] == '{') ? ST_KEY : ST_VALUE;
+                else if (c == '}' || c == ']') err = close_container(js, c);
+                else err = fail(js, "se esperaba ',' o cierre", NULL);
+                break;
+
+            case ST_STRING:
+                if (js->escape) {
+                    js->escape = false;
+                    tok_push(js, c);
+                } else if (c == '\\') {
+                    js->escape = true;
+                } else if (c == '"') {
+                    tok_end(js);
+                    if (js->in_key) { on_key(js); js->state = ST_COLON; }
+                    else { js->state = ST_AFTER; err = on_scalar(js, true); }
+                } else if ((unsigned char)c < 0x20) {
+                    err = fail(js, "caracter de control en string", NULL);
+                } else {
+                    tok_push(js, c);
+                }
+                break;
+
+            case ST_NUMBER:
+            case ST_LITERAL:
+                if ((js->state == ST_NUMBER && ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')) ||
+                    (js->state == ST_LITERAL && c >= 'a' && c <= 'z')) {
+                    tok_push(js, c);
+                    break;
+                }
+                // Fin del token: se procesa y el carácter se reevalúa como separador
+                tok_end(js);
+                if (js->state == ST_LITERAL && strcmp(js->tok, "true") && strcmp(js->tok, "false") && strcmp(js->tok, "null")) {
+                    err = fail(js, "literal invalido", NULL);
+                    break;
+                }
+                js->state = ST_AFTER;
+                err = on_scalar(js, false);
+                if (err == ESP_OK) continue;
+                break;
+
+            case ST_END:
+                if (!is_ws(c)) err = fail(js, "datos despues del objeto", NULL);
+                break;
+        }
+
+        if (err != ESP_OK) return err;
+        i++;
+    }
+    return ESP_OK;
+}
+
+esp_err_t json_stream_finish(json_stream_t *js)
+{
+    if (js->state == ST_ERROR) return js->err;
+    if (js->state != ST_END) return fail(js, "JSON incompleto", NULL);
+    return check_order(js, js->schema->order, js->schema->n_order, js->out);
+}
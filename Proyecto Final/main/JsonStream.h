@@ -0,0 +1,107 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Parser JSON incremental (estilo SAX) ligado a un esquema declarativo.
+// Se alimenta por trozos tal como llegan de httpd_req_recv(): no arma un
+// árbol ni necesita el cuerpo completo en memoria. Los campos conocidos se
+// validan y se escriben directo en una estructura del llamador; las claves
+// desconocidas se saltean.
+
+#define JSON_STREAM_MAX_DEPTH 8
+#define JSON_STREAM_TOKEN_MAX 32
+
+typedef enum {
+    JSON_FIELD_BOOL,    // bool (acepta también números: distinto de 0 = true)
+    JSON_FIELD_INT,     // int32_t
+    JSON_FIELD_INT8,    // int8_t
+    JSON_FIELD_U8,      // uint8_t
+    JSON_FIELD_U16,     // uint16_t
+    JSON_FIELD_FLOAT,   // float
+} json_field_type_t;
+
+// Campo escalar: el valor recibido se valida contra [min, max], se
+// multiplica por 'scale' (0 = 1) y se guarda en 'offset' de la estructura.
+// Los tipos enteros rechazan números con decimales en vez de truncarlos.
+typedef struct {
+    const char *key;
+    json_field_type_t type;
+    float min;
+    float max;
+    float scale;
+    uint16_t offset;
+} json_field_t;
+
+// Restricción entre dos campos float de la misma estructura: lo < hi
+typedef struct {
+    uint16_t lo;
+    uint16_t hi;
+    const char *name;
+} json_order_t;
+
+typedef struct {
+    const json_field_t *fields;         // Campos del objeto raíz
+    uint8_t n_fields;
+    const json_order_t *order;
+    uint8_t n_order;
+
+    // Arreglo de objetos opcional en el raíz (p. ej. "schedules")
+    const char *array_key;
+    const json_field_t *item_fields;
+    uint8_t n_item_fields;
+    const json_order_t *item_order;
+    uint8_t n_item_order;
+    uint16_t array_offset;              // Primer elemento en la estructura
+    uint16_t count_offset;              // uint16_t con la cantidad recibida
+    uint16_t stride;                    // sizeof del elemento
+    uint16_t max_items;                 // Más elementos es un error
+} json_schema_t;
+
+typedef struct {
+    const json_schema_t *schema;
+    void *out;
+    const void *item_default;           // Valores por defecto de cada elemento
+
+    uint32_t present;                   // Bit i: schema->fields[i] recibido
+    bool array_present;
+
+    uint8_t state;
+    uint8_t depth;
+    char stack[JSON_STREAM_MAX_DEPTH];  // '{' o '[' por nivel
+    bool in_key;
+    bool escape;
+    char tok[JSON_STREAM_TOKEN_MAX];
+    uint8_t tok_len;
+    bool tok_trunc;
+
+    int8_t field1;                      // Campo del raíz en curso
+    int8_t field3;                      // Campo del elemento en curso
+    int16_t item;                       // Elemento en curso
+
+    esp_err_t err;
+    char err_msg[48];
+} json_stream_t;
+
+/**
+ * @brief Prepara el parser. 'out' debe venir cargado con los valores
+ * actuales: solo se pisan los campos presentes en el JSON.
+ * @param item_default Plantilla para cada elemento del arreglo (puede ser NULL).
+ */
+void json_stream_init(json_stream_t *js, const json_schema_t *schema, void *out, const void *item_default);
+
+/**
+ * @brief Procesa un trozo del cuerpo. Puede cortarse en cualquier byte.
+ * @return ESP_OK, o ESP_ERR_INVALID_ARG (sintaxis/tipo/rango; ver err_msg).
+ */
+esp_err_t json_stream_feed(json_stream_t *js, const char *data, size_t len);
+
+/**
+ * @brief Verifica que el documento terminó y las restricciones entre campos.
+ */
+esp_err_t json_stream_finish(json_stream_t *js);
+
+#endif // JSON_STREAM_H
@@ -1,5 +1,6 @@
 #include "LedRGB.h"
 #include "driver/gpio.h"
+#include "esp_timer.h"
 
 // --- PINES ELEGIDOS DE TU LISTA ---
 #define LED_PIN_RED   GPIO_NUM_4   
@@ -29,4 +30,11 @@ void led_rgb_update(bool is_locked) {
         gpio_set_level(LED_PIN_RED, 0);
         gpio_set_level(LED_PIN_GREEN, 1);
     }
-}
\ No newline at end of file
+}
+
+void led_rgb_lockout(void) {
+    // 250 ms encendido y 250 ms apagado, sin timers propios
+    bool on = (esp_timer_get_time() / 250000) & 1;
+    gpio_set_level(LED_PIN_RED, on);
+    gpio_set_level(LED_PIN_GREEN, 0);
+}
@@ -11,4 +11,7 @@ void led_rgb_init(void);
 // is_locked = false -> VERDE
 void led_rgb_update(bool is_locked);
 
+// PIN en espera por intentos fallidos -> ROJO parpadeando (2 Hz)
+void led_rgb_lockout(void);
+
 #endif
\ No newline at end of file
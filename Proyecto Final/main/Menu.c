@@ -0,0 +1,517 @@
+#include "Menu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "Display.h"
+#include "Schedule.h"
+#include "Settings.h"
+
+static const char *TAG = "MENU";
+
+#define MENU_TIMEOUT_MS 30000   // Sin teclas: se vuelve a la pantalla normal
+#define MENU_MSG_MS     2000    // Duración de "GUARDADO", "VALOR INVALIDO", etc.
+#define MENU_ROWS       6       // Páginas 1..6 (0 = título, 7 = ayuda)
+#define MENU_COLS       21
+#define EDIT_MAX        5
+
+typedef enum {
+    SCREEN_CLOSED,
+    SCREEN_MAIN,
+    SCREEN_SCHED_LIST,
+    SCREEN_SCHED_ITEM,
+} menu_screen_t;
+
+enum { MAIN_MODE, MAIN_PWM, MAIN_TMIN, MAIN_TMAX, MAIN_SCHED, MAIN_EXIT, MAIN_ITEMS };
+enum { WIN_ACTIVE, WIN_START, WIN_END, WIN_T0, WIN_T100, WIN_DELETE, WIN_ITEMS };
+
+// Cómo se edita cada ítem
+typedef enum {
+    KIND_ACTION,    // '#' ejecuta (entrar, borrar, salir)
+    KIND_CHOICE,    // A/B recorren las opciones
+    KIND_INT,       // Dígitos
+    KIND_DECIMAL,   // Dígitos y un punto (D)
+    KIND_TIME,      // HHMM
+} item_kind_t;
+
+static const char *const mode_names[] = { "MANUAL", "AUTO", "PROG" };
+static const char *const yes_no[] = { "NO", "SI" };
+
+// Ventana nueva: todos los días y zonas, horario de oficina
+static const schedule_t new_window = {
+    .active = true, .days = SCHEDULE_ALL_DAYS, .priority = 0, .zones = SCHEDULE_ALL_ZONES,
+    .start_min = 8 * 60, .end_min = 18 * 60, .t_zero = 22.0, .t_hundred = 28.0,
+};
+
+static struct {
+    menu_screen_t screen;
+    int sel;                    // Ítem resaltado
+    int top;                    // Primer ítem visible
+
+    bool editing;
+    bool fresh;                 // La primera tecla reemplaza el valor mostrado
+    int choice;
+    char edit[12];              // Se teclean hasta EDIT_MAX caracteres
+
+    int win;                    // Ventana abierta en SCREEN_SCHED_ITEM
+    schedule_t sched[SCHEDULE_MAX_WINDOWS];
+    int sched_count;
+
+    char msg[MENU_COLS + 1];
+    int64_t msg_until;
+    int64_t last_key;
+} m;
+
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+static void show_msg(const char *msg)
+{
+    strlcpy(m.msg, msg, sizeof(m.msg));
+    m.msg_until = now_ms() + MENU_MSG_MS;
+}
+
+static int item_count(void)
+{
+    switch (m.screen) {
+        case SCREEN_MAIN:       return MAIN_ITEMS;
+        case SCREEN_SCHED_LIST: return m.sched_count + (m.sched_count < SCHEDULE_MAX_WINDOWS); // + "NUEVO"
+        case SCREEN_SCHED_ITEM: return WIN_ITEMS;
+        default:                return 0;
+    }
+}
+
+static item_kind_t item_kind(int item)
+{
+    if (m.screen == SCREEN_MAIN) {
+        switch (item) {
+            case MAIN_MODE: return KIND_CHOICE;
+            case MAIN_PWM:  return KIND_INT;
+            case MAIN_TMIN:
+            case MAIN_TMAX: return KIND_DECIMAL;
+            default:        return KIND_ACTION;
+        }
+    }
+    if (m.screen == SCREEN_SCHED_ITEM) {
+        switch (item) {
+            case WIN_ACTIVE: return KIND_CHOICE;
+            case WIN_START:
+            case WIN_END:    return KIND_TIME;
+            case WIN_T0:
+            case WIN_T100:   return KIND_DECIMAL;
+            default:         return KIND_ACTION;
+        }
+    }
+    return KIND_ACTION;
+}
+
+static void go_to(menu_screen_t screen, int sel)
+{
+    m.screen = screen;
+    m.sel = sel;
+    m.top = (sel >= MENU_ROWS) ? sel - MENU_ROWS + 1 : 0;
+    m.editing = false;
+}
+
+static void move(int delta)
+{
+    int n = item_count();
+    if (n == 0) return;
+    m.sel = (m.sel + delta + n) % n;
+    if (m.sel < m.top) m.top = m.sel;
+    if (m.sel >= m.top + MENU_ROWS) m.top = m.sel - MENU_ROWS + 1;
+}
+
+// ---------------------------------------------------------------------------
+// Guardado (mismo camino que POST /api/settings)
+// ---------------------------------------------------------------------------
+
+static bool commit_settings(const settings_t *s)
+{
+    esp_err_t err = settings_commit(s, NULL, 0);
+    if (err == ESP_ERR_INVALID_ARG) {
+        show_msg("VALOR INVALIDO");
+        return false;
+    }
+    show_msg(err == ESP_OK ? "GUARDADO" : "ERROR AL GUARDAR");
+    return err == ESP_OK;
+}
+
+// Guarda y publica la lista editada junto con la configuración vigente; si
+// NVS falla no cambia nada
+static bool commit_schedules(const schedule_t *list, int count)
+{
+    esp_err_t err = settings_commit(NULL, list, count);
+    if (err == ESP_ERR_INVALID_ARG) {
+        show_msg("VALOR INVALIDO");
+        return false;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudieron guardar los horarios: %s", esp_err_to_name(err));
+        show_msg("ERROR AL GUARDAR");
+        return false;
+    }
+    if (list != m.sched) memcpy(m.sched, list, count * sizeof(schedule_t));
+    m.sched_count = count;
+    show_msg("GUARDADO");
+    return true;
+}
+
+static void reload_schedules(void)
+{
+    m.sched_count = schedule_get(m.sched, SCHEDULE_MAX_WINDOWS);
+}
+
+// ---------------------------------------------------------------------------
+// Edición de un valor
+// ---------------------------------------------------------------------------
+
+static void format_time(char *out, size_t len, uint16_t min)
+{
+    snprintf(out, len, "%02u:%02u", min / 60, min % 60);
+}
+
+static void begin_edit(void)
+{
+    settings_t s;
+    settings_get(&s);
+    const schedule_t *w = &m.sched[m.win];
+
+    m.editing = true;
+    m.fresh = true;
+    m.edit[0] = '\0';
+
+    if (m.screen == SCREEN_MAIN) {
+        switch (m.sel) {
+            case MAIN_MODE: m.choice = s.system_mode; break;
+            case MAIN_PWM:  snprintf(m.edit, sizeof(m.edit), "%d", (int)s.manual_pwm); break;
+            case MAIN_TMIN: snprintf(m.edit, sizeof(m.edit), "%.1f", s.auto_tmin); break;
+            case MAIN_TMAX: snprintf(m.edit, sizeof(m.edit), "%.1f", s.auto_tmax); break;
+        }
+    } else {
+        switch (m.sel) {
+            case WIN_ACTIVE: m.choice = w->active; break;
+            case WIN_START:  snprintf(m.edit, sizeof(m.edit), "%02u%02u", w->start_min / 60, w->start_min % 60); break;
+            case WIN_END:    snprintf(m.edit, sizeof(m.edit), "%02u%02u", w->end_min / 60, w->end_min % 60); break;
+            case WIN_T0:     snprintf(m.edit, sizeof(m.edit), "%.1f", w->t_zero); break;
+            case WIN_T100:   snprintf(m.edit, sizeof(m.edit), "%.1f", w->t_hundred); break;
+        }
+    }
+}
+
+// "HHMM" (o "HH") a minutos del día; -1 si no es válido
+static int parse_time(const char *s, bool is_end)
+{
+    int len = strlen(s);
+    if (len == 0) return -1;
+    int v = atoi(s);
+    int hh = (len <= 2) ? v : v / 100;
+    int mm = (len <= 2) ? 0 : v % 100;
+    if (mm >= 60) return -1;
+    int min = hh * 60 + mm;
+    if (is_end) return (min >= 1 && min <= MINUTES_PER_DAY) ? min : -1;
+    return (min < MINUTES_PER_DAY) ? min : -1;
+}
+
+static void save_edit(void)
+{
+    item_kind_t kind = item_kind(m.sel);
+    if ((kind == KIND_INT || kind == KIND_DECIMAL || kind == KIND_TIME) && m.edit[0] == '\0') {
+        show_msg("VALOR INVALIDO");
+        return;
+    }
+
+    bool ok;
+    if (m.screen == SCREEN_MAIN) {
+        settings_t s;
+        settings_get(&s);
+        switch (m.sel) {
+            case MAIN_MODE: s.system_mode = m.choice; break;
+            case MAIN_PWM:  s.manual_pwm = atoi(m.edit); break;
+            case MAIN_TMIN: s.auto_tmin = strtof(m.edit, NULL); break;
+            case MAIN_TMAX: s.auto_tmax = strtof(m.edit, NULL); break;
+        }
+        ok = commit_settings(&s);
+    } else {
+        schedule_t list[SCHEDULE_MAX_WINDOWS];
+        memcpy(list, m.sched, m.sched_count * sizeof(schedule_t));
+        schedule_t *w = &list[m.win];
+        int min;
+        ok = true;
+        switch (m.sel) {
+            case WIN_ACTIVE:
+                w->active = m.choice;
+                break;
+            case WIN_START:
+            case WIN_END:
+                min = parse_time(m.edit, m.sel == WIN_END);
+                if (min < 0) ok = false;
+                else if (m.sel == WIN_START) w->start_min = min;
+                else w->end_min = min;
+                break;
+            case WIN_T0:
+                w->t_zero = strtof(m.edit, NULL);
+                break;
+            case WIN_T100:
+                w->t_hundred = strtof(m.edit, NULL);
+                break;
+        }
+        // Rangos y t0 < t100 los comprueba settings_commit(), igual que para la API
+        if (!ok) show_msg("VALOR INVALIDO");
+        else ok = commit_schedules(list, m.sched_count);
+    }
+
+    if (ok) m.editing = false;
+    else m.fresh = true; // Se puede volver a teclear sin borrar
+}
+
+static void edit_key(char key)
+{
+    item_kind_t kind = item_kind(m.sel);
+
+    if (key == '*') { m.editing = false; return; }
+    if (key == '#') { save_edit(); return; }
+
+    if (kind == KIND_CHOICE) {
+        int n = (m.screen == SCREEN_MAIN) ? 3 : 2;
+        if (key == 'A') m.choice = (m.choice + 1) % n;
+        else if (key == 'B') m.choice = (m.choice + n - 1) % n;
+        return;
+    }
+
+    size_t len = strlen(m.edit);
+    if (key == 'C') {
+        if (m.fresh) m.edit[0] = '\0';
+        else if (len > 0) m.edit[len - 1] = '\0';
+        m.fresh = false;
+        return;
+    }
+
+    bool digit = (key >= '0' && key <= '9');
+    bool dot = (key == 'D' && kind == KIND_DECIMAL);
+    if (!digit && !dot) return;
+    if (m.fresh) { m.edit[0] = '\0'; len = 0; m.fresh = false; }
+    if (dot && strchr(m.edit, '.')) return;
+
+    size_t max = (kind == KIND_TIME) ? 4 : (kind == KIND_INT) ? 3 : EDIT_MAX;
+    if (len < max) {
+        m.edit[len] = dot ? '.' : key;
+        m.edit[len + 1] = '\0';
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Navegación
+// ---------------------------------------------------------------------------
+
+static void enter(void)
+{
+    if (item_kind(m.sel) != KIND_ACTION) {
+        begin_edit();
+        return;
+    }
+
+    if (m.screen == SCREEN_MAIN) {
+        if (m.sel == MAIN_SCHED) {
+            reload_schedules();
+            go_to(SCREEN_SCHED_LIST, 0);
+        } else {
+            menu_close();
+        }
+    } else if (m.screen == SCREEN_SCHED_LIST) {
+        if (m.sel == m.sched_count) {
+            // "NUEVO": se agrega y se guarda de inmediato
+            schedule_t list[SCHEDULE_MAX_WINDOWS];
+            memcpy(list, m.sched, m.sched_count * sizeof(schedule_t));
+            list[m.sched_count] = new_window;
+            if (!commit_schedules(list, m.sched_count + 1)) return;
+        }
+        m.win = m.sel;
+        go_to(SCREEN_SCHED_ITEM, 0);
+    } else if (m.screen == SCREEN_SCHED_ITEM && m.sel == WIN_DELETE) {
+        schedule_t list[SCHEDULE_MAX_WINDOWS];
+        memcpy(list, m.sched, m.sched_count * sizeof(schedule_t));
+        memmove(&list[m.win], &list[m.win + 1], (m.sched_count - m.win - 1) * sizeof(schedule_t));
+        if (commit_schedules(list, m.sched_count - 1)) {
+            show_msg("BORRADO");
+            go_to(SCREEN_SCHED_LIST, m.win < m.sched_count ? m.win : m.sched_count);
+        }
+    }
+}
+
+static void back(void)
+{
+    switch (m.screen) {
+        case SCREEN_SCHED_ITEM: go_to(SCREEN_SCHED_LIST, m.win); break;
+        case SCREEN_SCHED_LIST: go_to(SCREEN_MAIN, MAIN_SCHED); break;
+        default:                menu_close(); break;
+    }
+}
+
+void menu_open(void)
+{
+    memset(&m, 0, sizeof(m));
+    go_to(SCREEN_MAIN, 0);
+    m.last_key = now_ms();
+}
+
+void menu_close(void)
+{
+    m.screen = SCREEN_CLOSED;
+    m.editing = false;
+}
+
+bool menu_is_open(void)
+{
+    return m.screen != SCREEN_CLOSED;
+}
+
+bool menu_handle_key(char key)
+{
+    if (m.screen == SCREEN_CLOSED) return false;
+    m.last_key = now_ms();
+    m.msg_until = 0;
+
+    if (m.editing) {
+        edit_key(key);
+    } else if (key == 'A') {
+        move(-1);
+    } else if (key == 'B') {
+        move(1);
+    } else if (key == '#') {
+        enter();
+    } else if (key == '*') {
+        back();
+    }
+    return m.screen != SCREEN_CLOSED;
+}
+
+// ---------------------------------------------------------------------------
+// Dibujo
+// ---------------------------------------------------------------------------
+
+// Valor en edición entre > <
+static void format_edit(char *out, size_t len)
+{
+    if (item_kind(m.sel) == KIND_CHOICE) {
+        const char *const *names = (m.screen == SCREEN_MAIN) ? mode_names : yes_no;
+        snprintf(out, len, ">%s<", names[m.choice]);
+    } else if (item_kind(m.sel) == KIND_TIME && strlen(m.edit) > 2) {
+        snprintf(out, len, ">%.*s:%s<", (int)strlen(m.edit) - 2, m.edit, m.edit + strlen(m.edit) - 2);
+    } else {
+        snprintf(out, len, ">%s<", m.edit);
+    }
+}
+
+static void format_item(int i, char *out, size_t len, const settings_t *s)
+{
+    char val[16] = "";
+    char a[6], b[6];
+
+    if (m.editing && i == m.sel) format_edit(val, sizeof(val));
+
+    if (m.screen == SCREEN_MAIN) {
+        switch (i) {
+            case MAIN_MODE:
+                snprintf(out, len, "MODO: %s", val[0] ? val : mode_names[s->system_mode]);
+                break;
+            case MAIN_PWM:
+                if (val[0]) snprintf(out, len, "PWM MAN: %s%%", val);
+                else snprintf(out, len, "PWM MAN: %d%%", (int)s->manual_pwm);
+                break;
+            case MAIN_TMIN:
+                if (val[0]) snprintf(out, len, "T MIN: %sC", val);
+                else snprintf(out, len, "T MIN: %.1fC", s->auto_tmin);
+                break;
+            case MAIN_TMAX:
+                if (val[0]) snprintf(out, len, "T MAX: %sC", val);
+                else snprintf(out, len, "T MAX: %.1fC", s->auto_tmax);
+                break;
+            case MAIN_SCHED:
+                snprintf(out, len, "HORARIOS");
+                break;
+            default:
+                snprintf(out, len, "SALIR");
+                break;
+        }
+    } else if (m.screen == SCREEN_SCHED_LIST) {
+        if (i == m.sched_count) {
+            snprintf(out, len, "+ NUEVO");
+        } else {
+            const schedule_t *w = &m.sched[i];
+            format_time(a, sizeof(a), w->start_min);
+            format_time(b, sizeof(b), w->end_min);
+            snprintf(out, len, "%d %s-%s %s", i + 1, a, b, w->active ? "SI" : "NO");
+        }
+    } else {
+        const schedule_t *w = &m.sched[m.win];
+        switch (i) {
+            case WIN_ACTIVE:
+                snprintf(out, len, "ACTIVO: %s", val[0] ? val : yes_no[w->active]);
+                break;
+            case WIN_START:
+            case WIN_END:
+                format_time(a, sizeof(a), i == WIN_START ? w->start_min : w->end_min);
+                snprintf(out, len, "%s: %s", i == WIN_START ? "INICIO" : "FIN", val[0] ? val : a);
+                break;
+            case WIN_T0:
+                if (val[0]) snprintf(out, len, "T 0%%: %sC", val);
+                else snprintf(out, len, "T 0%%: %.1fC", w->t_zero);
+                break;
+            case WIN_T100:
+                if (val[0]) snprintf(out, len, "T 100%%: %sC", val);
+                else snprintf(out, len, "T 100%%: %.1fC", w->t_hundred);
+                break;
+            default:
+                snprintf(out, len, "BORRAR");
+                break;
+        }
+    }
+}
+
+void menu_render(void)
+{
+    if (m.screen == SCREEN_CLOSED) return;
+
+    int64_t now = now_ms();
+    if (now - m.last_key > MENU_TIMEOUT_MS) {
+        menu_close();
+        return;
+    }
+
+    settings_t s;
+    settings_get(&s);
+    char line[MENU_COLS + 8];
+
+    // La ventana puede haber cambiado desde la web: se relee fuera de la edición
+    if (m.screen != SCREEN_MAIN && !m.editing) {
+        reload_schedules();
+        if (m.screen == SCREEN_SCHED_ITEM && m.win >= m.sched_count) go_to(SCREEN_SCHED_LIST, 0);
+        if (m.sel >= item_count()) go_to(m.screen, 0);
+    }
+
+    if (m.screen == SCREEN_MAIN) snprintf(line, sizeof(line), "CONFIGURACION");
+    else if (m.screen == SCREEN_SCHED_LIST) snprintf(line, sizeof(line), "HORARIOS %d/%d", m.sched_count, SCHEDULE_MAX_WINDOWS);
+    else snprintf(line, sizeof(line), "HORARIO %d", m.win + 1);
+    display_print_page(0, line, false);
+
+    int n = item_count();
+    for (int row = 0; row < MENU_ROWS; row++) {
+        int i = m.top + row;
+        line[0] = '\0';
+        if (i < n) format_item(i, line, sizeof(line), &s);
+        // La línea en edición no va invertida, así se distingue de la selección
+        display_print_page(1 + row, line, i == m.sel && !m.editing);
+    }
+
+    const char *hint;
+    if (now < m.msg_until) hint = m.msg;
+    else if (!m.editing) hint = "A/B MOVER #OK *ATRAS";
+    else if (item_kind(m.sel) == KIND_CHOICE) hint = "A/B CAMBIAR # GUARDAR";
+    else if (item_kind(m.sel) == KIND_DECIMAL) hint = "C BORRA D . # GUARDA";
+    else hint = "C BORRAR # GUARDAR";
+    display_print_page(7, hint, false);
+}
@@ -0,0 +1,38 @@
+#ifndef MENU_H
+#define MENU_H
+
+#include <stdbool.h>
+
+// Menú local de configuración (teclado 4x4 + OLED). Solo con el sistema
+// desbloqueado. Los cambios se guardan por el mismo camino que la web
+// (settings_commit).
+//
+//   A: subir / siguiente opción    B: bajar / opción anterior
+//   C: borrar dígito               D: punto decimal
+//   #: entrar / guardar            *: volver / cancelar
+
+/**
+ * @brief Abre el menú principal.
+ */
+void menu_open(void);
+
+/**
+ * @brief Cierra el menú descartando la edición en curso.
+ */
+void menu_close(void);
+
+bool menu_is_open(void);
+
+/**
+ * @brief Procesa una tecla con el menú abierto.
+ * @return false si la tecla cerró el menú.
+ */
+bool menu_handle_key(char key);
+
+/**
+ * @brief Dibuja el menú. Solo se envían las líneas que cambiaron.
+ * Cierra el menú tras MENU_TIMEOUT_MS sin teclas.
+ */
+void menu_render(void);
+
+#endif // MENU_H
@@ -15,21 +15,32 @@ void motor_init(void) {
     ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
 
     // 2. Configuración del Canal LEDC (Channel)
+    ESP_ERROR_CHECK(motor_init_channel(0, FAN_PIN));
+}
+
+esp_err_t motor_init_channel(int index, gpio_num_t pin) {
+    if (index < 0 || index >= MOTOR_MAX_CHANNELS) return ESP_ERR_INVALID_ARG;
+
     ledc_channel_config_t ledc_channel = {
         .speed_mode     = LEDC_MODE,
-        .channel        = LEDC_CHANNEL,
+        .channel        = LEDC_CHANNEL + index,
         .timer_sel      = LEDC_TIMER,
         .intr_type      = LEDC_INTR_DISABLE,
-        .gpio_num       = FAN_PIN,
+        .gpio_num       = pin,
         .duty           = 0, // Inicia apagado
         .hpoint         = 0
     };
-    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
-
-    ESP_LOGI(TAG, "Motor (PWM) inicializado en GPIO %d", FAN_PIN);
+    esp_err_t err = ledc_channel_config(&ledc_channel);
+    if (err == ESP_OK) ESP_LOGI(TAG, "Motor %d (PWM) inicializado en GPIO %d", index, pin);
+    return err;
 }
 
 void motor_set_speed_percent(int percent) {
+    motor_set_channel_percent(0, percent);
+}
+
+void motor_set_channel_percent(int index, int percent) {
+    if (index < 0 || index >= MOTOR_MAX_CHANNELS) return;
     if (percent < 0) percent = 0;
     if (percent > 100) percent = 100;
 
@@ -40,8 +51,8 @@ void motor_set_speed_percent(int percent) {
     uint32_t duty = (percent * LEDC_MAX_DUTY) / 100;
 
     // Aplicar nuevo ciclo de trabajo
-    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, duty);
-    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL + index, duty);
+    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL + index);
 }
 
 
@@ -25,4 +25,18 @@ void motor_init(void);
  */
 void motor_set_speed_percent(int percent);
 
+// --- Varios ventiladores (zonas) ---
+#define MOTOR_MAX_CHANNELS 8  // Canales LEDC de baja velocidad del ESP32
+
+/**
+ * @brief Configura un canal PWM extra sobre el mismo timer (llamar tras motor_init).
+ * @param index 0..MOTOR_MAX_CHANNELS-1 (el 0 es FAN_PIN).
+ */
+esp_err_t motor_init_channel(int index, gpio_num_t pin);
+
+/**
+ * @brief Igual que motor_set_speed_percent pero para el canal 'index'.
+ */
+void motor_set_channel_percent(int index, int percent);
+
 #endif // MOTOR_H
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "Occupancy.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
+
+static const char *TAG = "OCC";
+
+typedef struct {
+    gpio_num_t pin;
+
+    // Escrito por la ISR (con occ_mux)
+    bool level;
+    bool seen_fall;             // Hubo al menos una bajada
+    int64_t last_fall_us;
+    uint32_t edges;
+
+    // Solo el lazo de control
+    bool pin_mismatch;          // El pin no coincidía con 'level' en el tick anterior
+    uint32_t missed_edges;
+    bool occupied;
+    bool seen_vacant;
+    int64_t vacant_since_us;
+    int64_t occupied_us;
+    uint32_t sessions;
+    uint32_t false_vacancies;
+    uint32_t hold_s;
+} occ_sensor_t;
+
+static occ_sensor_t sensors[OCC_MAX_SENSORS];
+static uint8_t sensor_count;
+static int64_t last_update_us;
+static portMUX_TYPE occ_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Lectura directa del registro: gpio_get_level no está en IRAM
+static inline bool IRAM_ATTR pin_level(gpio_num_t pin)
+{
+    uint32_t in = (pin < 32) ? REG_READ(GPIO_IN_REG) : REG_READ(GPIO_IN1_REG);
+    return (in >> (pin & 31)) & 1;
+}
+
+static void IRAM_ATTR pir_isr(void *arg)
+{
+    occ_sensor_t *s = arg;
+    int64_t now = esp_timer_get_time();
+    bool level = pin_level(s->pin);
+
+    portENTER_CRITICAL_ISR(&occ_mux);
+    if (level && !s->level) {
+        s->edges++;
+    } else if (!level) {
+        // Bajada (o un pulso tan corto que ya terminó al atender la
+        // interrupción de subida: cuenta igual como movimiento)
+        if (!s->level) s->edges++;
+        s->last_fall_us = now;
+        s->seen_fall = true;
+    }
+    s->level = level;
+    portEXIT_CRITICAL_ISR(&occ_mux);
+}
+
+int occupancy_add_pin(gpio_num_t pin)
+{
+    for (int i = 0; i < sensor_count; i++) {
+        if (sensors[i].pin == pin) return i;
+    }
+    if (sensor_count == OCC_MAX_SENSORS) return -1;
+
+    // Ya instalado por otro módulo: ESP_ERR_INVALID_STATE, no es un error
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Sin servicio de interrupciones GPIO: %s", esp_err_to_name(err));
+        return -1;
+    }
+
+    occ_sensor_t *s = &sensors[sensor_count];
+    *s = (occ_sensor_t){ .pin = pin, .hold_s = OCC_HOLD_S };
+    s->level = pin_level(pin);      // Tras despertar por el PIR ya arranca ocupado
+
+    gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+    err = gpio_isr_handler_add(pin, pir_isr, s);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "PIR en GPIO %d sin interrupción: %s", pin, esp_err_to_name(err));
+        return -1;
+    }
+    gpio_intr_enable(pin);
+    ESP_LOGI(TAG, "PIR en GPIO %d: espera %d s", pin, OCC_HOLD_S);
+    return sensor_count++;
+}
+
+void occupancy_update(int64_t now_us)
+{
+    int64_t elapsed = (last_update_us != 0) ? now_us - last_update_us : 0;
+    last_update_us = now_us;
+
+    for (int i = 0; i < sensor_count; i++) {
+        occ_sensor_t *s = &sensors[i];
+
+        // Con light sleep automático el GPIO no registra flancos mientras
+        // duerme (gpio_wakeup_enable no sirve: cambia el tipo de
+        // interrupción a nivel), así que 'level' puede quedar viejo. Se
+        // contrasta con el pin en cada tick; recién si no coincide dos
+        // ticks seguidos se corrige, para no adelantarse a una interrupción
+        // que todavía no se atendió.
+        portENTER_CRITICAL(&occ_mux);
+        bool pin = pin_level(s->pin);
+        bool mismatch = (pin != s->level);
+        if (mismatch && s->pin_mismatch) {
+            if (pin) {
+                s->edges++;
+            } else {
+                s->last_fall_us = now_us; // No se sabe cuándo bajó: la espera cuenta desde ahora
+                s->seen_fall = true;
+            }
+            s->level = pin;
+            s->missed_edges++;
+            mismatch = false;
+        }
+        bool level = s->level;
+        bool seen_fall = s->seen_fall;
+        int64_t last_fall = s->last_fall_us;
+        portEXIT_CRITICAL(&occ_mux);
+        s->pin_mismatch = mismatch;
+
+        bool occupied = level || (seen_fall && now_us - last_fall < (int64_t)s->hold_s * 1000000);
+
+        if (occupied && !s->occupied) {
+            s->sessions++;
+            if (s->seen_vacant && now_us - s->vacant_since_us < (int64_t)OCC_RETRIGGER_S * 1000000) {
+                // Se apagó con alguien quieto en la sala: esperar más
+                s->false_vacancies++;
+                s->hold_s = (s->hold_s * 2 > OCC_HOLD_MAX_S) ? OCC_HOLD_MAX_S : s->hold_s * 2;
+                ESP_LOGI(TAG, "GPIO %d: vacío falso, espera %lu s", s->pin, (unsigned long)s->hold_s);
+            } else {
+                s->hold_s = OCC_HOLD_S;
+            }
+        } else if (!occupied && s->occupied) {
+            s->seen_vacant = true;
+            s->vacant_since_us = now_us;
+        }
+        if (s->occupied) s->occupied_us += elapsed;
+        s->occupied = occupied;
+    }
+}
+
+bool occupancy_is_occupied(int idx)
+{
+    return idx >= 0 && idx < sensor_count && sensors[idx].occupied;
+}
+
+void occupancy_get_stats(int idx, occupancy_stats_t *out)
+{
+    *out = (occupancy_stats_t){ 0 };
+    if (idx < 0 || idx >= sensor_count) return;
+    const occ_sensor_t *s = &sensors[idx];
+
+    portENTER_CRITICAL(&occ_mux);
+    out->motion = s->level;
+    out->edges = s->edges;
+    portEXIT_CRITICAL(&occ_mux);
+
+    out->occupied = s->occupied;
+    out->sessions = s->sessions;
+    out->false_vacancies = s->false_vacancies;
+    out->missed_edges = s->missed_edges;
+    out->occupied_s = (uint32_t)(s->occupied_us / 1000000);
+    out->hold_s = s->hold_s;
+}
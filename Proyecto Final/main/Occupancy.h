@@ -0,0 +1,50 @@
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driver/gpio.h"
+#include "sdkconfig.h"
+
+// Presencia a partir de los PIR. Cada flanco entra por interrupción con su
+// marca de esp_timer; el lazo de control solo consulta "ocupado", que sigue
+// en true hasta OCC_HOLD_S después del último movimiento. Si alguien vuelve
+// a moverse dentro de OCC_RETRIGGER_S después de declararse vacío, la
+// salida fue falsa (estaba quieto): la espera se duplica hasta OCC_HOLD_MAX_S
+// y vuelve a la base tras un vacío largo.
+
+#define OCC_MAX_SENSORS 8
+#define OCC_HOLD_S      CONFIG_VENT_OCC_HOLD_S
+#define OCC_RETRIGGER_S CONFIG_VENT_OCC_RETRIGGER_S
+#define OCC_HOLD_MAX_S  (4 * OCC_HOLD_S)
+
+typedef struct {
+    bool occupied;
+    bool motion;                // Salida del PIR ahora
+    uint32_t edges;             // Flancos de subida
+    uint32_t sessions;          // Veces que pasó de vacío a ocupado
+    uint32_t false_vacancies;   // Vacíos desmentidos dentro de OCC_RETRIGGER_S
+    uint32_t missed_edges;      // Flancos que no llegaron a la ISR (corregidos leyendo el pin)
+    uint32_t occupied_s;        // Tiempo ocupado acumulado
+    uint32_t hold_s;            // Espera vigente
+} occupancy_stats_t;
+
+/**
+ * @brief Registra un PIR (ya configurado como entrada) y habilita su
+ * interrupción en ambos flancos. Un pin ya registrado devuelve el mismo índice.
+ * @return Índice para las demás funciones o -1 si no hay lugar.
+ */
+int occupancy_add_pin(gpio_num_t pin);
+
+/**
+ * @brief Avanza el modelo hasta 'now_us' (una vez por tick de control).
+ * También lee cada pin y corrige un flanco perdido en light sleep (con
+ * hasta dos ticks de retraso).
+ */
+void occupancy_update(int64_t now_us);
+
+bool occupancy_is_occupied(int idx);
+
+void occupancy_get_stats(int idx, occupancy_stats_t *out);
+
+#endif // OCCUPANCY_H
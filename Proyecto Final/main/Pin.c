@@ -0,0 +1,207 @@
+#include "Pin.h"
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "StaticMutex.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "mbedtls/sha256.h"
+#include "nvs.h"
+
+static const char *TAG = "PIN";
+
+#define PIN_REC_VERSION 1
+#define PIN_SALT_LEN    16
+#define PIN_HASH_LEN    32
+
+// Formato en NVS
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t salt[PIN_SALT_LEN];
+    uint8_t hash[PIN_HASH_LEN];
+} pin_rec_t;
+
+static pin_rec_t rec;
+static mbedtls_sha256_context salted;   // SHA-256 con la sal ya procesada
+static uint8_t failures;
+static int64_t locked_until_us;
+static bool ready;                      // pin_init() ya cargó el hash
+
+static static_mutex_t lock;
+
+static void pin_lock(void)
+{
+    static_mutex_take(&lock);
+}
+
+static void pin_unlock(void)
+{
+    static_mutex_give(&lock);
+}
+
+static void prepare_salted(void)
+{
+    mbedtls_sha256_free(&salted);
+    mbedtls_sha256_init(&salted);
+    mbedtls_sha256_starts(&salted, 0);
+    mbedtls_sha256_update(&salted, rec.salt, PIN_SALT_LEN);
+}
+
+static void hash_pin(const char *pin, uint8_t out[PIN_HASH_LEN])
+{
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_clone(&ctx, &salted);
+    mbedtls_sha256_update(&ctx, (const uint8_t *)pin, strlen(pin));
+    mbedtls_sha256_finish(&ctx, out);
+    mbedtls_sha256_free(&ctx);
+}
+
+// Recorre siempre los 32 bytes: el tiempo no depende de dónde difieren
+static bool hash_equal(const uint8_t *a, const uint8_t *b)
+{
+    volatile uint8_t diff = 0;
+    for (int i = 0; i < PIN_HASH_LEN; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+static bool pin_valid(const char *pin)
+{
+    size_t len = strlen(pin);
+    if (len < PIN_MIN_LEN || len > PIN_MAX_LEN) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (pin[i] < '0' || pin[i] > '9') return false;
+    }
+    return true;
+}
+
+static void save_failures(void)
+{
+    nvs_handle_t my_handle;
+    if (nvs_open("storage", NVS_READWRITE, &my_handle) != ESP_OK) return;
+    if (nvs_set_u8(my_handle, "pin_fail", failures) == ESP_OK) nvs_commit(my_handle);
+    nvs_close(my_handle);
+}
+
+static void start_lockout(void)
+{
+    if (failures < PIN_FREE_ATTEMPTS) return;
+    int shift = failures - PIN_FREE_ATTEMPTS;
+    uint32_t ms = (shift < 16) ? (PIN_LOCKOUT_BASE_MS << shift) : PIN_LOCKOUT_MAX_MS;
+    if (ms > PIN_LOCKOUT_MAX_MS) ms = PIN_LOCKOUT_MAX_MS;
+    locked_until_us = esp_timer_get_time() + (int64_t)ms * 1000;
+    ESP_LOGW(TAG, "%u intentos fallidos: bloqueado %lu s", failures, (unsigned long)(ms / 1000));
+}
+
+// Llamar con el lock tomado
+static pin_result_t check_locked(const char *pin)
+{
+    if (!ready || esp_timer_get_time() < locked_until_us) return PIN_LOCKED;
+
+    uint8_t h[PIN_HASH_LEN];
+    hash_pin(pin, h);
+    if (hash_equal(h, rec.hash)) {
+        if (failures != 0) {
+            failures = 0;
+            save_failures();
+        }
+        return PIN_OK;
+    }
+
+    if (failures < UINT8_MAX) failures++;
+    save_failures();
+    start_lockout();
+    return PIN_WRONG;
+}
+
+static esp_err_t store_pin(const char *pin)
+{
+    pin_rec_t next = { .version = PIN_REC_VERSION };
+    esp_fill_random(next.salt, PIN_SALT_LEN);
+
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+    mbedtls_sha256_update(&ctx, next.salt, PIN_SALT_LEN);
+    mbedtls_sha256_update(&ctx, (const uint8_t *)pin, strlen(pin));
+    mbedtls_sha256_finish(&ctx, next.hash);
+    mbedtls_sha256_free(&ctx);
+
+    nvs_handle_t my_handle;
+    esp_err_t err = nvs_open("storage", NVS_READWRITE, &my_handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(my_handle, "pin", &next, sizeof(next));
+        if (err == ESP_OK) err = nvs_commit(my_handle);
+        nvs_close(my_handle);
+    }
+    // Aunque falle NVS el PIN nuevo vale hasta el próximo reinicio
+    rec = next;
+    prepare_salted();
+    return err;
+}
+
+void pin_init(void)
+{
+    pin_lock();
+    mbedtls_sha256_init(&salted);
+
+    // Sin namespace todavía nvs_open() también da NOT_FOUND: primer arranque
+    nvs_handle_t my_handle;
+    esp_err_t err = nvs_open("storage", NVS_READONLY, &my_handle);
+    if (err == ESP_OK) {
+        size_t len = sizeof(rec);
+        err = nvs_get_blob(my_handle, "pin", &rec, &len);
+        if (err == ESP_OK && (len != sizeof(rec) || rec.version != PIN_REC_VERSION)) err = ESP_ERR_INVALID_VERSION;
+        if (nvs_get_u8(my_handle, "pin_fail", &failures) != ESP_OK) failures = 0;
+        nvs_close(my_handle);
+    }
+
+    if (err == ESP_OK) {
+        prepare_salted();
+    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "Sin PIN en NVS: se usa el PIN por defecto");
+        store_pin(PIN_DEFAULT);
+    } else {
+        // Un registro dañado o un error de NVS no vuelve al PIN por defecto
+        // (se podría forzar así): queda bloqueado hasta que se resuelva
+        ESP_LOGE(TAG, "No se pudo cargar el PIN (%s): teclado y web bloqueados", esp_err_to_name(err));
+        pin_unlock();
+        return;
+    }
+
+    // Reiniciar no saltea la espera: se vuelve a contar desde el arranque
+    start_lockout();
+    ready = true;
+    pin_unlock();
+}
+
+pin_result_t pin_check(const char *pin)
+{
+    pin_lock();
+    pin_result_t res = check_locked(pin);
+    pin_unlock();
+    return res;
+}
+
+uint32_t pin_lockout_remaining_ms(void)
+{
+    pin_lock();
+    int64_t left = locked_until_us - esp_timer_get_time();
+    pin_unlock();
+    return (left > 0) ? (uint32_t)((left + 999) / 1000) : 0;
+}
+
+esp_err_t pin_change(const char *old_pin, const char *new_pin)
+{
+    if (!pin_valid(new_pin)) return ESP_ERR_INVALID_ARG;
+
+    pin_lock();
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    if (check_locked(old_pin) == PIN_OK) {
+        err = store_pin(new_pin);
+        if (err == ESP_OK) ESP_LOGI(TAG, "PIN cambiado");
+    }
+    pin_unlock();
+    return err;
+}
@@ -0,0 +1,50 @@
+#ifndef PIN_H
+#define PIN_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// PIN de desbloqueo: en NVS solo se guarda SHA-256(sal || PIN) con una sal
+// aleatoria de 16 bytes. Tras PIN_FREE_ATTEMPTS errores seguidos se bloquea
+// con espera exponencial (el contador sobrevive a reinicios y deep sleep).
+
+#define PIN_DEFAULT        "1234"   // Primer arranque (cambiar por /api/pin)
+#define PIN_MIN_LEN        4
+#define PIN_MAX_LEN        8
+#define PIN_FREE_ATTEMPTS  3
+#define PIN_LOCKOUT_BASE_MS 5000    // 5 s, 10 s, 20 s ...
+#define PIN_LOCKOUT_MAX_MS  (15 * 60 * 1000)
+
+typedef enum {
+    PIN_OK,
+    PIN_WRONG,
+    PIN_LOCKED,     // En espera: ni siquiera se comparó
+} pin_result_t;
+
+/**
+ * @brief Carga sal y hash desde NVS y deja el SHA-256 de la sal
+ * precalculado: verificar cuesta un solo bloque. Solo si la clave no
+ * existe crea el PIN por defecto; con otro error (registro dañado, NVS
+ * que no abre) no hay PIN válido y pin_check() devuelve PIN_LOCKED.
+ */
+void pin_init(void);
+
+/**
+ * @brief Compara en tiempo constante. No bloquea: durante la espera (o
+ * antes de pin_init) devuelve PIN_LOCKED sin mirar el PIN.
+ */
+pin_result_t pin_check(const char *pin);
+
+/**
+ * @brief Milisegundos que faltan para poder volver a intentar (0 = libre).
+ */
+uint32_t pin_lockout_remaining_ms(void);
+
+/**
+ * @brief Cambia el PIN (4..8 dígitos) con una sal nueva.
+ * @return ESP_ERR_INVALID_STATE si el PIN actual no coincide o está en
+ * espera, ESP_ERR_INVALID_ARG si el nuevo no es válido.
+ */
+esp_err_t pin_change(const char *old_pin, const char *new_pin);
+
+#endif // PIN_H
@@ -0,0 +1,164 @@
+#include "PowerMgmt.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_private/esp_clk.h"
+#include "soc/rtc.h"
+#include "soc/rtc_cntl_reg.h"
+#include <string.h>
+#include "driver/rtc_io.h"
+#include "Sensor.h"
+#include "BootProfile.h"
+
+static const char *TAG = "POWER";
+
+#define RTC_STATE_MAGIC 0x56454E54 // "VENT"
+
+// Sobrevive al deep sleep y a los resets por software (esp_restart, OTA,
+// watchdog); solo un arranque en frío la deja con basura -> magic + checksum
+static RTC_NOINIT_ATTR uint32_t rtc_magic;
+static RTC_NOINIT_ATTR power_rtc_state_t rtc_state;
+static RTC_NOINIT_ATTR uint32_t rtc_checksum;
+static RTC_NOINIT_ATTR uint32_t rtc_sleep_count;
+
+// Contador RTC leído por el wake stub apenas termina la ROM (el timer RTC
+// sigue corriendo durante el deep sleep; esp_timer arranca recién con la app)
+static RTC_DATA_ATTR uint64_t rtc_wake_ticks;
+
+static esp_pm_lock_handle_t fan_lock = NULL;
+static bool fan_lock_held = false;
+static bool woke_from_sleep = false;
+static bool control_ready = false;
+static int32_t wake_latency_ms = -1;
+static int64_t idle_since_us = 0;
+
+// Corre desde la RAM RTC antes del bootloader: solo registros y ROM
+void RTC_IRAM_ATTR esp_wake_deep_sleep(void)
+{
+    SET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_UPDATE);
+    while (GET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_VALID) == 0) { }
+    SET_PERI_REG_MASK(RTC_CNTL_INT_CLR_REG, RTC_CNTL_TIME_VALID_INT_CLR);
+    rtc_wake_ticks = READ_PERI_REG(RTC_CNTL_TIME0_REG) |
+                     ((uint64_t)READ_PERI_REG(RTC_CNTL_TIME1_REG) << 32);
+    esp_default_wake_deep_sleep();
+}
+
+static uint32_t rtc_state_checksum(const power_rtc_state_t *st)
+{
+    // FNV-1a sobre el estado
+    const uint8_t *p = (const uint8_t *)st;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(*st); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+void power_init(void)
+{
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    woke_from_sleep = (cause == ESP_SLEEP_WAKEUP_EXT0 || cause == ESP_SLEEP_WAKEUP_TIMER);
+    if (woke_from_sleep) {
+        // El PIR quedó como RTC GPIO para el despertar: devolverlo al GPIO normal
+        rtc_gpio_deinit(PIR_PIN);
+        ESP_LOGI(TAG, "Despertar #%lu por %s", (unsigned long)rtc_sleep_count,
+                 cause == ESP_SLEEP_WAKEUP_EXT0 ? "PIR" : "timer");
+    }
+
+#if CONFIG_VENT_POWER_SAVE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = 40,
+        .light_sleep_enable = true,
+    };
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No se pudo activar light sleep: %s", esp_err_to_name(err));
+    }
+    esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "fan", &fan_lock);
+#endif
+
+    idle_since_us = esp_timer_get_time();
+}
+
+bool power_rtc_restore(power_rtc_state_t *out)
+{
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (reason == ESP_RST_POWERON || reason == ESP_RST_BROWNOUT) {
+        rtc_magic = 0;
+        rtc_sleep_count = 0;
+        return false;
+    }
+    if (rtc_magic != RTC_STATE_MAGIC || rtc_checksum != rtc_state_checksum(&rtc_state)) return false;
+    *out = rtc_state;
+    return true;
+}
+
+void power_rtc_save(const power_rtc_state_t *state)
+{
+    if (rtc_magic == RTC_STATE_MAGIC && memcmp(&rtc_state, state, sizeof(*state)) == 0) return;
+    rtc_state = *state;
+    rtc_checksum = rtc_state_checksum(state);
+    rtc_magic = RTC_STATE_MAGIC;
+}
+
+void power_set_fan_active(bool active)
+{
+    if (fan_lock == NULL || active == fan_lock_held) return;
+    if (active) esp_pm_lock_acquire(fan_lock);
+    else esp_pm_lock_release(fan_lock);
+    fan_lock_held = active;
+}
+
+bool power_idle_tick(bool locked, bool motion)
+{
+    int64_t now = esp_timer_get_time();
+    if (!locked || motion) {
+        idle_since_us = now;
+        return false;
+    }
+#if CONFIG_VENT_DEEP_SLEEP_IDLE_S > 0
+    return (now - idle_since_us) >= (int64_t)CONFIG_VENT_DEEP_SLEEP_IDLE_S * 1000000;
+#else
+    return false;
+#endif
+}
+
+void power_enter_deep_sleep(const power_rtc_state_t *state)
+{
+    power_rtc_save(state);
+    rtc_sleep_count++;
+
+    // PIR en alto despierta; pull-down para que no flote durante el sueño
+    rtc_gpio_pullup_dis(PIR_PIN);
+    rtc_gpio_pulldown_en(PIR_PIN);
+    esp_sleep_enable_ext0_wakeup(PIR_PIN, 1);
+#if CONFIG_VENT_DEEP_SLEEP_TIMER_S > 0
+    esp_sleep_enable_timer_wakeup((uint64_t)CONFIG_VENT_DEEP_SLEEP_TIMER_S * 1000000);
+#endif
+
+    ESP_LOGI(TAG, "Bloqueado y sin movimiento: entrando en deep sleep");
+    esp_deep_sleep_start();
+}
+
+void power_mark_control_ready(void)
+{
+    if (control_ready) return;
+    control_ready = true;
+    boot_profile_mark("control");
+    if (woke_from_sleep) {
+        // Desde el wake stub: incluye bootloader, carga de la app e init
+        uint64_t ticks = rtc_time_get() - rtc_wake_ticks;
+        wake_latency_ms = (int32_t)(rtc_time_slowclk_to_us(ticks, esp_clk_slowclk_cal_get()) / 1000);
+        ESP_LOGI(TAG, "Despertar -> control: %ld ms", (long)wake_latency_ms);
+    }
+}
+
+int32_t power_wake_latency_ms(void)
+{
+    return wake_latency_ms;
+}
@@ -0,0 +1,61 @@
+#ifndef POWER_MGMT_H
+#define POWER_MGMT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Estado mínimo que sobrevive al deep sleep y a los resets por software (memoria RTC)
+typedef struct {
+    int32_t system_mode;
+    int32_t manual_pwm;
+    int32_t auto_tmin_cc;   // Centésimas de grado
+    int32_t auto_tmax_cc;
+} power_rtc_state_t;
+
+/**
+ * @brief Configura el DFS + light sleep automático y crea el lock de PM.
+ * Llamar al inicio de app_main.
+ */
+void power_init(void);
+
+/**
+ * @brief Devuelve true si hay un estado válido en memoria RTC (despertar de
+ * deep sleep o reset por software) y lo copia en 'out'. Evita leer NVS.
+ */
+bool power_rtc_restore(power_rtc_state_t *out);
+
+/**
+ * @brief Actualiza la copia en memoria RTC (no hace nada si no cambió).
+ */
+void power_rtc_save(const power_rtc_state_t *state);
+
+/**
+ * @brief Mientras el motor gira se impide el light sleep (el LEDC necesita reloj).
+ */
+void power_set_fan_active(bool active);
+
+/**
+ * @brief Lleva la cuenta del tiempo bloqueado y sin movimiento.
+ * @return true cuando se supera CONFIG_VENT_DEEP_SLEEP_IDLE_S.
+ */
+bool power_idle_tick(bool locked, bool motion);
+
+/**
+ * @brief Guarda el estado en RTC, arma el despertar por PIR/timer y entra
+ * en deep sleep. No retorna.
+ */
+void power_enter_deep_sleep(const power_rtc_state_t *state);
+
+/**
+ * @brief Marca el primer tick de control tras el arranque; si venimos de
+ * deep sleep registra la latencia despertar -> control, medida con el timer
+ * RTC desde el wake stub (solo queda afuera el arranque de la ROM).
+ */
+void power_mark_control_ready(void);
+
+/**
+ * @brief Latencia medida del último despertar en ms (-1 si fue arranque normal).
+ */
+int32_t power_wake_latency_ms(void);
+
+#endif // POWER_MGMT_H
@@ -0,0 +1,288 @@
+#include "Schedule.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "StaticMutex.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "Settings.h"
+
+static const char *TAG = "SCHEDULE";
+
+// Cada ventana genera como máximo 2 intervalos por día (si cruza el fin de semana)
+#define MAX_INTERVALS (SCHEDULE_MAX_WINDOWS * 7 * 2)
+#define MAX_SEGMENTS  (2 * MAX_INTERVALS + 1)
+
+// Tramo de la semana [start, siguiente start) y la ventana que manda en
+// cada zona (-1 = ninguna)
+typedef struct {
+    uint16_t start;
+    int8_t window[SCHEDULE_MAX_ZONES];
+} segment_t;
+
+typedef struct {
+    uint16_t start;
+    uint16_t end;
+    int8_t window;
+} interval_t;
+
+#define TABLE_STAGED UINT32_MAX
+
+// Ventanas y su tabla compilada. 'gen' es la generación de Settings con la
+// que se publicó (TABLE_STAGED mientras espera a Settings).
+typedef struct {
+    schedule_t windows[SCHEDULE_MAX_WINDOWS];
+    int window_count;
+    segment_t segments[MAX_SEGMENTS];
+    int segment_count;
+    uint32_t gen;
+} table_t;
+
+// Doble buffer: se compila en la tabla que no está vigente y se cambia el
+// puntero al publicar. La anterior queda para quien todavía tiene la
+// configuración de esa generación.
+static table_t tables[2] = {
+    {
+        .windows = {
+            {false, SCHEDULE_ALL_DAYS, 0, SCHEDULE_ALL_ZONES,  8 * 60, 12 * 60, 20.0, 30.0},
+            {false, SCHEDULE_ALL_DAYS, 0, SCHEDULE_ALL_ZONES, 14 * 60, 18 * 60, 22.0, 32.0},
+            {false, SCHEDULE_ALL_DAYS, 0, SCHEDULE_ALL_ZONES, 20 * 60, 23 * 60, 18.0, 25.0},
+        },
+        .window_count = 3,
+        .segments = { {0, {-1, -1, -1, -1, -1, -1, -1, -1}} },
+        .segment_count = 1,
+        .gen = 0,
+    },
+    { .gen = TABLE_STAGED },
+};
+static table_t *_Atomic active = &tables[0];
+
+// Temporales de compilación (protegidos por el mutex, fuera de la pila)
+static interval_t intervals[MAX_INTERVALS];
+static uint16_t bounds[2 * MAX_INTERVALS + 1];
+
+static static_mutex_t lock;
+
+static void schedule_lock(void)
+{
+    static_mutex_take(&lock);
+}
+
+static void schedule_unlock(void)
+{
+    static_mutex_give(&lock);
+}
+
+static int cmp_u16(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+static int add_interval(int n, uint32_t start, uint32_t end, int w)
+{
+    if (end <= MINUTES_PER_WEEK) {
+        intervals[n++] = (interval_t){ start, end, w };
+    } else {
+        // Sábado que cruza a domingo: partir en dos
+        intervals[n++] = (interval_t){ start, MINUTES_PER_WEEK, w };
+        intervals[n++] = (interval_t){ 0, end - MINUTES_PER_WEEK, w };
+    }
+    return n;
+}
+
+// Precompila las ventanas en una tabla ordenada de tramos sin solapes.
+// Se llama solo al cambiar la configuración; la consulta luego es binaria.
+static void compile_table(table_t *t)
+{
+    const schedule_t *windows = t->windows;
+    int n_int = 0;
+    for (int w = 0; w < t->window_count; w++) {
+        const schedule_t *s = &windows[w];
+        if (!s->active || s->start_min >= MINUTES_PER_DAY || s->end_min > MINUTES_PER_DAY) continue;
+        if (s->start_min == s->end_min) continue;
+
+        for (int d = 0; d < 7; d++) {
+            if (!(s->days & (1 << d))) continue;
+            uint32_t start = d * MINUTES_PER_DAY + s->start_min;
+            uint32_t end = d * MINUTES_PER_DAY + s->end_min;
+            if (s->end_min < s->start_min) end += MINUTES_PER_DAY;
+            n_int = add_interval(n_int, start, end, w);
+        }
+    }
+
+    int n_b = 0;
+    bounds[n_b++] = 0;
+    for (int i = 0; i < n_int; i++) {
+        bounds[n_b++] = intervals[i].start;
+        if (intervals[i].end < MINUTES_PER_WEEK) bounds[n_b++] = intervals[i].end;
+    }
+    qsort(bounds, n_b, sizeof(bounds[0]), cmp_u16);
+
+    int segment_count = 0;
+    for (int b = 0; b < n_b; b++) {
+        if (b > 0 && bounds[b] == bounds[b - 1]) continue;
+
+        segment_t seg = { .start = bounds[b] };
+        memset(seg.window, -1, sizeof(seg.window));
+        for (int i = 0; i < n_int; i++) {
+            const interval_t *it = &intervals[i];
+            if (bounds[b] < it->start || bounds[b] >= it->end) continue;
+            const schedule_t *s = &windows[it->window];
+            for (int z = 0; z < SCHEDULE_MAX_ZONES; z++) {
+                if (!(s->zones & (1 << z))) continue;
+                int best = seg.window[z];
+                if (best < 0 || s->priority > windows[best].priority ||
+                    (s->priority == windows[best].priority && it->window < best)) {
+                    seg.window[z] = it->window;
+                }
+            }
+        }
+
+        if (segment_count > 0 && memcmp(t->segments[segment_count - 1].window, seg.window, sizeof(seg.window)) == 0) continue;
+        t->segments[segment_count++] = seg;
+    }
+    t->segment_count = segment_count;
+
+    ESP_LOGI(TAG, "%d ventanas -> %d tramos", t->window_count, segment_count);
+}
+
+static table_t *spare(const table_t *t)
+{
+    return (t == &tables[0]) ? &tables[1] : &tables[0];
+}
+
+void schedule_stage(const schedule_t *src, int count)
+{
+    if (count < 0) count = 0;
+    if (count > SCHEDULE_MAX_WINDOWS) count = SCHEDULE_MAX_WINDOWS;
+
+    schedule_lock();
+    table_t *next = spare(atomic_load(&active));
+    next->gen = TABLE_STAGED;
+    memcpy(next->windows, src, count * sizeof(schedule_t));
+    next->window_count = count;
+    compile_table(next);
+    schedule_unlock();
+}
+
+// Sin mutex: Settings la llama dentro de su sección crítica. Solo cambia el
+// puntero; schedule_stage() y esta función nunca corren a la vez (las
+// serializa el lock de Settings).
+void schedule_activate(uint32_t gen)
+{
+    table_t *next = spare(atomic_load(&active));
+    if (next->gen == TABLE_STAGED) {
+        next->gen = gen;
+        atomic_store(&active, next);
+    }
+}
+
+int schedule_get(schedule_t *out, int max)
+{
+    schedule_lock();
+    const table_t *t = atomic_load(&active);
+    int n = t->window_count < max ? t->window_count : max;
+    memcpy(out, t->windows, n * sizeof(schedule_t));
+    schedule_unlock();
+    return n;
+}
+
+bool schedule_eval(time_t now, uint32_t gen, int zone_count, schedule_t out[], bool on[], time_t *next_change)
+{
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+    int mow = timeinfo.tm_wday * MINUTES_PER_DAY + timeinfo.tm_hour * 60 + timeinfo.tm_min;
+
+    schedule_lock();
+
+    // La más nueva publicada hasta 'gen' (la vigente, o la anterior si el
+    // lector todavía tiene la configuración vieja)
+    const table_t *t = atomic_load(&active);
+    if (t->gen > gen) {
+        t = spare(t);
+        if (t->gen > gen) {
+            schedule_unlock();
+            return false;
+        }
+    }
+    const segment_t *segments = t->segments;
+    int segment_count = t->segment_count;
+
+    // Búsqueda binaria del último tramo con start <= mow
+    int lo = 0, hi = segment_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (segments[mid].start <= mow) lo = mid;
+        else hi = mid - 1;
+    }
+
+    int next = (lo + 1 < segment_count) ? segments[lo + 1].start : MINUTES_PER_WEEK;
+    if (zone_count > SCHEDULE_MAX_ZONES) zone_count = SCHEDULE_MAX_ZONES;
+    for (int z = 0; z < zone_count; z++) {
+        int w = segments[lo].window[z];
+        on[z] = (w >= 0);
+        if (w >= 0) out[z] = t->windows[w];
+    }
+
+    schedule_unlock();
+
+    if (next_change) *next_change = now - timeinfo.tm_sec + (time_t)(next - mow) * 60;
+    return true;
+}
+
+esp_err_t schedule_validate(const schedule_t *s)
+{
+    if (s->days > SCHEDULE_ALL_DAYS) return ESP_ERR_INVALID_ARG;
+    if (s->start_min >= MINUTES_PER_DAY || s->end_min > MINUTES_PER_DAY) return ESP_ERR_INVALID_ARG;
+    if (!(s->t_zero >= SETTINGS_TEMP_MIN && s->t_hundred <= SETTINGS_TEMP_MAX)) return ESP_ERR_INVALID_ARG;
+    if (!(s->t_zero < s->t_hundred)) return ESP_ERR_INVALID_ARG;
+    return ESP_OK;
+}
+
+void schedule_to_rec(const schedule_t *s, schedule_rec_t *rec)
+{
+    *rec = (schedule_rec_t){
+        .active = s->active,
+        .days = s->days,
+        .priority = s->priority,
+        .zones = s->zones,
+        .start_min = s->start_min,
+        .end_min = s->end_min,
+        .t0_cc = (int16_t)lroundf(s->t_zero * 100),
+        .t100_cc = (int16_t)lroundf(s->t_hundred * 100),
+    };
+}
+
+void schedule_from_rec(const schedule_rec_t *rec, schedule_t *s)
+{
+    *s = (schedule_t){
+        .active = rec->active,
+        .days = rec->days,
+        .priority = rec->priority,
+        .zones = rec->zones,
+        .start_min = rec->start_min,
+        .end_min = rec->end_min,
+        .t_zero = rec->t0_cc / 100.0,
+        .t_hundred = rec->t100_cc / 100.0,
+    };
+}
+
+int schedule_read_legacy_nvs(nvs_handle_t handle, schedule_t *out)
+{
+    // Formato anterior: 3 horarios con granularidad de hora
+    int count = schedule_get(out, SCHEDULE_MAX_WINDOWS);
+    bool found = false;
+    int32_t val = 0;
+    char key[16];
+    for (int i = 0; i < 3 && i < count; i++) {
+        if (nvs_get_i32(handle, (sprintf(key, "sch%d_act", i), key), &val) == ESP_OK) { out[i].active = val; found = true; }
+        if (nvs_get_i32(handle, (sprintf(key, "sch%d_sh", i), key), &val) == ESP_OK) { out[i].start_min = val * 60; found = true; }
+        if (nvs_get_i32(handle, (sprintf(key, "sch%d_eh", i), key), &val) == ESP_OK) { out[i].end_min = val * 60; found = true; }
+        if (nvs_get_i32(handle, (sprintf(key, "sch%d_t0", i), key), &val) == ESP_OK) { out[i].t_zero = val / 100.0; found = true; }
+        if (nvs_get_i32(handle, (sprintf(key, "sch%d_t1", i), key), &val) == ESP_OK) { out[i].t_hundred = val / 100.0; found = true; }
+    }
+    return found ? count : -1;
+}
@@ -0,0 +1,103 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "esp_err.h"
+#include "nvs.h"
+
+// Capacidad máxima de ventanas horarias (cada una ocupa 12 bytes en NVS)
+#define SCHEDULE_MAX_WINDOWS 16
+
+#define MINUTES_PER_DAY  1440
+#define MINUTES_PER_WEEK (7 * MINUTES_PER_DAY)
+
+// Máscara de días (bit 0 = domingo ... bit 6 = sábado, igual que tm_wday)
+#define SCHEDULE_ALL_DAYS 0x7F
+
+// Máscara de zonas a las que aplica una ventana (bit i = zona i)
+#define SCHEDULE_MAX_ZONES 8
+#define SCHEDULE_ALL_ZONES 0xFF
+
+// Ventana horaria del modo PROGRAMADO
+typedef struct {
+    bool active;
+    uint8_t days;        // Máscara de días de la semana
+    uint8_t priority;    // Si se solapan, gana la mayor (empate: la primera)
+    uint8_t zones;       // Máscara de zonas
+    uint16_t start_min;  // Minuto del día de inicio (0..1439)
+    uint16_t end_min;    // Minuto del día de fin (1..1440); si <= inicio cruza medianoche
+    float t_zero;        // Temperatura con ventilador al 0%
+    float t_hundred;     // Temperatura con ventilador al 100%
+} schedule_t;
+
+// Formato de una ventana en NVS (estable, independiente del layout de schedule_t)
+typedef struct __attribute__((packed)) {
+    uint8_t active;
+    uint8_t days;
+    uint8_t priority;
+    uint8_t zones;
+    uint16_t start_min;
+    uint16_t end_min;
+    int16_t t0_cc;
+    int16_t t100_cc;
+} schedule_rec_t;
+
+// Las ventanas se cambian solo a través de settings_commit(), que las guarda
+// junto con la configuración y publica ambas a la vez.
+
+/**
+ * @brief Compila una lista nueva en la tabla libre sin publicarla.
+ * @param windows Arreglo de ventanas (se copia).
+ * @param count Cantidad (se limita a SCHEDULE_MAX_WINDOWS).
+ */
+void schedule_stage(const schedule_t *windows, int count);
+
+/**
+ * @brief Publica la lista preparada con schedule_stage(), marcada con la
+ * generación de Settings que la acompaña. Sin lista preparada no hace nada.
+ * No bloquea (se puede llamar dentro de una sección crítica).
+ */
+void schedule_activate(uint32_t gen);
+
+/**
+ * @brief Copia las ventanas vigentes.
+ * @return Cantidad de ventanas copiadas.
+ */
+int schedule_get(schedule_t *out, int max);
+
+/**
+ * @brief Busca (O(log n)) la ventana que manda en el instante 'now' para
+ * cada zona. Una sola búsqueda sirve para todas las zonas.
+ *
+ * @param now Hora actual.
+ * @param gen Generación de la configuración que usa el llamador: se evalúa
+ *            la lista publicada con ella, no una más nueva.
+ * @param zone_count Zonas a evaluar (hasta SCHEDULE_MAX_ZONES).
+ * @param out Ventana activa de cada zona (solo se escribe si on[i] es true).
+ * @param on Si la zona tiene una ventana vigente.
+ * @param next_change Próximo instante en que el resultado puede cambiar.
+ * @return false si esa lista ya no está (el llamador tiene que releer la
+ *         configuración); en ese caso no se escribe nada.
+ */
+bool schedule_eval(time_t now, uint32_t gen, int zone_count, schedule_t out[], bool on[], time_t *next_change);
+
+/**
+ * @brief Comprueba una ventana: días, minutos de inicio y fin, rango de
+ * temperaturas y t_zero < t_hundred. settings_commit() la aplica a toda la
+ * lista, así que web y menú usan las mismas reglas.
+ */
+esp_err_t schedule_validate(const schedule_t *s);
+
+void schedule_to_rec(const schedule_t *s, schedule_rec_t *rec);
+void schedule_from_rec(const schedule_rec_t *rec, schedule_t *s);
+
+/**
+ * @brief Lee los horarios guardados por la versión anterior (claves
+ * sch%d_* de los 3 horarios fijos).
+ * @return Cantidad leída en 'out' (hasta SCHEDULE_MAX_WINDOWS), o -1 si no hay.
+ */
+int schedule_read_legacy_nvs(nvs_handle_t handle, schedule_t *out);
+
+#endif // SCHEDULE_H
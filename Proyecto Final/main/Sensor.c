@@ -5,13 +5,21 @@
 static const char *TAG = "SENSOR"; // Etiqueta del Log en singular
 
 void sensors_init(void) {
-    gpio_reset_pin(PIR_PIN);
-    gpio_set_direction(PIR_PIN, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(PIR_PIN, GPIO_PULLDOWN_ONLY); 
-    
-    ESP_LOGI(TAG, "Sensor PIR inicializado en GPIO %d", PIR_PIN);
+    sensors_init_pin(PIR_PIN);
 }
 
 bool sensors_get_pir_state(void) {
     return gpio_get_level(PIR_PIN);
+}
+
+void sensors_init_pin(gpio_num_t pin) {
+    gpio_reset_pin(pin);
+    gpio_set_direction(pin, GPIO_MODE_INPUT);
+    gpio_set_pull_mode(pin, GPIO_PULLDOWN_ONLY); 
+    
+    ESP_LOGI(TAG, "Sensor PIR inicializado en GPIO %d", pin);
+}
+
+bool sensors_get_pin_state(gpio_num_t pin) {
+    return gpio_get_level(pin);
 }
\ No newline at end of file
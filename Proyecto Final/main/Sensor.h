@@ -13,4 +13,8 @@ void sensors_init(void);
 // Retorna true si detecta movimiento
 bool sensors_get_pir_state(void);
 
+// PIR adicionales (zonas): misma configuración que PIR_PIN
+void sensors_init_pin(gpio_num_t pin);
+bool sensors_get_pin_state(gpio_num_t pin);
+
 #endif // SENSORS_H
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "Settings.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "StaticMutex.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+static const char *TAG = "SETTINGS";
+
+#define SETTINGS_REC_VERSION 1
+
+// Formato en NVS (estable, independiente del layout de settings_t). Los
+// horarios van en el mismo blob: una sola escritura cambia todo o nada.
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t system_mode;
+    uint8_t manual_pwm;
+    uint8_t sched_count;
+    int16_t auto_tmin_cc;
+    int16_t auto_tmax_cc;
+    schedule_rec_t sched[SCHEDULE_MAX_WINDOWS];
+} settings_rec_t;
+
+#define SETTINGS_REC_HEADER offsetof(settings_rec_t, sched)
+
+// Doble buffer: el escritor llena el que no está publicado y cambia el
+// puntero, la generación y la tabla de horarios en una sección crítica
+// corta. Los lectores copian dentro de la misma sección.
+static settings_t slots[2] = {
+    { SETTINGS_MODE_MANUAL, 0, 20.0, 30.0 },
+};
+static settings_t *current = &slots[0];
+static _Atomic uint32_t generation = 0;
+static portMUX_TYPE publish_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Temporales de settings_commit() (protegidos por el mutex, fuera de la pila)
+static settings_rec_t rec;
+static schedule_t keep[SCHEDULE_MAX_WINDOWS];
+
+static static_mutex_t lock;
+
+static void settings_lock(void)
+{
+    static_mutex_take(&lock);
+}
+
+static void settings_unlock(void)
+{
+    static_mutex_give(&lock);
+}
+
+// Llamar con el lock tomado. Con 'new_schedule' también publica la lista
+// preparada con schedule_stage(), con la misma generación.
+static void publish(const settings_t *s, bool new_schedule)
+{
+    settings_t *next = (current == &slots[0]) ? &slots[1] : &slots[0];
+    *next = *s;
+
+    taskENTER_CRITICAL(&publish_mux);
+    uint32_t gen = atomic_load(&generation) + 1;
+    if (new_schedule) schedule_activate(gen);
+    current = next;
+    atomic_store(&generation, gen);
+    taskEXIT_CRITICAL(&publish_mux);
+}
+
+esp_err_t settings_validate(const settings_t *s)
+{
+    if (s->system_mode < SETTINGS_MODE_MANUAL || s->system_mode > SETTINGS_MODE_PROG) return ESP_ERR_INVALID_ARG;
+    if (s->manual_pwm < 0 || s->manual_pwm > 100) return ESP_ERR_INVALID_ARG;
+    if (!(s->auto_tmin >= SETTINGS_TEMP_MIN && s->auto_tmax <= SETTINGS_TEMP_MAX)) return ESP_ERR_INVALID_ARG;
+    if (!(s->auto_tmin < s->auto_tmax)) return ESP_ERR_INVALID_ARG;
+    return ESP_OK;
+}
+
+void settings_init(const settings_t *s)
+{
+    if (settings_validate(s) != ESP_OK) return;
+    settings_lock();
+    publish(s, false);
+    settings_unlock();
+}
+
+void settings_load_nvs(void)
+{
+    settings_t loaded;
+    settings_get(&loaded);
+    schedule_t sched[SCHEDULE_MAX_WINDOWS];
+    int sched_count = -1;
+
+    nvs_handle_t my_handle;
+    if (nvs_open("storage", NVS_READONLY, &my_handle) != ESP_OK) return;
+
+    settings_rec_t r;
+    size_t len = sizeof(r);
+    esp_err_t err = nvs_get_blob(my_handle, "settings", &r, &len);
+    if (err == ESP_OK && r.version == SETTINGS_REC_VERSION && r.sched_count <= SCHEDULE_MAX_WINDOWS &&
+        len == SETTINGS_REC_HEADER + r.sched_count * sizeof(schedule_rec_t)) {
+        loaded.system_mode = r.system_mode;
+        loaded.manual_pwm = r.manual_pwm;
+        loaded.auto_tmin = r.auto_tmin_cc / 100.0;
+        loaded.auto_tmax = r.auto_tmax_cc / 100.0;
+        sched_count = r.sched_count;
+        for (int i = 0; i < sched_count; i++) schedule_from_rec(&r.sched[i], &sched[i]);
+    } else {
+        // Formato viejo: una clave por campo
+        int32_t val = 0;
+        if (nvs_get_i32(my_handle, "sys_mode", &val) == ESP_OK) loaded.system_mode = val;
+        if (nvs_get_i32(my_handle, "man_pwm", &val) == ESP_OK) loaded.manual_pwm = val;
+        if (nvs_get_i32(my_handle, "auto_tmin", &val) == ESP_OK) loaded.auto_tmin = val / 100.0;
+        if (nvs_get_i32(my_handle, "auto_tmax", &val) == ESP_OK) loaded.auto_tmax = val / 100.0;
+        sched_count = schedule_read_legacy_nvs(my_handle, sched);
+    }
+    nvs_close(my_handle);
+
+    for (int i = 0; i < sched_count; i++) {
+        if (schedule_validate(&sched[i]) != ESP_OK) {
+            ESP_LOGW(TAG, "Horarios en NVS inválidos, se conservan los vigentes");
+            sched_count = -1;
+        }
+    }
+    if (settings_validate(&loaded) != ESP_OK) {
+        ESP_LOGW(TAG, "Configuración en NVS inválida, se usan valores por defecto");
+        settings_get(&loaded);
+    }
+
+    settings_lock();
+    if (sched_count >= 0) schedule_stage(sched, sched_count);
+    publish(&loaded, sched_count >= 0);
+    settings_unlock();
+}
+
+esp_err_t settings_commit(const settings_t *s, const schedule_t *sched, int sched_count)
+{
+    if (sched && (sched_count < 0 || sched_count > SCHEDULE_MAX_WINDOWS)) return ESP_ERR_INVALID_ARG;
+
+    settings_lock();
+
+    // Lo que no cambia se toma con el lock: así no se pisa otra confirmación
+    settings_t cfg;
+    if (s) cfg = *s;
+    else settings_get(&cfg);
+    esp_err_t err = settings_validate(&cfg);
+    for (int i = 0; sched && i < sched_count && err == ESP_OK; i++) err = schedule_validate(&sched[i]);
+    if (err != ESP_OK) {
+        settings_unlock();
+        return err;
+    }
+    const schedule_t *list = sched;
+    int count = sched_count;
+    if (list == NULL) {
+        count = schedule_get(keep, SCHEDULE_MAX_WINDOWS);
+        list = keep;
+    }
+
+    rec = (settings_rec_t){
+        .version = SETTINGS_REC_VERSION,
+        .system_mode = (uint8_t)cfg.system_mode,
+        .manual_pwm = (uint8_t)cfg.manual_pwm,
+        .sched_count = (uint8_t)count,
+        .auto_tmin_cc = (int16_t)lroundf(cfg.auto_tmin * 100),
+        .auto_tmax_cc = (int16_t)lroundf(cfg.auto_tmax * 100),
+    };
+    for (int i = 0; i < count; i++) schedule_to_rec(&list[i], &rec.sched[i]);
+
+    // Un solo blob: NVS escribe cada entrada de forma atómica, así que un
+    // corte de energía deja el registro viejo o el nuevo, nunca una mezcla
+    nvs_handle_t my_handle;
+    err = nvs_open("storage", NVS_READWRITE, &my_handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(my_handle, "settings", &rec, SETTINGS_REC_HEADER + count * sizeof(schedule_rec_t));
+        if (err == ESP_OK) err = nvs_commit(my_handle);
+        nvs_close(my_handle);
+    }
+
+    if (err == ESP_OK) {
+        if (sched) schedule_stage(sched, sched_count);
+        publish(&cfg, sched != NULL);
+    } else {
+        ESP_LOGE(TAG, "No se pudo guardar: %s", esp_err_to_name(err));
+    }
+
+    settings_unlock();
+    return err;
+}
+
+uint32_t settings_get(settings_t *out)
+{
+    taskENTER_CRITICAL(&publish_mux);
+    *out = *current;
+    uint32_t gen = atomic_load(&generation);
+    taskEXIT_CRITICAL(&publish_mux);
+    return gen;
+}
+
+uint32_t settings_generation(void)
+{
+    return atomic_load(&generation);
+}
@@ -0,0 +1,65 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "Schedule.h"
+
+#define SETTINGS_MODE_MANUAL 0
+#define SETTINGS_MODE_AUTO   1
+#define SETTINGS_MODE_PROG   2
+
+#define SETTINGS_TEMP_MIN   -20.0f
+#define SETTINGS_TEMP_MAX    80.0f
+
+// Configuración general del ventilador. Se reemplaza siempre completa y
+// junto con los horarios (Schedule.h): quien la lee nunca ve una mezcla de
+// valores viejos y nuevos.
+typedef struct {
+    int32_t system_mode;    // SETTINGS_MODE_*
+    int32_t manual_pwm;     // 0..100 %
+    float auto_tmin;        // Modo AUTO: 0% a esta temperatura
+    float auto_tmax;        // Modo AUTO: 100% a esta temperatura
+} settings_t;
+
+/**
+ * @brief Comprueba rangos y auto_tmin < auto_tmax.
+ */
+esp_err_t settings_validate(const settings_t *s);
+
+/**
+ * @brief Publica una configuración sin tocar NVS ni los horarios (p. ej. la
+ * copia en RTC).
+ */
+void settings_init(const settings_t *s);
+
+/**
+ * @brief Carga configuración y horarios desde NVS y los publica juntos
+ * (migra las claves sueltas del formato viejo). Lo que no esté o no sea válido queda como está.
+ */
+void settings_load_nvs(void);
+
+/**
+ * @brief Transacción: valida (settings_validate() y schedule_validate() de
+ * cada ventana), escribe configuración y horarios en NVS como
+ * un único registro y recién entonces publica ambos a la vez. Si algo
+ * falla, RAM y NVS quedan como estaban.
+ * @param s Configuración nueva, o NULL para conservar la vigente.
+ * @param sched Horarios nuevos, o NULL para conservar los vigentes.
+ * @param sched_count Cantidad de horarios (0..SCHEDULE_MAX_WINDOWS).
+ */
+esp_err_t settings_commit(const settings_t *s, const schedule_t *sched, int sched_count);
+
+/**
+ * @brief Copia consistente de la configuración vigente.
+ * @return Generación de la copia (para schedule_eval()).
+ */
+uint32_t settings_get(settings_t *out);
+
+/**
+ * @brief Se incrementa en cada publicación; el lazo de control solo vuelve
+ * a leer la configuración cuando cambia.
+ */
+uint32_t settings_generation(void);
+
+#endif // SETTINGS_H
@@ -0,0 +1,23 @@
+#include "StaticMutex.h"
+#include <stddef.h>
+#include "freertos/task.h"
+
+// Un solo spinlock alcanza: solo se toma la primera vez que se usa cada mutex
+static portMUX_TYPE create_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void static_mutex_take(static_mutex_t *m)
+{
+    if (m->handle == NULL) {
+        // Dos tareas pueden llegar juntas al primer uso (httpd, menu, control):
+        // crear el mutex una sola vez dentro de la seccion critica
+        taskENTER_CRITICAL(&create_mux);
+        if (m->handle == NULL) m->handle = xSemaphoreCreateMutexStatic(&m->buf);
+        taskEXIT_CRITICAL(&create_mux);
+    }
+    xSemaphoreTake(m->handle, portMAX_DELAY);
+}
+
+void static_mutex_give(static_mutex_t *m)
+{
+    xSemaphoreGive(m->handle);
+}
@@ -0,0 +1,27 @@
+#ifndef STATIC_MUTEX_H
+#define STATIC_MUTEX_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+/**
+ * @brief Mutex con memoria estatica que se crea en el primer uso.
+ * Declararlo como `static static_mutex_t lock;` (queda en cero).
+ */
+typedef struct {
+    SemaphoreHandle_t handle;
+    StaticSemaphore_t buf;
+} static_mutex_t;
+
+/**
+ * @brief Toma el mutex; lo crea si es la primera vez.
+ * Es seguro aunque varias tareas lleguen a la vez al primer uso.
+ */
+void static_mutex_take(static_mutex_t *m);
+
+/**
+ * @brief Libera un mutex tomado con static_mutex_take.
+ */
+void static_mutex_give(static_mutex_t *m);
+
+#endif // STATIC_MUTEX_H
@@ -1,63 +1,182 @@
 #include "Temp_LM35.h"
+#include <math.h>
+#include <stdio.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_adc/adc_oneshot.h"
-#include "esp_adc/adc_cali.h"
-#include "esp_adc/adc_cali_scheme.h"
 #include "freertos/FreeRTOS.h"
+#include "StaticMutex.h"
 #include "freertos/task.h"
+#include "filtro_adc.h"
+#include "cali_adc.h"
+#include "cali_sensor.h"
+#include "fusion_temp.h"
+#include "salud_sensor.h"
+#include "sdkconfig.h"
 
 static const char *TAG = "LM35";
 
 // --- CONFIGURACIÓN ---
-// Usamos ADC_ATTEN_DB_12 (Rango 0-3.3V) para seguridad y estabilidad
-#define LM35_ATTEN ADC_ATTEN_DB_12
+// El LM35 da 10 mV/°C: a temperatura ambiente son 150-400 mV. Con
+// ADC_ATTEN_DB_12 (0-3.3V) eso usa apenas una décima de las cuentas, así
+// que cada sensor elige la atenuación más baja en la que entra la señal.
+// Rango útil de cada una en el ESP32 (con margen para la calibración):
+static const struct {
+    adc_atten_t atten;
+    int16_t max_mv;
+} ranges[] = {
+    { ADC_ATTEN_DB_0,   900  },     // hasta 90 °C, ~0.23 mV por cuenta
+    { ADC_ATTEN_DB_2_5, 1200 },
+    { ADC_ATTEN_DB_6,   1700 },
+    { ADC_ATTEN_DB_12,  INT16_MAX },
+};
+#define RANGE_COUNT (int)(sizeof(ranges) / sizeof(ranges[0]))
+#define RANGE_TOP   (RANGE_COUNT - 1)
+
+// Para bajar de rango la señal tiene que quedar este margen por debajo del
+// tope del rango inferior (5 °C): cerca del límite no conmuta en cada lectura
+#define LM35_HYST_MV   50
+// Una muestra por encima de esto se toma como saturada
+#define LM35_RAW_SAT   4050
+
+// Plausibilidad de cada lectura (centésimas sin corregir). En el circuito
+// básico el LM35 no baja de 2 °C: 0 mV es el sensor desconectado o en
+// corto a masa; arriba de 150 °C es un corto a VCC o el ADC saturado.
+static const salud_limites_t lm35_limits = {
+    .min = 150,
+    .max = 15000,
+    .paso_min = 50,             // Ruido de una lectura (~10 sigma)
+    .tasa_max = 200,            // 2 °C/s: más de lo que sigue la cápsula
+    .iguales_max = 100,         // 10 s a 10 Hz con el mismo promedio crudo
+    .malas_para_falla = 3,
+    .buenas_para_salir = 20,
+};
+static salud_t sensor_health[LM35_MAX_SENSORES];
 
 static adc_oneshot_unit_handle_t adc1_handle;
-static adc_cali_handle_t adc1_cali_handle = NULL;
+static const cali_adc_tabla_t *cali[RANGE_COUNT];  // Tabla crudo -> mV por atenuación (compartidas)
 static bool adc_initialized = false;
-static bool calibrated = false;
 
-// Variable para el filtro de suavizado
-static float smoothed_temp = -1.0; 
-// Factor de suavizado (0.1 = Lento y estable, 0.5 = Rápido)
-#define FILTER_ALPHA 0.10f 
+// Canal ADC de cada sensor (-1 = no configurado)
+static int8_t sensor_channel[LM35_MAX_SENSORES] = { LM35_ADC_CHANNEL, -1, -1, -1, -1, -1, -1, -1 };
+// Rango actual de cada sensor: arranca arriba (nunca satura) y baja solo
+static uint8_t sensor_range[LM35_MAX_SENSORES];
+
+// Promedio lento de la lectura sin corregir (centésimas de grado): solo
+// sirve para capturar puntos de calibración estables
+static filtro_ema_t temp_ema[LM35_MAX_SENSORES];
+static int32_t last_raw_cc[LM35_MAX_SENSORES];
+static bool has_reading[LM35_MAX_SENSORES];
+
+// Calibración de cada sensor (NVS "lm35_<n>") y puntos en captura
+static cali_lineal_t sensor_cal[LM35_MAX_SENSORES];
+static cali_puntos_t cal_points[LM35_MAX_SENSORES];
 
-// --- FUNCIÓN QUE CARGA LA CALIBRACIÓN DE FÁBRICA ---
-static bool adc_calibration_init(adc_unit_t unit, adc_atten_t atten, adc_cali_handle_t *out_handle)
+static static_mutex_t cal_mutex;
+
+static void cal_lock(void)
 {
-    adc_cali_handle_t handle = NULL;
-    esp_err_t ret = ESP_FAIL;
-    bool cal_success = false;
-
-    // Intenta calibración por Curva (Mejor precisión)
-#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
-    if (!cal_success) {
-        adc_cali_curve_fitting_config_t cali_config = {
-            .unit_id = unit, .atten = atten, .bitwidth = ADC_BITWIDTH_DEFAULT,
-        };
-        ret = adc_cali_create_scheme_curve_fitting(&cali_config, &handle);
-        if (ret == ESP_OK) cal_success = true;
-    }
+    static_mutex_take(&cal_mutex);
+}
+
+static void cal_unlock(void)
+{
+    static_mutex_give(&cal_mutex);
+}
+
+static void cal_key(int index, char *key, size_t size)
+{
+    snprintf(key, size, "lm35_%d", index);
+}
+// Factor del promedio de captura en Q8 (26/256 ~ 0.10)
+#define FILTER_ALPHA_Q8 26
+
+// --- FUSIÓN (componente fusion_temp) ---
+// La salida de cada sensor es un Kalman escalar: el LM35 (ya calibrado) y,
+// si tiene, un NTC al lado (temp_sensor_add_ntc) son mediciones del mismo
+// estado. El ruido de cada fuente se aprende solo y la varianza del estado
+// es la confianza de la lectura (temp_sensor_get_sigma).
+// Ruido de proceso (cc²/s): lo que la temperatura se aparta en un segundo
+// de su pendiente, ~0.015 °C. La pendiente de una rampa la sigue el propio
+// filtro, y un cambio más brusco también lo detecta él (fusion_temp).
+#define FUSION_Q_CC2_S  2
+#define FUSION_R_INICIAL 100    // cc² (0.1 °C) hasta aprender el de la fuente
+
+static fusion_t temp_fusion[LM35_MAX_SENSORES];
+static int8_t src_lm35[LM35_MAX_SENSORES];
+static int64_t last_read_us[LM35_MAX_SENSORES];
+
+// NTC opcional: VCC—NTC_R_FIXED—nodo (ADC)—NTC—GND, modelo Beta nominal.
+// Su error absoluto no importa: el offset contra el LM35 calibrado se
+// sigue despacio y se descuenta, así que solo aporta su bajo ruido.
+#define NTC_VCC_MV      3300
+#define NTC_R_FIXED     10000.0f
+#define NTC_R0          10000.0f    // A 25 °C
+#define NTC_T0_K        298.15f
+#define NTC_BETA        3950.0f
+#define NTC_MUESTRAS    8
+#define NTC_OFFSET_LOG2 8           // Peso 1/256 por lectura en el offset
+
+static int8_t ntc_channel[LM35_MAX_SENSORES] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+static int8_t src_ntc[LM35_MAX_SENSORES];
+static bool ntc_aligned[LM35_MAX_SENSORES];
+static int32_t ntc_offset_q8[LM35_MAX_SENSORES];    // NTC - LM35 en cc * 256
+
+// Muestras por lectura: grupos de 5 -> mediana (quita picos del WiFi).
+// Con autorrango la cuenta es ~3.4 veces más fina en el rango de 0 dB y
+// alcanzan muchas menos muestras para el mismo ruido de cuantización; el
+// Kalman hace el resto del promedio entre lecturas.
+#if CONFIG_VENT_LM35_AUTORANGE
+#define LM35_MUESTRAS 10
+#else
+#define LM35_MUESTRAS 30
 #endif
+#define LM35_GRUPO    5
 
-    // Si no, intenta calibración Lineal
-#if ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
-    if (!cal_success) {
-        adc_cali_line_fitting_config_t cali_config = {
-            .unit_id = unit, .atten = atten, .bitwidth = ADC_BITWIDTH_DEFAULT,
-        };
-        ret = adc_cali_create_scheme_line_fitting(&cali_config, &handle);
-        if (ret == ESP_OK) cal_success = true;
+// Tabla de calibración del rango (se arma la primera vez que se usa)
+static const cali_adc_tabla_t *range_cali(int r)
+{
+    if (cali[r] == NULL) {
+        cali[r] = cali_adc_obtener(ADC_UNIT_1, ranges[r].atten);
+        if (cali[r] == NULL || !cali[r]->calibrada) {
+            ESP_LOGW(TAG, "Atenuación %d sin calibración, usando modo crudo", ranges[r].atten);
+        }
     }
-#endif
+    return cali[r];
+}
+
+static esp_err_t set_range(int index, int r)
+{
+    adc_oneshot_chan_cfg_t config = {
+        .bitwidth = ADC_BITWIDTH_DEFAULT,
+        .atten = ranges[r].atten,
+    };
+    esp_err_t err = adc_oneshot_config_channel(adc1_handle, sensor_channel[index], &config);
+    if (err == ESP_OK) sensor_range[index] = r;
+    return err;
+}
 
-    *out_handle = handle;
-    if (cal_success) {
-        ESP_LOGI(TAG, "Calibración de fábrica cargada correctamente");
-    } else {
-        ESP_LOGW(TAG, "No se encontró calibración, usando modo crudo");
+#if CONFIG_VENT_LM35_AUTORANGE
+// Rango más bajo en el que entra 'mv' con el margen de histéresis; nunca
+// por encima de 'current' (subir lo decide la saturación o el tope).
+// Sin tabla de calibración un rango no se usa.
+static int lowest_range(int mv, int current)
+{
+    for (int r = 0; r < current; r++) {
+        if (mv < ranges[r].max_mv - LM35_HYST_MV && range_cali(r) != NULL) return r;
     }
-    return cal_success;
+    return current;
+}
+#endif
+
+static void filters_init(int index)
+{
+    filtro_ema_init(&temp_ema[index], FILTER_ALPHA_Q8);
+    fusion_init(&temp_fusion[index], FUSION_Q_CC2_S);
+    src_lm35[index] = fusion_agregar_fuente(&temp_fusion[index], FUSION_R_INICIAL);
+    src_ntc[index] = -1;
+    last_read_us[index] = 0;
+    salud_init(&sensor_health[index]);
 }
 
 void temp_sensor_init(void) {
@@ -70,57 +189,299 @@ void temp_sensor_init(void) {
     };
     ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config1, &adc1_handle));
 
-    // 2. Configurar Canal
+    // 2. Configurar Canal en el rango completo
+    ESP_ERROR_CHECK(set_range(0, RANGE_TOP));
+
+    // 3. Calibración del chip, evaluada una sola vez en una tabla. La de
+    // cada sensor queda en identidad hasta temp_sensor_load_calibration()
+    range_cali(RANGE_TOP);
+    for (int i = 0; i < LM35_MAX_SENSORES; i++) sensor_cal[i] = CALI_LINEAL_IDENTIDAD;
+    filters_init(0);
+
+    adc_initialized = true;
+}
+
+esp_err_t temp_sensor_add_channel(int index, adc_channel_t channel) {
+    if (index <= 0 || index >= LM35_MAX_SENSORES) return ESP_ERR_INVALID_ARG;
+    if (!adc_initialized) temp_sensor_init();
+
+    int8_t prev = sensor_channel[index];
+    sensor_channel[index] = channel;
+    esp_err_t err = set_range(index, RANGE_TOP);
+    if (err != ESP_OK) {
+        sensor_channel[index] = prev;
+        return err;
+    }
+
+    filters_init(index);
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_add_ntc(int index, adc_channel_t channel) {
+    if (index < 0 || index >= LM35_MAX_SENSORES) return ESP_ERR_INVALID_ARG;
+    if (!adc_initialized) temp_sensor_init();
+    if (sensor_channel[index] < 0 || src_ntc[index] >= 0) return ESP_ERR_INVALID_STATE;
+
+    // El divisor usa casi todo el rango: siempre en 12 dB
     adc_oneshot_chan_cfg_t config = {
         .bitwidth = ADC_BITWIDTH_DEFAULT,
-        .atten = LM35_ATTEN,
+        .atten = ranges[RANGE_TOP].atten,
     };
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, LM35_ADC_CHANNEL, &config));
-
-    // 3. Cargar datos de calibración del chip
-    calibrated = adc_calibration_init(ADC_UNIT_1, LM35_ATTEN, &adc1_cali_handle);
+    esp_err_t err = adc_oneshot_config_channel(adc1_handle, channel, &config);
+    if (err != ESP_OK) return err;
 
-    adc_initialized = true;
+    int src = fusion_agregar_fuente(&temp_fusion[index], FUSION_R_INICIAL);
+    if (src < 0) return ESP_ERR_NO_MEM;
+    ntc_channel[index] = channel;
+    src_ntc[index] = src;
+    ntc_aligned[index] = false;
+    ESP_LOGI(TAG, "Sensor %d: NTC en canal %d como segunda fuente", index, channel);
+    return ESP_OK;
 }
 
 float temp_sensor_read_celsius(void) {
-    if (!adc_initialized) temp_sensor_init();
+    return temp_sensor_read_channel_celsius(0);
+}
 
+// Promedio en cuentas * 16 (4 bits de fracción); 'saturated' si alguna
+// muestra tocó el tope del rango
+static esp_err_t acquire_q4(int index, int32_t *avg_q4, bool *saturated)
+{
     int raw_val;
-    int voltage_mv = 0;
-    long sum_raw = 0;
-    int samples = 64; 
-
-    // 1. Tomar muchas muestras
-    for (int i = 0; i < samples; i++) {
-        ESP_ERROR_CHECK(adc_oneshot_read(adc1_handle, LM35_ADC_CHANNEL, &raw_val));
-        sum_raw += raw_val;
+    int32_t muestras[LM35_MUESTRAS];
+    int32_t medianas[LM35_MUESTRAS / LM35_GRUPO];
+
+    *saturated = false;
+    for (int i = 0; i < LM35_MUESTRAS; i++) {
+        esp_err_t err = adc_oneshot_read(adc1_handle, sensor_channel[index], &raw_val);
+        if (err != ESP_OK) return err;
+        if (raw_val >= LM35_RAW_SAT) *saturated = true;
+        muestras[i] = raw_val * 16;
         // Espera un poco más larga para que el capacitor se cargue bien
-        esp_rom_delay_us(60); 
+        esp_rom_delay_us(60);
+    }
+
+    // Mediana por grupos y media recortada: un pico aislado no mueve el promedio
+    size_t n_med = filtro_mediana_decimar(muestras, LM35_MUESTRAS, LM35_GRUPO, medianas);
+    *avg_q4 = filtro_media_recortada(medianas, n_med, n_med / 4);
+    return ESP_OK;
+}
+
+// Temperatura del NTC en centésimas con el modelo Beta; false si el divisor
+// da un extremo (NTC abierto o en corto)
+static bool read_ntc_cc(int index, int32_t *out_cc)
+{
+    int raw_val;
+    int32_t muestras[NTC_MUESTRAS];
+
+    for (int i = 0; i < NTC_MUESTRAS; i++) {
+        if (adc_oneshot_read(adc1_handle, ntc_channel[index], &raw_val) != ESP_OK) return false;
+        muestras[i] = raw_val * 16;
+    }
+    int32_t avg_q4 = filtro_media_recortada(muestras, NTC_MUESTRAS, NTC_MUESTRAS / 4);
+
+    const cali_adc_tabla_t *t = range_cali(RANGE_TOP);
+    int32_t mv_q4 = (t != NULL) ? cali_adc_mv_q4(t, avg_q4) : avg_q4 * NTC_VCC_MV / 4095;
+    float mv = mv_q4 / 16.0f;
+    if (mv <= 0.0f || mv >= NTC_VCC_MV) return false;
+
+    float r_ntc = NTC_R_FIXED * mv / (NTC_VCC_MV - mv);
+    float inv_t = 1.0f / NTC_T0_K + logf(r_ntc / NTC_R0) / NTC_BETA;
+    *out_cc = lroundf((1.0f / inv_t - 273.15f) * 100.0f);
+    return true;
+}
+
+float temp_sensor_read_channel_celsius(int index) {
+    if (!adc_initialized) temp_sensor_init();
+    if (index < 0 || index >= LM35_MAX_SENSORES || sensor_channel[index] < 0) return NAN;
+
+    fusion_t *f = &temp_fusion[index];
+    salud_t *health = &sensor_health[index];
+    bool was_faulty = health->en_falla;
+    int64_t now = esp_timer_get_time();
+    uint32_t dt_ms = (last_read_us[index] != 0) ? (uint32_t)((now - last_read_us[index]) / 1000) : 0;
+    last_read_us[index] = now;
+    fusion_predecir(f, dt_ms);
+
+    int32_t avg_q4 = 0, mv_q4 = 0;
+    esp_err_t err = ESP_OK;
+    // Como mucho dos adquisiciones: si satura se repite en el rango completo
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int r = sensor_range[index];
+        bool saturated;
+
+        // 1. Tomar las muestras en el rango actual
+        err = acquire_q4(index, &avg_q4, &saturated);
+        if (err != ESP_OK) break;
+
+        // 2. CONVERTIR A VOLTAJE (Milivoltios * 16)
+        const cali_adc_tabla_t *t = range_cali(r);
+        if (t != NULL) {
+            // Tabla armada con la curva de eFuse (o la nominal si el chip no la tiene)
+            mv_q4 = cali_adc_mv_q4(t, avg_q4);
+        } else {
+            // Fallback manual solo si no quedó lugar para la tabla (solo
+            // pasa en el rango completo: a los otros no se baja sin tabla)
+            mv_q4 = avg_q4 * 3300 / 4095;
+        }
+
+#if CONFIG_VENT_LM35_AUTORANGE
+        int mv = mv_q4 / 16;
+        if ((saturated || mv > ranges[r].max_mv) && r < RANGE_TOP) {
+            // Fuera de rango: la lectura no sirve, se repite con todo el rango
+            if (set_range(index, RANGE_TOP) != ESP_OK) break;
+            ESP_LOGD(TAG, "Sensor %d: %d mV, sube al rango completo", index, mv);
+            continue;
+        }
+        int lower = lowest_range(mv, r);
+        if (lower < r && set_range(index, lower) == ESP_OK) {
+            // La lectura actual vale; la próxima ya usa el rango más fino
+            ESP_LOGD(TAG, "Sensor %d: %d mV, baja a atenuación %d", index, mv, ranges[lower].atten);
+        }
+#endif
+        break;
+    }
+
+    // 3. CONVERTIR A CENTÉSIMAS DE GRADO (10 mV/°C -> 1 mV = 10 centésimas)
+    int32_t temp_cc = (mv_q4 * 10 + 8) / 16;
+
+    // 4. PLAUSIBILIDAD: una lectura mala no entra a ningún filtro
+    bool lm35_ok = false;
+    int32_t cal_cc = 0;
+    if (err != ESP_OK) {
+        salud_error(health, &lm35_limits);
+    } else if (salud_evaluar(health, &lm35_limits, temp_cc, avg_q4, dt_ms) == SALUD_OK) {
+        lm35_ok = true;
+
+        // 5. PROMEDIO DE CAPTURA (sin corregir)
+        int32_t filtered_cc = filtro_ema_actualizar(&temp_ema[index], temp_cc);
+
+        // 6. CALIBRACIÓN DEL SENSOR (ganancia y offset contra un termómetro patrón)
+        cal_lock();
+        last_raw_cc[index] = filtered_cc;
+        has_reading[index] = true;
+        cal_cc = cali_lineal_aplicar(&sensor_cal[index], temp_cc);
+        cal_unlock();
+
+        // 7. FUSIÓN
+        fusion_medir(f, src_lm35[index], cal_cc);
+    }
+    if (health->en_falla != was_faulty) {
+        if (health->en_falla) ESP_LOGE(TAG, "Sensor %d en falla (%s)", index, salud_falla_str(health->motivo));
+        else ESP_LOGI(TAG, "Sensor %d recuperado", index);
     }
-    int avg_raw = sum_raw / samples;
-
-    // 2. CONVERTIR A VOLTAJE (Milivoltios)
-    if (calibrated) {
-        // Esta función corrige la curva y debería arreglar el problema de los 5 grados
-        ESP_ERROR_CHECK(adc_cali_raw_to_voltage(adc1_cali_handle, avg_raw, &voltage_mv));
-    } else {
-        // Fallback manual solo si falla la calibración
-        voltage_mv = avg_raw * 3300 / 4095;
+
+    // El NTC sigue midiendo con el LM35 en falla; su offset solo se
+    // actualiza con una lectura buena del LM35
+    bool ntc_ok = false;
+    int32_t ntc_cc;
+    if (src_ntc[index] >= 0 && (lm35_ok || ntc_aligned[index]) && read_ntc_cc(index, &ntc_cc)) {
+        if (lm35_ok) {
+            int32_t diff_q8 = (ntc_cc - cal_cc) * 256;
+            if (!ntc_aligned[index]) {
+                ntc_offset_q8[index] = diff_q8;
+                ntc_aligned[index] = true;
+            } else {
+                ntc_offset_q8[index] += (diff_q8 - ntc_offset_q8[index]) >> NTC_OFFSET_LOG2;
+            }
+        }
+        fusion_medir(f, src_ntc[index], ntc_cc - ((ntc_offset_q8[index] + 128) >> 8));
+        ntc_ok = true;
     }
 
-    // 3. CONVERTIR A GRADOS
-    float current_temp = (float)voltage_mv / 10.0f;
+    if (!f->iniciado || (health->en_falla && !ntc_ok)) return NAN;
+    return fusion_valor_cc(f) / 100.0f;
+}
 
-    // 4. OFFSET MANUAL DE EMERGENCIA (Si sigue bajo, descomenta la línea de abajo)
-    // current_temp += 3.0; // Sumar 3 grados si ves que siempre le falta un poco
+bool temp_sensor_has_fault(int index) {
+    if (index < 0 || index >= LM35_MAX_SENSORES || sensor_channel[index] < 0) return false;
+    return sensor_health[index].en_falla;
+}
+
+const char *temp_sensor_fault_str(int index) {
+    if (!temp_sensor_has_fault(index)) return salud_falla_str(SALUD_OK);
+    return salud_falla_str(sensor_health[index].motivo);
+}
 
-    // 5. FILTRO DE SUAVIZADO
-    if (smoothed_temp < 0) {
-        smoothed_temp = current_temp;
-    } else {
-        smoothed_temp = (current_temp * FILTER_ALPHA) + (smoothed_temp * (1.0f - FILTER_ALPHA));
+float temp_sensor_get_sigma(int index) {
+    if (index < 0 || index >= LM35_MAX_SENSORES || sensor_channel[index] < 0) return 0;
+    return fusion_desvio_cc(&temp_fusion[index]) / 100.0f;
+}
+
+void temp_sensor_load_calibration(void) {
+    if (!adc_initialized) temp_sensor_init();
+    for (int i = 0; i < LM35_MAX_SENSORES; i++) {
+        char key[12];
+        cali_lineal_t c;
+        cal_key(i, key, sizeof(key));
+        if (cali_sensor_cargar(key, &c, sizeof(c)) != ESP_OK) continue;
+        cal_lock();
+        sensor_cal[i] = c;
+        cal_unlock();
+        ESP_LOGI(TAG, "Sensor %d calibrado: x%.4f %+.2f °C", i, c.ganancia_q16 / 65536.0, c.offset / 100.0);
     }
+}
+
+esp_err_t temp_sensor_cal_add_point(int index, float ref_c, float *raw_c) {
+    if (index < 0 || index >= LM35_MAX_SENSORES || sensor_channel[index] < 0) return ESP_ERR_INVALID_ARG;
+    if (!(ref_c >= -55.0f && ref_c <= 150.0f)) return ESP_ERR_INVALID_ARG;  // Rango del LM35
+
+    cal_lock();
+    esp_err_t err = ESP_ERR_INVALID_STATE;   // Sin lecturas todavía
+    if (has_reading[index]) {
+        float raw = last_raw_cc[index] / 100.0f;
+        err = cali_puntos_agregar(&cal_points[index], raw, ref_c);
+        if (raw_c != NULL) *raw_c = raw;
+    }
+    cal_unlock();
+    return err;
+}
+
+esp_err_t temp_sensor_cal_fit(int index, float *err_max_c) {
+    if (index < 0 || index >= LM35_MAX_SENSORES || sensor_channel[index] < 0) return ESP_ERR_INVALID_ARG;
+
+    cali_lineal_t c;
+    cal_lock();
+    esp_err_t err = cali_lineal_ajustar(&cal_points[index], 100, &c, err_max_c);
+    cal_unlock();
+    if (err != ESP_OK) return err;
+
+    char key[12];
+    cal_key(index, key, sizeof(key));
+    err = cali_sensor_guardar(key, &c, sizeof(c));
+    if (err != ESP_OK) return err;
+
+    cal_lock();
+    sensor_cal[index] = c;
+    cali_puntos_limpiar(&cal_points[index]);
+    cal_unlock();
+    ESP_LOGI(TAG, "Sensor %d calibrado: x%.4f %+.2f °C", index, c.ganancia_q16 / 65536.0, c.offset / 100.0);
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_cal_reset(int index) {
+    if (index < 0 || index >= LM35_MAX_SENSORES) return ESP_ERR_INVALID_ARG;
+
+    char key[12];
+    cal_key(index, key, sizeof(key));
+    esp_err_t err = cali_sensor_borrar(key);
+    if (err != ESP_OK) return err;
+
+    cal_lock();
+    sensor_cal[index] = CALI_LINEAL_IDENTIDAD;
+    cali_puntos_limpiar(&cal_points[index]);
+    cal_unlock();
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_cal_get(int index, temp_sensor_cal_info_t *out) {
+    if (index < 0 || index >= LM35_MAX_SENSORES || sensor_channel[index] < 0) return ESP_ERR_INVALID_ARG;
 
-    return smoothed_temp;
+    cal_lock();
+    out->gain = sensor_cal[index].ganancia_q16 / 65536.0f;
+    out->offset_c = sensor_cal[index].offset / 100.0f;
+    out->points = cal_points[index].n;
+    out->raw_c = has_reading[index] ? last_raw_cc[index] / 100.0f : 0.0f;
+    cal_unlock();
+    return ESP_OK;
 }
\ No newline at end of file
@@ -8,7 +8,58 @@
 // En ESP32, GPIO 35 es ADC1 Canal 6
 #define LM35_ADC_CHANNEL ADC_CHANNEL_7 
 
+// Sensores adicionales (zonas), todos en ADC1 (el ADC2 lo usa el WiFi)
+#define LM35_MAX_SENSORES 8
+
 void temp_sensor_init(void);
 float temp_sensor_read_celsius(void);
 
+// index 0 es LM35_ADC_CHANNEL; cada sensor tiene su propio filtro.
+// Devuelve NAN con el sensor en falla (ver temp_sensor_has_fault)
+esp_err_t temp_sensor_add_channel(int index, adc_channel_t channel);
+float temp_sensor_read_channel_celsius(int index);
+
+// NTC de 10k (Beta 3950, 10k fijo a VCC) junto al sensor 'index': se fusiona
+// con el LM35 en cada lectura (componente fusion_temp)
+esp_err_t temp_sensor_add_ntc(int index, adc_channel_t channel);
+
+// Desvío estándar estimado de la última lectura del sensor, en °C
+float temp_sensor_get_sigma(int index);
+
+// --- SALUD DEL SENSOR (componente salud_sensor) ---
+// Cada lectura pasa pruebas de rango (abierto, en corto), valor trabado y
+// velocidad de cambio. La falla se declara con 3 lecturas malas seguidas y
+// se levanta con 20 buenas; mientras dura, la lectura es NAN salvo que un
+// NTC fusionado siga midiendo.
+bool temp_sensor_has_fault(int index);
+
+// Motivo de la falla vigente ("ok" sin falla)
+const char *temp_sensor_fault_str(int index);
+
+// --- CALIBRACIÓN POR SENSOR (componente cali_sensor) ---
+// Con el sensor y un termómetro patrón a la misma temperatura se captura
+// un punto (lectura sin corregir + referencia); con 2 o más, el ajuste da
+// ganancia y offset, se guarda en NVS y se aplica a cada lectura.
+
+typedef struct {
+    float gain;
+    float offset_c;
+    int points;         // Puntos capturados sin ajustar todavía
+    float raw_c;        // Última lectura sin corregir
+} temp_sensor_cal_info_t;
+
+// Carga las calibraciones guardadas (necesita la NVS ya iniciada)
+void temp_sensor_load_calibration(void);
+
+// ESP_ERR_INVALID_STATE si el sensor todavía no tiene lecturas
+esp_err_t temp_sensor_cal_add_point(int index, float ref_c, float *raw_c);
+
+// Ajusta con los puntos capturados, guarda y aplica (los puntos se descartan)
+esp_err_t temp_sensor_cal_fit(int index, float *err_max_c);
+
+// Vuelve a la lectura sin corregir y borra lo guardado
+esp_err_t temp_sensor_cal_reset(int index);
+
+esp_err_t temp_sensor_cal_get(int index, temp_sensor_cal_info_t *out);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "TimeSync.h"
+#include <stdlib.h>
+#include <sys/time.h>
+#include "esp_log.h"
+#include "esp_sntp.h"
+#include "nvs.h"
+#include "wifi_app.h"
+
+static const char *TAG = "TIME_SYNC";
+
+// Cualquier hora anterior a 2016 se considera "sin hora"
+#define VALID_EPOCH_MIN 1451606400
+
+static volatile time_sync_state_e state = TIME_SYNC_NONE;
+static volatile time_t last_sync = 0;
+static bool sntp_started = false;
+
+// Corre en el contexto de lwIP: solo anota y avisa a la tarea WiFi
+static void time_sync_notification_cb(struct timeval *tv)
+{
+    last_sync = tv->tv_sec;
+    sntp_sync_status_t status = sntp_get_sync_status();
+    state = (status == SNTP_SYNC_STATUS_IN_PROGRESS) ? TIME_SYNC_ADJUSTING : TIME_SYNC_OK;
+    // Primera sincronización hecha de golpe: desde ahora las correcciones
+    // pequeñas van con adjtime() sin saltos
+    if (status == SNTP_SYNC_STATUS_COMPLETED && sntp_get_sync_mode() == SNTP_SYNC_MODE_IMMED) {
+        sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+    }
+    wifi_app_send_message_from_cb(WIFI_APP_MSG_TIME_SYNCED);
+}
+
+void time_sync_init(void)
+{
+    setenv("TZ", TIME_SYNC_TZ, 1);
+    tzset();
+
+    if (time(NULL) >= VALID_EPOCH_MIN) return; // Ya hay hora (p. ej. reset por software)
+
+    nvs_handle_t my_handle;
+    if (nvs_open("storage", NVS_READONLY, &my_handle) == ESP_OK) {
+        int64_t saved = 0;
+        if (nvs_get_i64(my_handle, "last_time", &saved) == ESP_OK && saved >= VALID_EPOCH_MIN) {
+            struct timeval tv = { .tv_sec = saved, .tv_usec = 0 };
+            settimeofday(&tv, NULL);
+            state = TIME_SYNC_RESTORED;
+            ESP_LOGI(TAG, "Hora restaurada de NVS (%lld)", (long long)saved);
+        }
+        nvs_close(my_handle);
+    }
+}
+
+void time_sync_start(void)
+{
+    if (sntp_started) {
+        esp_sntp_restart();
+        return;
+    }
+
+    ESP_LOGI(TAG, "Inicializando SNTP...");
+    esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    esp_sntp_setservername(0, TIME_SYNC_SERVER);
+    // La primera vez de golpe: la hora restaurada de NVS puede estar muy
+    // atrasada y en modo suave adjtime() tardaría horas en corregirla (los
+    // horarios PROG correrían con la hora mala todo ese tiempo). El callback
+    // pasa a modo suave después de la primera sincronización.
+    sntp_set_sync_mode(SNTP_SYNC_MODE_IMMED);
+    sntp_set_time_sync_notification_cb(time_sync_notification_cb);
+    esp_sntp_init();
+    sntp_started = true;
+}
+
+void time_sync_persist(void)
+{
+    nvs_handle_t my_handle;
+    if (nvs_open("storage", NVS_READWRITE, &my_handle) == ESP_OK) {
+        nvs_set_i64(my_handle, "last_time", (int64_t)time(NULL));
+        nvs_commit(my_handle);
+        nvs_close(my_handle);
+    }
+    ESP_LOGI(TAG, "Hora sincronizada (%s)", time_sync_state_str());
+}
+
+time_sync_state_e time_sync_get_state(void)
+{
+    // En modo suave no hay callback al terminar el ajuste: se consulta adjtime()
+    if (state == TIME_SYNC_ADJUSTING) {
+        struct timeval pending;
+        if (adjtime(NULL, &pending) == 0 && pending.tv_sec == 0 && pending.tv_usec == 0) {
+            state = TIME_SYNC_OK;
+        }
+    }
+    return state;
+}
+
+const char *time_sync_state_str(void)
+{
+    switch (time_sync_get_state()) {
+        case TIME_SYNC_RESTORED:  return "nvs";
+        case TIME_SYNC_ADJUSTING: return "ajustando";
+        case TIME_SYNC_OK:        return "ok";
+        default:                  return "sin_hora";
+    }
+}
+
+time_t time_sync_last_sync(void)
+{
+    return last_sync;
+}
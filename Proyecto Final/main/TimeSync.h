@@ -0,0 +1,45 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <stdbool.h>
+#include <time.h>
+
+// Zona horaria del sistema (UTC-5)
+#define TIME_SYNC_TZ      "EST5"
+#define TIME_SYNC_SERVER  "pool.ntp.org"
+
+typedef enum {
+    TIME_SYNC_NONE = 0,     // Reloj sin referencia (1970)
+    TIME_SYNC_RESTORED,     // Última hora conocida leída de NVS
+    TIME_SYNC_ADJUSTING,    // SNTP respondió y el reloj se está ajustando suave
+    TIME_SYNC_OK,           // Sincronizado con SNTP
+} time_sync_state_e;
+
+/**
+ * @brief Configura la zona horaria y, si el reloj no tiene hora válida,
+ * restaura la última hora conocida guardada en NVS. No bloquea.
+ */
+void time_sync_init(void);
+
+/**
+ * @brief Arranca (o reinicia tras reconectar) el cliente SNTP: la primera
+ * sincronización fija la hora de golpe y las siguientes la ajustan suave.
+ * Retorna de inmediato; la hora llega por callback.
+ */
+void time_sync_start(void);
+
+/**
+ * @brief Guarda la hora actual en NVS. La llama la tarea WiFi al recibir
+ * WIFI_APP_MSG_TIME_SYNCED (nunca desde el callback de lwIP).
+ */
+void time_sync_persist(void);
+
+time_sync_state_e time_sync_get_state(void);
+const char *time_sync_state_str(void);
+
+/**
+ * @brief Hora de la última sincronización SNTP (0 si nunca).
+ */
+time_t time_sync_last_sync(void);
+
+#endif // TIME_SYNC_H
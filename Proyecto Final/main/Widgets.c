@@ -0,0 +1,227 @@
+#include "Widgets.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "Display.h"
+
+#define SPARK_HEIGHT 16         // Dos páginas
+#define BAR_EDGE     0x7E       // Columna de borde o llena (filas 1..6)
+#define BAR_EMPTY    0x42       // Solo el marco de arriba y abajo
+
+// La curva ocupa una columna del panel por muestra
+_Static_assert(SPARK_WIDTH <= OLED_WIDTH, "La curva no entra en el ancho del display");
+
+// Columnas del candado (bit 0 arriba): arco y cuerpo con el ojo de la llave
+static const uint8_t lock_closed[8] = { 0xF8, 0xFE, 0xF9, 0xD9, 0xD9, 0xF9, 0xFE, 0xF8 };
+static const uint8_t lock_open[8]   = { 0xF8, 0xFE, 0xF9, 0xD9, 0xD9, 0xF9, 0xFA, 0xF8 };
+// Triángulo de advertencia con el signo "!" calado
+static const uint8_t warning[8]     = { 0x60, 0x78, 0x7E, 0x51, 0x51, 0x7E, 0x78, 0x60 };
+
+// Anillo de muestras en décimas de °C: 'head' es la próxima a escribir
+static int16_t ring[SPARK_WIDTH];
+static uint8_t head;
+static uint16_t count;
+static uint32_t pushed;         // Muestras guardadas desde el arranque
+
+// Promedio de las lecturas del período en curso
+static int32_t acc_sum;
+static uint16_t acc_n;
+static int64_t acc_start_us;
+
+// Lo que ya está en el cuadro
+static struct {
+    bool valid;
+    uint32_t pushed;
+    int16_t lo, hi;             // Escala en °C
+    int8_t last_y;
+} spark;
+
+static struct {
+    bool valid;
+    int x, page, width, fill;
+} bar;
+
+static struct {
+    bool valid;
+    int x, page;
+    bool locked;
+} lock;
+
+static struct {
+    bool valid;
+    int x, page;
+    bool shown;
+} warn;
+
+void widgets_invalidate(void)
+{
+    spark.valid = false;
+    bar.valid = false;
+    lock.valid = false;
+    warn.valid = false;
+}
+
+void widget_lock_icon(int x, int page, bool locked)
+{
+    if (lock.valid && lock.x == x && lock.page == page && lock.locked == locked) return;
+    uint8_t *row = display_page_buffer(page);
+    if (row == NULL || x < 0 || x + 8 > OLED_WIDTH) return;
+    memcpy(row + x, locked ? lock_closed : lock_open, 8);
+    lock.valid = true;
+    lock.x = x;
+    lock.page = page;
+    lock.locked = locked;
+}
+
+void widget_warning_icon(int x, int page, bool shown)
+{
+    if (warn.valid && warn.x == x && warn.page == page && warn.shown == shown) return;
+    uint8_t *row = display_page_buffer(page);
+    if (row == NULL || x < 0 || x + 8 > OLED_WIDTH) return;
+    if (shown) memcpy(row + x, warning, 8);
+    else memset(row + x, 0, 8);
+    warn.valid = true;
+    warn.x = x;
+    warn.page = page;
+    warn.shown = shown;
+}
+
+void widget_bar(int x, int page, int width, int percent)
+{
+    uint8_t *row = display_page_buffer(page);
+    if (row == NULL || x < 0 || width < 3 || x + width > OLED_WIDTH) return;
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    int inner = width - 2;
+    int fill = percent * inner / 100;
+
+    if (!bar.valid || bar.x != x || bar.page != page || bar.width != width) {
+        row[x] = BAR_EDGE;
+        row[x + width - 1] = BAR_EDGE;
+        for (int i = 0; i < inner; i++) row[x + 1 + i] = (i < fill) ? BAR_EDGE : BAR_EMPTY;
+    } else if (fill > bar.fill) {
+        memset(row + x + 1 + bar.fill, BAR_EDGE, fill - bar.fill);
+    } else if (fill < bar.fill) {
+        memset(row + x + 1 + fill, BAR_EMPTY, bar.fill - fill);
+    }
+    bar.valid = true;
+    bar.x = x;
+    bar.page = page;
+    bar.width = width;
+    bar.fill = fill;
+}
+
+static void ring_push(int16_t v)
+{
+    ring[head] = v;
+    head = (head + 1) % SPARK_WIDTH;
+    if (count < SPARK_WIDTH) count++;
+    pushed++;
+}
+
+void widget_spark_feed(float temp)
+{
+    if (isnan(temp)) return;
+    float t = temp * 10.0f;
+    if (t > INT16_MAX) t = INT16_MAX;
+    if (t < INT16_MIN) t = INT16_MIN;
+    int16_t v = (int16_t)lroundf(t);
+    int64_t now = esp_timer_get_time();
+
+    // La primera lectura entra enseguida: el gráfico no arranca vacío
+    if (count == 0) {
+        ring_push(v);
+        acc_start_us = now;
+        return;
+    }
+
+    acc_sum += v;
+    acc_n++;
+    if (now - acc_start_us >= (int64_t)SPARK_SAMPLE_MS * 1000) {
+        ring_push((int16_t)(acc_sum / acc_n));
+        acc_sum = 0;
+        acc_n = 0;
+        acc_start_us = now;
+    }
+}
+
+// Escala en grados enteros que contiene todas las muestras
+static void spark_scale(int16_t *lo, int16_t *hi)
+{
+    int16_t min = INT16_MAX, max = INT16_MIN;
+    for (int i = 0; i < count; i++) {
+        if (ring[i] < min) min = ring[i];
+        if (ring[i] > max) max = ring[i];
+    }
+    *lo = (int16_t)floorf(min / 10.0f);
+    *hi = (int16_t)ceilf(max / 10.0f);
+    if (*hi - *lo < SPARK_MIN_SPAN) *hi = *lo + SPARK_MIN_SPAN;
+}
+
+static int8_t spark_y(int16_t v)
+{
+    int32_t span = (spark.hi - spark.lo) * 10;
+    return (int8_t)(((int32_t)spark.hi * 10 - v) * (SPARK_HEIGHT - 1) / span);
+}
+
+// Columna x: línea vertical desde la muestra anterior para que el trazo
+// quede continuo aunque la temperatura salte
+static void spark_column(uint8_t *top, uint8_t *bottom, int x, int8_t y_prev, int8_t y)
+{
+    int8_t a = (y_prev < y) ? y_prev : y;
+    int8_t b = (y_prev < y) ? y : y_prev;
+    uint16_t mask = (uint16_t)(((1u << (b - a + 1)) - 1) << a);
+    top[x] = mask & 0xFF;
+    bottom[x] = mask >> 8;
+}
+
+void widget_spark(int page)
+{
+    uint8_t *top = display_page_buffer(page);
+    uint8_t *bottom = display_page_buffer(page + 1);
+    if (top == NULL || bottom == NULL) return;
+    if (spark.valid && spark.pushed == pushed) return;
+
+    if (count == 0) {
+        memset(top, 0, SPARK_WIDTH);
+        memset(bottom, 0, SPARK_WIDTH);
+        spark.lo = spark.hi = 0;    // Ninguna escala real coincide
+        spark.valid = true;
+        spark.pushed = pushed;
+        return;
+    }
+
+    int16_t lo, hi;
+    spark_scale(&lo, &hi);
+    int newest = (head + SPARK_WIDTH - 1) % SPARK_WIDTH;
+
+    if (spark.valid && spark.pushed + 1 == pushed && spark.lo == lo && spark.hi == hi) {
+        // Una muestra nueva: correr el gráfico y dibujar solo la última columna
+        memmove(top, top + 1, SPARK_WIDTH - 1);
+        memmove(bottom, bottom + 1, SPARK_WIDTH - 1);
+        int8_t y = spark_y(ring[newest]);
+        spark_column(top, bottom, SPARK_WIDTH - 1, spark.last_y, y);
+        spark.last_y = y;
+        if (count == SPARK_WIDTH) {
+            // La columna 0 quedó unida a una muestra que ya salió del anillo
+            int8_t y0 = spark_y(ring[head]);
+            spark_column(top, bottom, 0, y0, y0);
+        }
+    } else {
+        spark.lo = lo;
+        spark.hi = hi;
+        memset(top, 0, SPARK_WIDTH);
+        memset(bottom, 0, SPARK_WIDTH);
+        int oldest = (head + SPARK_WIDTH - count) % SPARK_WIDTH;
+        int8_t y_prev = -1;
+        for (int i = 0; i < count; i++) {
+            int8_t y = spark_y(ring[(oldest + i) % SPARK_WIDTH]);
+            spark_column(top, bottom, SPARK_WIDTH - count + i, (y_prev < 0) ? y : y_prev, y);
+            y_prev = y;
+        }
+        spark.last_y = y_prev;
+    }
+    spark.valid = true;
+    spark.pushed = pushed;
+}
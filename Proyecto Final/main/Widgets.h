@@ -0,0 +1,49 @@
+#ifndef WIDGETS_H
+#define WIDGETS_H
+
+#include <stdbool.h>
+
+// Widgets gráficos del OLED. Dibujan en el cuadro en preparación del
+// display (display_page_buffer) y recuerdan lo que ya dibujaron: en cada
+// tick solo tocan las columnas que cambiaron. Si otra pantalla (menú) pisó
+// esas páginas hay que llamar a widgets_invalidate() antes de volver.
+
+#define SPARK_WIDTH      128     // Una columna por muestra
+#define SPARK_SAMPLE_MS  15000   // 128 muestras x 15 s = últimos 32 min
+#define SPARK_MIN_SPAN   2       // Escala mínima en °C (el ruido no llena el alto)
+
+/**
+ * @brief La próxima llamada a cada widget lo redibuja completo.
+ */
+void widgets_invalidate(void);
+
+/**
+ * @brief Candado de 8x8 (cerrado / abierto) en la columna x.
+ */
+void widget_lock_icon(int x, int page, bool locked);
+
+/**
+ * @brief Triángulo de advertencia de 8x8 en la columna x (o vacío).
+ */
+void widget_warning_icon(int x, int page, bool shown);
+
+/**
+ * @brief Barra horizontal de una página con el porcentaje lleno.
+ */
+void widget_bar(int x, int page, int width, int percent);
+
+/**
+ * @brief Acumula una lectura. Cada SPARK_SAMPLE_MS guarda el promedio en
+ * el anillo de muestras (décimas de °C en int16: 256 bytes en total).
+ * Las lecturas no válidas (NaN) se ignoran.
+ */
+void widget_spark_feed(float temp);
+
+/**
+ * @brief Gráfico de la temperatura en dos páginas desde 'page'. Con una
+ * muestra nueva y la misma escala corre las columnas una posición y
+ * dibuja solo la última; si cambia la escala lo redibuja entero.
+ */
+void widget_spark(int page);
+
+#endif // WIDGETS_H
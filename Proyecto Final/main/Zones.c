@@ -0,0 +1,340 @@
+#include "Zones.h"
+#include <math.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "StaticMutex.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "sdkconfig.h"
+#include "Occupancy.h"
+#include "Schedule.h"
+#include "Sensor.h"
+#include "Temp_LM35.h"
+
+static const char *TAG = "ZONES";
+
+_Static_assert(ZONE_MAX <= SCHEDULE_MAX_ZONES, "Cada zona necesita un bit en schedule_t.zones");
+_Static_assert(ZONE_MAX <= LM35_MAX_SENSORES, "Un sensor por zona como máximo");
+
+// Cableado de cada zona (ajustar según la placa). Libres en el ESP32 con el
+// teclado, OLED y LED: salidas 19, 5, 2, 16, 17 y ADC1 en GPIO 34, 36, 39.
+// adc < 0: usa el LM35 de la zona 0; pir = GPIO_NUM_NC: usa el PIR de la zona 0.
+static const struct {
+    gpio_num_t fan;
+    int8_t adc;
+    gpio_num_t pir;
+} zone_hw[ZONE_MAX] = {
+    { FAN_PIN,     LM35_ADC_CHANNEL, PIR_PIN     },
+    { GPIO_NUM_19, ADC_CHANNEL_6,    GPIO_NUM_16 },  // LM35 en GPIO 34
+    { GPIO_NUM_5,  ADC_CHANNEL_0,    GPIO_NUM_17 },  // LM35 en GPIO 36
+    { GPIO_NUM_2,  ADC_CHANNEL_3,    GPIO_NUM_NC },  // LM35 en GPIO 39
+    { GPIO_NUM_NC, -1,               GPIO_NUM_NC },
+    { GPIO_NUM_NC, -1,               GPIO_NUM_NC },
+    { GPIO_NUM_NC, -1,               GPIO_NUM_NC },
+    { GPIO_NUM_NC, -1,               GPIO_NUM_NC },
+};
+
+// Formato en NVS (estable, independiente del layout de zone_cfg_t)
+typedef struct __attribute__((packed)) {
+    int8_t mode;
+    uint8_t manual_pwm;
+    int16_t t_min_cc;
+    int16_t t_max_cc;
+} zone_rec_t;
+
+// Todo el estado del lazo en arreglos paralelos: el recorrido por zonas
+// toca solo los campos que usa cada etapa
+static struct {
+    uint8_t count;
+
+    // Hardware
+    uint8_t sensor[ZONE_MAX];       // Índice de LM35 (varias zonas pueden compartir)
+    int8_t pir[ZONE_MAX];           // Índice en Occupancy (también se comparten)
+
+    // Configuración en uso (copia de 'pending' al cambiar la generación)
+    int8_t mode[ZONE_MAX];
+    uint8_t manual_pwm[ZONE_MAX];
+    float t_min[ZONE_MAX];
+    float t_max[ZONE_MAX];
+
+    // Estado
+    float temp[ZONE_MAX];
+    float temp_sd[ZONE_MAX];
+    uint8_t fault_mask;             // LM35 en falla
+    uint8_t pir_mask;
+    uint8_t pwm[ZONE_MAX];
+    int8_t eff_mode[ZONE_MAX];
+
+    // Caché del horario: solo se reevalúa al cruzar un límite de ventana
+    schedule_t sched[ZONE_MAX];
+    bool sched_on[ZONE_MAX];
+    time_t sched_next;
+    time_t sched_last;
+    uint32_t sched_gen;
+    uint32_t cfg_gen;
+} zones;
+
+// Configuración escrita por la API, protegida por el mutex
+static zone_cfg_t pending[ZONE_MAX];
+static uint32_t pending_gen = 1;
+
+static static_mutex_t lock;
+
+static void zones_lock(void)
+{
+    static_mutex_take(&lock);
+}
+
+static void zones_unlock(void)
+{
+    static_mutex_give(&lock);
+}
+
+void zones_init(void)
+{
+    int count = CONFIG_VENT_ZONE_COUNT;
+    if (count > ZONE_MAX) count = ZONE_MAX;
+
+    // Zona 0: hardware original
+    motor_init();
+    sensors_init();
+    temp_sensor_init();
+    zones.sensor[0] = 0;
+    zones.pir[0] = occupancy_add_pin(PIR_PIN);
+#if CONFIG_VENT_NTC_ADC_CHANNEL >= 0
+    if (temp_sensor_add_ntc(0, CONFIG_VENT_NTC_ADC_CHANNEL) != ESP_OK) ESP_LOGW(TAG, "NTC no disponible");
+#endif
+
+    for (int z = 1; z < count; z++) {
+        if (zone_hw[z].fan == GPIO_NUM_NC || motor_init_channel(z, zone_hw[z].fan) != ESP_OK) {
+            ESP_LOGW(TAG, "Zona %d sin pin de ventilador: se usan %d zonas", z, z);
+            count = z;
+            break;
+        }
+
+        zones.sensor[z] = 0;
+        if (zone_hw[z].adc >= 0 && temp_sensor_add_channel(z, zone_hw[z].adc) == ESP_OK) zones.sensor[z] = z;
+
+        zones.pir[z] = zones.pir[0];
+        if (zone_hw[z].pir != GPIO_NUM_NC) {
+            sensors_init_pin(zone_hw[z].pir);
+            zones.pir[z] = occupancy_add_pin(zone_hw[z].pir);
+        }
+    }
+    zones.count = count;
+
+    for (int z = 0; z < ZONE_MAX; z++) {
+        pending[z] = (zone_cfg_t){ ZONE_MODE_GLOBAL, 0, 20.0, 30.0 };
+    }
+    ESP_LOGI(TAG, "%d zona(s)", count);
+}
+
+int zones_count(void)
+{
+    return zones.count;
+}
+
+void zones_read_inputs(void)
+{
+    // Los PIR llegan por interrupción: aquí solo se avanza el modelo de
+    // presencia y se toma "ocupado" (con la espera ya aplicada)
+    occupancy_update(esp_timer_get_time());
+
+    // Cada LM35 se lee una sola vez aunque lo compartan varias zonas
+    float sensor_temp[ZONE_MAX], sensor_sd[ZONE_MAX];
+    uint8_t mask = 0, faults = 0;
+    for (int z = 0; z < zones.count; z++) {
+        if (zones.sensor[z] == z) {
+            sensor_temp[z] = temp_sensor_read_channel_celsius(z);
+            sensor_sd[z] = temp_sensor_get_sigma(z);
+        }
+        zones.temp[z] = sensor_temp[zones.sensor[z]];
+        zones.temp_sd[z] = sensor_sd[zones.sensor[z]];
+        if (temp_sensor_has_fault(zones.sensor[z])) faults |= 1 << z;
+        if (occupancy_is_occupied(zones.pir[z])) mask |= 1 << z;
+    }
+    zones.pir_mask = mask;
+    zones.fault_mask = faults;
+}
+
+static int ramp_pwm(float temp, float t0, float t100)
+{
+    if (isnan(temp)) return CONFIG_VENT_FAILSAFE_PWM; // Sensor en falla
+    if (temp <= t0) return 0;
+    if (temp >= t100) return 100;
+    return (int)((temp - t0) * 100 / (t100 - t0));
+}
+
+bool zones_update(const settings_t *global, uint32_t global_gen, bool locked, time_t now)
+{
+    if (zones.cfg_gen != pending_gen) {
+        zones_lock();
+        zones.cfg_gen = pending_gen;
+        for (int z = 0; z < zones.count; z++) {
+            zones.mode[z] = pending[z].mode;
+            zones.manual_pwm[z] = pending[z].manual_pwm;
+            zones.t_min[z] = pending[z].t_min;
+            zones.t_max[z] = pending[z].t_max;
+        }
+        zones_unlock();
+    }
+
+    // Modo efectivo de cada zona
+    bool any_prog = false;
+    for (int z = 0; z < zones.count; z++) {
+        zones.eff_mode[z] = (zones.mode[z] == ZONE_MODE_GLOBAL) ? global->system_mode : zones.mode[z];
+        any_prog |= (zones.eff_mode[z] == SETTINGS_MODE_PROG);
+    }
+
+    // Una sola búsqueda en el horario para todas las zonas
+    // (now < sched_last: el reloj retrocedió, p. ej. al sincronizar NTP).
+    // Si la lista de 'global_gen' ya se reemplazó se siguen usando los
+    // resultados anteriores; el próximo ciclo llega con la configuración nueva.
+    if (any_prog && (now >= zones.sched_next || now < zones.sched_last || zones.sched_gen != global_gen)) {
+        if (schedule_eval(now, global_gen, zones.count, zones.sched, zones.sched_on, &zones.sched_next)) {
+            zones.sched_gen = global_gen;
+            zones.sched_last = now;
+        }
+    }
+
+    bool any_on = false;
+    for (int z = 0; z < zones.count; z++) {
+        bool own = (zones.mode[z] != ZONE_MODE_GLOBAL);
+        bool pir = zones.pir_mask & (1 << z);
+        int target = 0;
+
+        if (locked) {
+            target = 0; // SI ESTÁ BLOQUEADO: Motor apagado siempre
+        } else if (zones.eff_mode[z] == SETTINGS_MODE_MANUAL) {
+            target = own ? zones.manual_pwm[z] : global->manual_pwm;
+        } else if (zones.eff_mode[z] == SETTINGS_MODE_AUTO) {
+            if (pir) {
+                target = own ? ramp_pwm(zones.temp[z], zones.t_min[z], zones.t_max[z])
+                             : ramp_pwm(zones.temp[z], global->auto_tmin, global->auto_tmax);
+            }
+        } else if (zones.eff_mode[z] == SETTINGS_MODE_PROG && zones.sched_on[z]) {
+            if (pir) target = ramp_pwm(zones.temp[z], zones.sched[z].t_zero, zones.sched[z].t_hundred);
+        }
+
+        if (target != zones.pwm[z]) {
+            motor_set_channel_percent(z, target);
+            zones.pwm[z] = target;
+        }
+        any_on |= (target > 0);
+    }
+    return any_on;
+}
+
+int zones_occupancy_index(int zone)
+{
+    return (zone >= 0 && zone < zones.count) ? zones.pir[zone] : -1;
+}
+
+bool zones_any_motion(void)
+{
+    return zones.pir_mask != 0;
+}
+
+bool zones_any_fault(void)
+{
+    return zones.fault_mask != 0;
+}
+
+void zones_stop_all(void)
+{
+    for (int z = 0; z < zones.count; z++) {
+        motor_set_channel_percent(z, 0);
+        zones.pwm[z] = 0;
+    }
+}
+
+void zones_get_state(zone_state_t out[], int max)
+{
+    int n = zones.count < max ? zones.count : max;
+    for (int z = 0; z < n; z++) {
+        out[z] = (zone_state_t){
+            .temp = zones.temp[z],
+            .temp_sd = zones.temp_sd[z],
+            .fault = zones.fault_mask & (1 << z),
+            .pir = zones.pir_mask & (1 << z),
+            .pwm = zones.pwm[z],
+            .mode = zones.eff_mode[z],
+            .in_window = zones.eff_mode[z] == SETTINGS_MODE_PROG && zones.sched_on[z],
+        };
+    }
+}
+
+void zones_get_config(zone_cfg_t out[], int max)
+{
+    int n = zones.count < max ? zones.count : max;
+    zones_lock();
+    memcpy(out, pending, n * sizeof(zone_cfg_t));
+    zones_unlock();
+}
+
+static bool zone_cfg_valid(const zone_cfg_t *c)
+{
+    if (c->mode < ZONE_MODE_GLOBAL || c->mode > SETTINGS_MODE_PROG) return false;
+    if (c->manual_pwm > 100) return false;
+    return c->t_min >= SETTINGS_TEMP_MIN && c->t_max <= SETTINGS_TEMP_MAX && c->t_min < c->t_max;
+}
+
+esp_err_t zones_set_config(const zone_cfg_t cfg[], int count)
+{
+    if (count > zones.count) count = zones.count;
+    for (int z = 0; z < count; z++) {
+        if (!zone_cfg_valid(&cfg[z])) return ESP_ERR_INVALID_ARG;
+    }
+
+    zones_lock();
+    zone_rec_t recs[ZONE_MAX];
+    for (int z = 0; z < zones.count; z++) {
+        const zone_cfg_t *c = (z < count) ? &cfg[z] : &pending[z];
+        recs[z] = (zone_rec_t){
+            .mode = c->mode,
+            .manual_pwm = c->manual_pwm,
+            .t_min_cc = (int16_t)lroundf(c->t_min * 100),
+            .t_max_cc = (int16_t)lroundf(c->t_max * 100),
+        };
+    }
+
+    nvs_handle_t my_handle;
+    esp_err_t err = nvs_open("storage", NVS_READWRITE, &my_handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(my_handle, "zones", recs, zones.count * sizeof(zone_rec_t));
+        if (err == ESP_OK) err = nvs_commit(my_handle);
+        nvs_close(my_handle);
+    }
+    if (err == ESP_OK) {
+        memcpy(pending, cfg, count * sizeof(zone_cfg_t));
+        pending_gen++;
+    }
+    zones_unlock();
+    return err;
+}
+
+void zones_load_nvs(void)
+{
+    nvs_handle_t my_handle;
+    if (nvs_open("storage", NVS_READONLY, &my_handle) != ESP_OK) return;
+
+    zone_rec_t recs[ZONE_MAX];
+    size_t len = sizeof(recs);
+    if (nvs_get_blob(my_handle, "zones", recs, &len) == ESP_OK) {
+        zones_lock();
+        int n = len / sizeof(zone_rec_t);
+        for (int z = 0; z < n && z < ZONE_MAX; z++) {
+            zone_cfg_t c = {
+                .mode = recs[z].mode,
+                .manual_pwm = recs[z].manual_pwm,
+                .t_min = recs[z].t_min_cc / 100.0,
+                .t_max = recs[z].t_max_cc / 100.0,
+            };
+            if (zone_cfg_valid(&c)) pending[z] = c;
+        }
+        pending_gen++;
+        zones_unlock();
+    }
+    nvs_close(my_handle);
+}
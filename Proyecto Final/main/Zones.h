@@ -0,0 +1,95 @@
+#ifndef ZONES_H
+#define ZONES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "esp_err.h"
+#include "Motor.h"
+#include "Settings.h"
+
+// Una zona = un ventilador (canal LEDC) + un LM35 + un PIR
+#define ZONE_MAX MOTOR_MAX_CHANNELS
+
+// La zona sigue el modo y los umbrales globales (Settings)
+#define ZONE_MODE_GLOBAL -1
+
+// Configuración propia de una zona
+typedef struct {
+    int8_t mode;         // ZONE_MODE_GLOBAL o SETTINGS_MODE_*
+    uint8_t manual_pwm;  // 0..100 %
+    float t_min;         // Modo AUTO
+    float t_max;
+} zone_cfg_t;
+
+// Estado de una zona para la API
+typedef struct {
+    float temp;
+    float temp_sd;       // Desvío estimado de 'temp' (°C)
+    bool fault;          // LM35 en falla: 'temp' puede ser NAN
+    bool pir;
+    uint8_t pwm;
+    int8_t mode;         // Modo efectivo (ya resuelto el global)
+    bool in_window;      // Modo PROGRAMADO con una ventana vigente
+} zone_state_t;
+
+/**
+ * @brief Configura PWM, LM35 y PIR de cada zona (CONFIG_VENT_ZONE_COUNT).
+ * La zona 0 usa el hardware original (FAN_PIN, LM35_ADC_CHANNEL, PIR_PIN).
+ */
+void zones_init(void);
+
+/**
+ * @brief Cantidad de zonas configuradas.
+ */
+int zones_count(void);
+
+/**
+ * @brief Lee temperatura y PIR de todas las zonas.
+ */
+void zones_read_inputs(void);
+
+/**
+ * @brief Calcula y aplica el PWM de todas las zonas en una pasada.
+ * @param global Configuración global vigente.
+ * @param global_gen Su generación (settings_get()): los horarios se evalúan
+ *                   con la lista publicada junto con ella.
+ * @param locked Bloqueado por teclado: todos los motores a 0.
+ * @return true si algún motor quedó encendido.
+ */
+bool zones_update(const settings_t *global, uint32_t global_gen, bool locked, time_t now);
+
+/**
+ * @brief Índice del PIR de la zona en Occupancy (-1 si no hay).
+ */
+int zones_occupancy_index(int zone);
+
+/**
+ * @brief true si alguna zona está ocupada (PIR con la espera de Occupancy).
+ */
+bool zones_any_motion(void);
+
+/**
+ * @brief true si el LM35 de alguna zona está en falla.
+ */
+bool zones_any_fault(void);
+
+/**
+ * @brief Apaga todos los motores.
+ */
+void zones_stop_all(void);
+
+void zones_get_state(zone_state_t out[], int max);
+void zones_get_config(zone_cfg_t out[], int max);
+
+/**
+ * @brief Valida, guarda en NVS (un blob) y publica la configuración de las zonas.
+ */
+esp_err_t zones_set_config(const zone_cfg_t cfg[], int count);
+
+/**
+ * @brief Carga la configuración de las zonas desde NVS.
+ */
+void zones_load_nvs(void);
+
+#endif // ZONES_H
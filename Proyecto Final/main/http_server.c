@@ -8,6 +8,26 @@
 #include "esp_ota_ops.h"
 #include "esp_partition.h"
 #include <sys/param.h>
+#include <string.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "tasks_common.h"
+#include "Schedule.h"
+#include "Settings.h"
+#include "Zones.h"
+#include "Occupancy.h"
+#include "PowerMgmt.h"
+#include "BootProfile.h"
+#include "TimeSync.h"
+#include "wifi_app.h"
+#include "CborEnc.h"
+#include "JsonStream.h"
+#include "Pin.h"
+#include "Auth.h"
+#include "Display.h"
+#include "Temp_LM35.h"
 
 static const char *TAG = "HTTP_SERVER";
 
@@ -15,37 +35,180 @@ static const char *TAG = "HTTP_SERVER";
 extern const uint8_t index_html_start[] asm("_binary_index_html_start");
 extern const uint8_t index_html_end[]   asm("_binary_index_html_end");
 
-typedef struct {
-    bool active;
-    int start_hour;
-    int end_hour;
-    float t_zero;
-    float t_hundred;
-} schedule_t;
-
-extern int system_mode;
-extern int manual_pwm_val;
 extern float current_temp;
 extern bool pir_state;
 extern int current_pwm_output;
-extern float auto_tmin;
-extern float auto_tmax;
-extern schedule_t schedules[3]; 
-
-// 2. FUNCIONES NVS
-esp_err_t save_int_to_nvs(const char *key, int value) {
-    nvs_handle_t my_handle;
-    esp_err_t err = nvs_open("storage", NVS_READWRITE, &my_handle);
-    if (err == ESP_OK) {
-        nvs_set_i32(my_handle, key, value);
-        nvs_commit(my_handle);
-        nvs_close(my_handle);
+
+// Presupuesto de sockets: cada cliente (los del AP más uno de la red STA)
+// tiene abierta la página y el sondeo de /api/status con keep-alive. El
+// httpd usa además 3 sockets propios, que salen del mismo CONFIG_LWIP_MAX_SOCKETS.
+// tools/load_test.py reproduce esta carga.
+#define HTTPD_STA_CLIENTS        1
+#define HTTPD_SOCKETS_PER_CLIENT 2
+#define HTTPD_MAX_SOCKETS        ((WIFI_AP_MAX_CONNECTIONS + HTTPD_STA_CLIENTS) * HTTPD_SOCKETS_PER_CLIENT)
+_Static_assert(HTTPD_MAX_SOCKETS + 3 <= CONFIG_LWIP_MAX_SOCKETS, "Subir CONFIG_LWIP_MAX_SOCKETS en sdkconfig");
+#define HTTPD_KEEPALIVE_IDLE_S  5
+#define HTTPD_KEEPALIVE_INTVL_S 5
+#define HTTPD_KEEPALIVE_COUNT   3
+
+// 2. POOL DE WORKERS
+// El httpd tiene una sola tarea: un handler lento (OTA) bloquearía /api/status.
+// Esos handlers pasan la petición a un worker con httpd_req_async_handler_begin().
+typedef esp_err_t (*httpd_req_handler_t)(httpd_req_t *req);
+
+typedef struct {
+    httpd_req_t *req;
+    httpd_req_handler_t handler;
+} httpd_async_req_t;
+
+static QueueHandle_t async_req_queue = NULL;
+static SemaphoreHandle_t worker_ready_count = NULL;
+static TaskHandle_t worker_handles[HTTP_SERVER_WORKER_COUNT];
+
+static bool is_on_async_worker_thread(void)
+{
+    TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < HTTP_SERVER_WORKER_COUNT; i++) {
+        if (worker_handles[i] == handle) return true;
+    }
+    return false;
+}
+
+static esp_err_t submit_async_req(httpd_req_t *req, httpd_req_handler_t handler)
+{
+    // Sin worker libre se responde 503 en vez de encolar: el socket quedaría
+    // ocupado y el cliente esperando sin saberlo
+    if (xSemaphoreTake(worker_ready_count, 0) == pdFALSE) {
+        ESP_LOGW(TAG, "Sin workers libres");
+        return ESP_FAIL;
+    }
+
+    httpd_req_t *copy = NULL;
+    esp_err_t err = httpd_req_async_handler_begin(req, &copy);
+    if (err != ESP_OK) {
+        xSemaphoreGive(worker_ready_count);
+        return err;
+    }
+
+    httpd_async_req_t async_req = { .req = copy, .handler = handler };
+    if (xQueueSend(async_req_queue, &async_req, 0) != pdTRUE) {
+        httpd_req_async_handler_complete(copy);
+        xSemaphoreGive(worker_ready_count);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static void async_req_worker_task(void *pvParameters)
+{
+    for (;;) {
+        xSemaphoreGive(worker_ready_count);
+
+        httpd_async_req_t async_req;
+        if (xQueueReceive(async_req_queue, &async_req, portMAX_DELAY)) {
+            async_req.handler(async_req.req);
+            httpd_req_async_handler_complete(async_req.req);
+        }
+    }
+}
+
+static void start_async_req_workers(void)
+{
+    if (async_req_queue != NULL) return;
+
+    // Cada worker se anuncia libre al arrancar
+    worker_ready_count = xSemaphoreCreateCounting(HTTP_SERVER_WORKER_COUNT, 0);
+    async_req_queue = xQueueCreate(HTTP_SERVER_WORKER_COUNT, sizeof(httpd_async_req_t));
+
+    for (int i = 0; i < HTTP_SERVER_WORKER_COUNT; i++) {
+        xTaskCreatePinnedToCore(async_req_worker_task, "httpd_worker", HTTP_SERVER_WORKER_STACK_SIZE, NULL,
+                                HTTP_SERVER_WORKER_PRIORITY, &worker_handles[i], HTTP_SERVER_WORKER_CORE_ID);
+    }
+}
+
+// Cuerpo chico completo en buf (terminado en '\0'). Responde 400 si no entra.
+static esp_err_t recv_small_body(httpd_req_t *req, char *buf, size_t size)
+{
+    int remaining = req->content_len;
+    if (remaining >= size) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Payload muy grande"); return ESP_FAIL; }
+
+    int received = 0;
+    while (remaining > 0) {
+        int ret = httpd_req_recv(req, buf + received, remaining);
+        if (ret <= 0) {
+             if (ret == HTTPD_SOCK_ERR_TIMEOUT) continue;
+             return ESP_FAIL;
+        }
+        received += ret;
+        remaining -= ret;
+    }
+    buf[received] = '\0';
+    return ESP_OK;
+}
+
+// 2b. SESIONES (ver Auth.h)
+// Token en la cookie "session" (navegador) o en "Authorization: Bearer <token>"
+static bool request_authorized(httpd_req_t *req)
+{
+    char token[AUTH_TOKEN_LEN + 1];
+    size_t len = sizeof(token);
+    if (httpd_req_get_cookie_val(req, "session", token, &len) == ESP_OK && auth_verify(token)) return true;
+
+    char hdr[AUTH_TOKEN_LEN + 8];
+    if (httpd_req_get_hdr_value_str(req, "Authorization", hdr, sizeof(hdr)) == ESP_OK &&
+        strncmp(hdr, "Bearer ", 7) == 0 && auth_verify(hdr + 7)) {
+        return true;
+    }
+    return false;
+}
+
+// Al principio de cada handler protegido: sin sesión válida responde 401
+static bool require_session(httpd_req_t *req)
+{
+    if (request_authorized(req)) return true;
+    httpd_resp_set_hdr(req, "WWW-Authenticate", "Bearer");
+    httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "Sesion requerida (POST /api/login)");
+    return false;
+}
+
+// PIN incorrecto (403) o en espera por intentos fallidos (429)
+static void send_pin_rejected(httpd_req_t *req)
+{
+    uint32_t wait_ms = pin_lockout_remaining_ms();
+    if (wait_ms > 0) {
+        char retry[12];
+        snprintf(retry, sizeof(retry), "%lu", (unsigned long)((wait_ms + 999) / 1000));
+        httpd_resp_set_status(req, "429 Too Many Requests");
+        httpd_resp_set_hdr(req, "Retry-After", retry);
+        httpd_resp_send(req, "PIN bloqueado, reintente mas tarde", HTTPD_RESP_USE_STRLEN);
+    } else {
+        httpd_resp_send_err(req, HTTPD_403_FORBIDDEN, "PIN incorrecto");
     }
-    return err;
 }
 
 // 3. HANDLER OTA
-static esp_err_t ota_update_post_handler(httpd_req_t *req)
+// Con varios workers dos subidas podrían escribir a la vez la misma
+// partición: la segunda recibe 503 mientras haya una en curso
+static portMUX_TYPE ota_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool ota_in_progress = false;
+
+static bool ota_claim(void)
+{
+    taskENTER_CRITICAL(&ota_mux);
+    bool claimed = !ota_in_progress;
+    ota_in_progress = true;
+    taskEXIT_CRITICAL(&ota_mux);
+    return claimed;
+}
+
+static void ota_release(void)
+{
+    taskENTER_CRITICAL(&ota_mux);
+    ota_in_progress = false;
+    taskEXIT_CRITICAL(&ota_mux);
+}
+
+static esp_err_t ota_receive(httpd_req_t *req)
 {
     char buf[1024];
     esp_ota_handle_t ota_handle;
@@ -87,6 +250,28 @@ static esp_err_t ota_update_post_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+static esp_err_t ota_update_post_handler(httpd_req_t *req)
+{
+    if (!is_on_async_worker_thread()) {
+        // La sesión se verifica aquí: el worker recibe solo peticiones autorizadas
+        if (!require_session(req)) return ESP_FAIL;
+        if (!ota_claim()) {
+            httpd_resp_set_status(req, "503 Service Unavailable");
+            httpd_resp_send(req, "OTA en curso", HTTPD_RESP_USE_STRLEN);
+            return ESP_OK;
+        }
+        if (submit_async_req(req, ota_update_post_handler) == ESP_OK) return ESP_OK;
+        ota_release();
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_send(req, "Servidor ocupado", HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
+    }
+
+    esp_err_t err = ota_receive(req);
+    ota_release();
+    return err;
+}
+
 // 4. HANDLERS WEB
 static esp_err_t webpage_get_handler(httpd_req_t *req) {
     httpd_resp_set_type(req, "text/html");
@@ -94,92 +279,568 @@ static esp_err_t webpage_get_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+// true si el cliente pide CBOR en la cabecera Accept
+static bool client_accepts_cbor(httpd_req_t *req) {
+    char accept[96];
+    // Si es más larga se lee truncada: alcanza con el comienzo
+    esp_err_t err = httpd_req_get_hdr_value_str(req, "Accept", accept, sizeof(accept));
+    if (err != ESP_OK && err != ESP_ERR_HTTPD_RESULT_TRUNC) return false;
+    return strstr(accept, "application/cbor") != NULL;
+}
+
+// Mismas claves que el JSON, pero cada horario y cada zona van como arreglo
+// posicional (orden en "sched_fmt" y "zone_fmt") para no repetir nombres
+static esp_err_t status_get_cbor(httpd_req_t *req) {
+    uint8_t buf[1024];
+    cbor_enc_t enc;
+    cbor_enc_init(&enc, buf, sizeof(buf));
+
+    settings_t cfg;
+    settings_get(&cfg);
+    schedule_t schedules[SCHEDULE_MAX_WINDOWS];
+    int sched_count = schedule_get(schedules, SCHEDULE_MAX_WINDOWS);
+
+    zone_state_t zs[ZONE_MAX];
+    int zone_count = zones_count();
+    zones_get_state(zs, ZONE_MAX);
+
+    display_stats_t ds;
+    display_get_stats(&ds);
+    occupancy_stats_t os;
+    occupancy_get_stats(zones_occupancy_index(0), &os);
+
+    cbor_put_map(&enc, 17);
+    cbor_put_text(&enc, "temp");      cbor_put_float(&enc, current_temp);
+    cbor_put_text(&enc, "fault");     cbor_put_bool(&enc, zones_any_fault());
+    cbor_put_text(&enc, "pir");       cbor_put_bool(&enc, pir_state);
+    cbor_put_text(&enc, "pwm");       cbor_put_int(&enc, current_pwm_output);
+    cbor_put_text(&enc, "mode");      cbor_put_int(&enc, cfg.system_mode);
+    cbor_put_text(&enc, "man_pwm");   cbor_put_int(&enc, cfg.manual_pwm);
+    cbor_put_text(&enc, "a_min");     cbor_put_float(&enc, cfg.auto_tmin);
+    cbor_put_text(&enc, "a_max");     cbor_put_float(&enc, cfg.auto_tmax);
+    cbor_put_text(&enc, "wake_ms");   cbor_put_int(&enc, power_wake_latency_ms());
+    cbor_put_text(&enc, "time_sync"); cbor_put_text(&enc, time_sync_state_str());
+    cbor_put_text(&enc, "last_sync"); cbor_put_int(&enc, time_sync_last_sync());
+    cbor_put_text(&enc, "display");
+    cbor_put_map(&enc, 4);
+    cbor_put_text(&enc, "online");    cbor_put_bool(&enc, ds.online);
+    cbor_put_text(&enc, "fps");       cbor_put_float(&enc, ds.fps);
+    cbor_put_text(&enc, "dropped");   cbor_put_uint(&enc, ds.dropped);
+    cbor_put_text(&enc, "i2c_err");   cbor_put_uint(&enc, ds.i2c_errors);
+    cbor_put_text(&enc, "occ");
+    cbor_put_map(&enc, 6);
+    cbor_put_text(&enc, "motion");    cbor_put_bool(&enc, os.motion);
+    cbor_put_text(&enc, "hold_s");    cbor_put_uint(&enc, os.hold_s);
+    cbor_put_text(&enc, "sessions");  cbor_put_uint(&enc, os.sessions);
+    cbor_put_text(&enc, "false_vac"); cbor_put_uint(&enc, os.false_vacancies);
+    cbor_put_text(&enc, "missed");    cbor_put_uint(&enc, os.missed_edges);
+    cbor_put_text(&enc, "occ_s");     cbor_put_uint(&enc, os.occupied_s);
+    cbor_put_text(&enc, "sched_fmt");
+    cbor_put_array(&enc, 8);
+    static const char *const fields[] = { "act", "days", "prio", "sm", "em", "t0", "t100", "zones" };
+    for (int i = 0; i < 8; i++) cbor_put_text(&enc, fields[i]);
+
+    cbor_put_text(&enc, "schedules");
+    cbor_put_array(&enc, sched_count);
+    for (int i = 0; i < sched_count; i++) {
+        cbor_put_array(&enc, 8);
+        cbor_put_bool(&enc, schedules[i].active);
+        cbor_put_uint(&enc, schedules[i].days);
+        cbor_put_uint(&enc, schedules[i].priority);
+        cbor_put_uint(&enc, schedules[i].start_min);
+        cbor_put_uint(&enc, schedules[i].end_min);
+        cbor_put_float(&enc, schedules[i].t_zero);
+        cbor_put_float(&enc, schedules[i].t_hundred);
+        cbor_put_uint(&enc, schedules[i].zones);
+    }
+
+    cbor_put_text(&enc, "zone_fmt");
+    cbor_put_array(&enc, 7);
+    static const char *const zone_fields[] = { "temp", "pir", "pwm", "mode", "win", "sd", "fault" };
+    for (int i = 0; i < 7; i++) cbor_put_text(&enc, zone_fields[i]);
+
+    cbor_put_text(&enc, "zones");
+    cbor_put_array(&enc, zone_count);
+    for (int z = 0; z < zone_count; z++) {
+        cbor_put_array(&enc, 7);
+        cbor_put_float(&enc, zs[z].temp);
+        cbor_put_bool(&enc, zs[z].pir);
+        cbor_put_uint(&enc, zs[z].pwm);
+        cbor_put_int(&enc, zs[z].mode);
+        cbor_put_bool(&enc, zs[z].in_window);
+        cbor_put_float(&enc, zs[z].temp_sd);
+        cbor_put_bool(&enc, zs[z].fault);
+    }
+
+    size_t len = cbor_enc_size(&enc);
+    if (len == 0) { httpd_resp_send_500(req); return ESP_FAIL; }
+    httpd_resp_set_type(req, "application/cbor");
+    httpd_resp_set_hdr(req, "Vary", "Accept");
+    httpd_resp_send(req, (const char *)buf, len);
+    return ESP_OK;
+}
+
 static esp_err_t status_get_handler(httpd_req_t *req) {
+    if (client_accepts_cbor(req)) return status_get_cbor(req);
+
+    settings_t cfg;
+    settings_get(&cfg);
+
     cJSON *root = cJSON_CreateObject();
     cJSON_AddNumberToObject(root, "temp", current_temp);
+    cJSON_AddBoolToObject(root, "fault", zones_any_fault());
     cJSON_AddBoolToObject(root, "pir", pir_state);
     cJSON_AddNumberToObject(root, "pwm", current_pwm_output);
-    cJSON_AddNumberToObject(root, "mode", system_mode);
-    cJSON_AddNumberToObject(root, "man_pwm", manual_pwm_val);
-    cJSON_AddNumberToObject(root, "a_min", auto_tmin);
-    cJSON_AddNumberToObject(root, "a_max", auto_tmax);
+    cJSON_AddNumberToObject(root, "mode", cfg.system_mode);
+    cJSON_AddNumberToObject(root, "man_pwm", cfg.manual_pwm);
+    cJSON_AddNumberToObject(root, "a_min", cfg.auto_tmin);
+    cJSON_AddNumberToObject(root, "a_max", cfg.auto_tmax);
+    cJSON_AddNumberToObject(root, "wake_ms", power_wake_latency_ms());
+    cJSON_AddStringToObject(root, "time_sync", time_sync_state_str());
+    cJSON_AddNumberToObject(root, "last_sync", (double)time_sync_last_sync());
+
+    display_stats_t ds;
+    display_get_stats(&ds);
+    cJSON *disp = cJSON_AddObjectToObject(root, "display");
+    cJSON_AddBoolToObject(disp, "online", ds.online);
+    cJSON_AddNumberToObject(disp, "fps", ds.fps);
+    cJSON_AddNumberToObject(disp, "dropped", ds.dropped);
+    cJSON_AddNumberToObject(disp, "i2c_err", ds.i2c_errors);
+
+    // Presencia de la zona 0 ("pir" ya incluye la espera)
+    occupancy_stats_t os;
+    occupancy_get_stats(zones_occupancy_index(0), &os);
+    cJSON *occ = cJSON_AddObjectToObject(root, "occ");
+    cJSON_AddBoolToObject(occ, "motion", os.motion);
+    cJSON_AddNumberToObject(occ, "hold_s", os.hold_s);
+    cJSON_AddNumberToObject(occ, "sessions", os.sessions);
+    cJSON_AddNumberToObject(occ, "false_vac", os.false_vacancies);
+    cJSON_AddNumberToObject(occ, "missed", os.missed_edges);
+    cJSON_AddNumberToObject(occ, "occ_s", os.occupied_s);
+
+    schedule_t schedules[SCHEDULE_MAX_WINDOWS];
+    int sched_count = schedule_get(schedules, SCHEDULE_MAX_WINDOWS);
 
     cJSON *schedArray = cJSON_CreateArray();
-    for(int i=0; i<3; i++) {
+    for(int i=0; i<sched_count; i++) {
         cJSON *item = cJSON_CreateObject();
         cJSON_AddBoolToObject(item, "act", schedules[i].active);
-        cJSON_AddNumberToObject(item, "sh", schedules[i].start_hour);
-        cJSON_AddNumberToObject(item, "eh", schedules[i].end_hour);
+        cJSON_AddNumberToObject(item, "days", schedules[i].days);
+        cJSON_AddNumberToObject(item, "prio", schedules[i].priority);
+        cJSON_AddNumberToObject(item, "sm", schedules[i].start_min);
+        cJSON_AddNumberToObject(item, "em", schedules[i].end_min);
+        cJSON_AddNumberToObject(item, "sh", schedules[i].start_min / 60);
+        cJSON_AddNumberToObject(item, "eh", schedules[i].end_min / 60);
         cJSON_AddNumberToObject(item, "t0", schedules[i].t_zero);
         cJSON_AddNumberToObject(item, "t100", schedules[i].t_hundred);
+        cJSON_AddNumberToObject(item, "zones", schedules[i].zones);
         cJSON_AddItemToArray(schedArray, item);
     }
     cJSON_AddItemToObject(root, "schedules", schedArray);
 
+    zone_state_t zs[ZONE_MAX];
+    zone_cfg_t zc[ZONE_MAX];
+    int zone_count = zones_count();
+    zones_get_state(zs, ZONE_MAX);
+    zones_get_config(zc, ZONE_MAX);
+
+    cJSON *zoneArray = cJSON_CreateArray();
+    for (int z = 0; z < zone_count; z++) {
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "temp", zs[z].temp);
+        cJSON_AddNumberToObject(item, "sd", zs[z].temp_sd);
+        cJSON_AddBoolToObject(item, "fault", zs[z].fault);
+        cJSON_AddBoolToObject(item, "pir", zs[z].pir);
+        cJSON_AddNumberToObject(item, "pwm", zs[z].pwm);
+        cJSON_AddNumberToObject(item, "mode", zs[z].mode);
+        cJSON_AddBoolToObject(item, "win", zs[z].in_window);
+        cJSON_AddNumberToObject(item, "cfg_mode", zc[z].mode);
+        cJSON_AddNumberToObject(item, "man_pwm", zc[z].manual_pwm);
+        cJSON_AddNumberToObject(item, "t_min", zc[z].t_min);
+        cJSON_AddNumberToObject(item, "t_max", zc[z].t_max);
+        cJSON_AddItemToArray(zoneArray, item);
+    }
+    cJSON_AddItemToObject(root, "zones", zoneArray);
+
     const char *json_str = cJSON_PrintUnformatted(root);
     httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Vary", "Accept");
     httpd_resp_send(req, json_str, HTTPD_RESP_USE_STRLEN);
     free((void *)json_str);
     cJSON_Delete(root);
     return ESP_OK;
 }
 
+// Tiempos de arranque por etapa (ms)
+static esp_err_t boot_get_handler(httpd_req_t *req) {
+    char buf[512];
+    boot_profile_to_json(buf, sizeof(buf));
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, buf, HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+// Esquema de /api/settings: se valida todo antes de aplicar nada
+typedef struct {
+    settings_t cfg;
+    uint16_t sched_count;
+    schedule_t schedules[SCHEDULE_MAX_WINDOWS];
+} settings_req_t;
+
+static const json_field_t settings_fields[] = {
+    { "mode",       JSON_FIELD_INT,   SETTINGS_MODE_MANUAL, SETTINGS_MODE_PROG, 0, offsetof(settings_req_t, cfg.system_mode) },
+    { "manual_pwm", JSON_FIELD_INT,   0,                    100,                0, offsetof(settings_req_t, cfg.manual_pwm) },
+    { "auto_tmin",  JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN,    SETTINGS_TEMP_MAX,  0, offsetof(settings_req_t, cfg.auto_tmin) },
+    { "auto_tmax",  JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN,    SETTINGS_TEMP_MAX,  0, offsetof(settings_req_t, cfg.auto_tmax) },
+};
+
+static const json_order_t settings_order[] = {
+    { offsetof(settings_req_t, cfg.auto_tmin), offsetof(settings_req_t, cfg.auto_tmax), "auto_tmin/auto_tmax" },
+};
+
+// "sm"/"em" en minutos; "sh"/"eh" en horas (web anterior). Si llegan ambos gana el último.
+static const json_field_t schedule_fields[] = {
+    { "act",   JSON_FIELD_BOOL,  0,                 1,                   0,  offsetof(schedule_t, active) },
+    { "days",  JSON_FIELD_U8,    0,                 SCHEDULE_ALL_DAYS,   0,  offsetof(schedule_t, days) },
+    { "prio",  JSON_FIELD_U8,    0,                 255,                 0,  offsetof(schedule_t, priority) },
+    { "zones", JSON_FIELD_U8,    0,                 SCHEDULE_ALL_ZONES,  0,  offsetof(schedule_t, zones) },
+    { "sm",    JSON_FIELD_U16,   0,                 MINUTES_PER_DAY - 1, 0,  offsetof(schedule_t, start_min) },
+    { "em",    JSON_FIELD_U16,   0,                 MINUTES_PER_DAY,     0,  offsetof(schedule_t, end_min) },
+    { "sh",    JSON_FIELD_U16,   0,                 23,                  60, offsetof(schedule_t, start_min) },
+    { "eh",    JSON_FIELD_U16,   0,                 24,                  60, offsetof(schedule_t, end_min) },
+    { "t0",    JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN, SETTINGS_TEMP_MAX,   0,  offsetof(schedule_t, t_zero) },
+    { "t100",  JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN, SETTINGS_TEMP_MAX,   0,  offsetof(schedule_t, t_hundred) },
+};
+
+static const json_order_t schedule_order[] = {
+    { offsetof(schedule_t, t_zero), offsetof(schedule_t, t_hundred), "t0/t100" },
+};
+
+static const json_schema_t settings_schema = {
+    .fields = settings_fields,
+    .n_fields = sizeof(settings_fields) / sizeof(settings_fields[0]),
+    .order = settings_order,
+    .n_order = sizeof(settings_order) / sizeof(settings_order[0]),
+    .array_key = "schedules",
+    .item_fields = schedule_fields,
+    .n_item_fields = sizeof(schedule_fields) / sizeof(schedule_fields[0]),
+    .item_order = schedule_order,
+    .n_item_order = sizeof(schedule_order) / sizeof(schedule_order[0]),
+    .array_offset = offsetof(settings_req_t, schedules),
+    .count_offset = offsetof(settings_req_t, sched_count),
+    .stride = sizeof(schedule_t),
+    .max_items = SCHEDULE_MAX_WINDOWS,
+};
+
 static esp_err_t settings_post_handler(httpd_req_t *req) {
-    char buf[2048]; 
+    if (!require_session(req)) return ESP_FAIL;
+
+    // Se parte de la configuración actual: solo cambia lo que viene en el JSON
+    settings_req_t set;
+    settings_get(&set.cfg);
+    set.sched_count = 0;
+    const schedule_t sched_default = {
+        .days = SCHEDULE_ALL_DAYS,
+        .zones = SCHEDULE_ALL_ZONES,
+        .t_zero = set.cfg.auto_tmin,
+        .t_hundred = set.cfg.auto_tmax,
+    };
+
+    json_stream_t js;
+    json_stream_init(&js, &settings_schema, &set, &sched_default);
+
+    // El cuerpo se parsea por trozos a medida que llega, sin copiarlo entero
+    char chunk[128];
     int remaining = req->content_len;
-    if (remaining >= sizeof(buf)) { httpd_resp_send_500(req); return ESP_FAIL; }
-    
-    int received = 0;
-    while (remaining > 0) {
-        int ret = httpd_req_recv(req, buf + received, remaining);
-        if (ret <= 0) { 
+    esp_err_t err = ESP_OK;
+    while (remaining > 0 && err == ESP_OK) {
+        int ret = httpd_req_recv(req, chunk, MIN(remaining, sizeof(chunk)));
+        if (ret <= 0) {
              if (ret == HTTPD_SOCK_ERR_TIMEOUT) continue;
-             return ESP_FAIL; 
+             return ESP_FAIL;
         }
-        received += ret;
         remaining -= ret;
+        err = json_stream_feed(&js, chunk, ret);
     }
-    buf[received] = '\0';
+    if (err == ESP_OK) err = json_stream_finish(&js);
 
-    cJSON *root = cJSON_Parse(buf);
-    if (root == NULL) return ESP_FAIL;
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Settings rechazados: %s", js.err_msg);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, js.err_msg);
+        return ESP_FAIL;
+    }
 
-    // Guardar configuraciones simples
-    cJSON *item = cJSON_GetObjectItem(root, "mode");
-    if (item) { system_mode = item->valueint; save_int_to_nvs("sys_mode", system_mode); }
-    
-    item = cJSON_GetObjectItem(root, "manual_pwm");
-    if (item) { manual_pwm_val = item->valueint; save_int_to_nvs("man_pwm", manual_pwm_val); }
-
-    item = cJSON_GetObjectItem(root, "auto_tmin");
-    if (item) { auto_tmin = (float)item->valuedouble; save_int_to_nvs("auto_tmin", (int)(auto_tmin * 100)); }
-
-    item = cJSON_GetObjectItem(root, "auto_tmax");
-    if (item) { auto_tmax = (float)item->valuedouble; save_int_to_nvs("auto_tmax", (int)(auto_tmax * 100)); }
-
-    // Guardar Schedules
-    cJSON *schedArr = cJSON_GetObjectItem(root, "schedules");
-    if (schedArr && cJSON_IsArray(schedArr)) {
-        for (int i = 0; i < 3; i++) {
-            cJSON *s = cJSON_GetArrayItem(schedArr, i);
-            if (s) {
-                schedules[i].active = cJSON_GetObjectItem(s, "act")->valueint;
-                schedules[i].start_hour = cJSON_GetObjectItem(s, "sh")->valueint;
-                schedules[i].end_hour = cJSON_GetObjectItem(s, "eh")->valueint;
-                schedules[i].t_zero = (float)cJSON_GetObjectItem(s, "t0")->valuedouble;
-                schedules[i].t_hundred = (float)cJSON_GetObjectItem(s, "t100")->valuedouble;
-
-                char key[16];
-                sprintf(key, "sch%d_act", i); save_int_to_nvs(key, schedules[i].active);
-                sprintf(key, "sch%d_sh", i);  save_int_to_nvs(key, schedules[i].start_hour);
-                sprintf(key, "sch%d_eh", i);  save_int_to_nvs(key, schedules[i].end_hour);
-                sprintf(key, "sch%d_t0", i);  save_int_to_nvs(key, (int)(schedules[i].t_zero * 100));
-                sprintf(key, "sch%d_t1", i);  save_int_to_nvs(key, (int)(schedules[i].t_hundred * 100));
-            }
+    // Transacción: configuración general y horarios van en un solo registro
+    // de NVS y se publican juntos; lo que no vino en el JSON se conserva
+    if (js.present || js.array_present) {
+        err = settings_commit(js.present ? &set.cfg : NULL,
+                              js.array_present ? set.schedules : NULL, set.sched_count);
+    }
+
+    if (err == ESP_ERR_INVALID_ARG) {
+        // Lo rechazó la validación (p. ej. auto_tmin >= auto_tmax): error del cliente
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Configuracion invalida");
+        return ESP_FAIL;
+    }
+    if (err != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err));
+        return ESP_FAIL;
+    }
+
+    httpd_resp_send(req, "{\"status\":\"ok\"}", HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+// Configuración propia de cada zona: {"zones":[{"mode":-1,"man_pwm":0,"t_min":20,"t_max":30}, ...]}
+// mode -1 = sigue la configuración global. Los campos que faltan no cambian.
+typedef struct {
+    uint16_t count;
+    zone_cfg_t zones[ZONE_MAX];
+} zones_req_t;
+
+static const json_field_t zone_fields[] = {
+    { "mode",    JSON_FIELD_INT8,  ZONE_MODE_GLOBAL,  SETTINGS_MODE_PROG, 0, offsetof(zone_cfg_t, mode) },
+    { "man_pwm", JSON_FIELD_U8,    0,                 100,                0, offsetof(zone_cfg_t, manual_pwm) },
+    { "t_min",   JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN, SETTINGS_TEMP_MAX,  0, offsetof(zone_cfg_t, t_min) },
+    { "t_max",   JSON_FIELD_FLOAT, SETTINGS_TEMP_MIN, SETTINGS_TEMP_MAX,  0, offsetof(zone_cfg_t, t_max) },
+};
+
+static const json_order_t zone_order[] = {
+    { offsetof(zone_cfg_t, t_min), offsetof(zone_cfg_t, t_max), "t_min/t_max" },
+};
+
+static const json_schema_t zones_schema = {
+    .array_key = "zones",
+    .item_fields = zone_fields,
+    .n_item_fields = sizeof(zone_fields) / sizeof(zone_fields[0]),
+    .item_order = zone_order,
+    .n_item_order = sizeof(zone_order) / sizeof(zone_order[0]),
+    .array_offset = offsetof(zones_req_t, zones),
+    .count_offset = offsetof(zones_req_t, count),
+    .stride = sizeof(zone_cfg_t),
+    .max_items = ZONE_MAX,
+};
+
+static esp_err_t zones_post_handler(httpd_req_t *req) {
+    if (!require_session(req)) return ESP_FAIL;
+
+    // Sin plantilla: cada elemento parte de la configuración actual de esa zona
+    zones_req_t zr = { 0 };
+    zones_get_config(zr.zones, ZONE_MAX);
+
+    json_stream_t js;
+    json_stream_init(&js, &zones_schema, &zr, NULL);
+
+    char chunk[128];
+    int remaining = req->content_len;
+    esp_err_t err = ESP_OK;
+    while (remaining > 0 && err == ESP_OK) {
+        int ret = httpd_req_recv(req, chunk, MIN(remaining, sizeof(chunk)));
+        if (ret <= 0) {
+             if (ret == HTTPD_SOCK_ERR_TIMEOUT) continue;
+             return ESP_FAIL;
         }
+        remaining -= ret;
+        err = json_stream_feed(&js, chunk, ret);
+    }
+    if (err == ESP_OK) err = json_stream_finish(&js);
+    if (err != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, js.err_msg);
+        return ESP_FAIL;
+    }
+
+    if (js.array_present) err = zones_set_config(zr.zones, zr.count);
+    if (err == ESP_ERR_INVALID_ARG) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Configuracion de zona invalida");
+        return ESP_FAIL;
+    }
+    if (err != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err));
+        return ESP_FAIL;
+    }
+    httpd_resp_send(req, "{\"status\":\"ok\"}", HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+// GET /api/calib: calibración de cada LM35 configurado
+static esp_err_t calib_get_handler(httpd_req_t *req) {
+    if (!require_session(req)) return ESP_FAIL;
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON *arr = cJSON_AddArrayToObject(root, "sensors");
+    for (int i = 0; i < LM35_MAX_SENSORES; i++) {
+        temp_sensor_cal_info_t info;
+        if (temp_sensor_cal_get(i, &info) != ESP_OK) continue;
+        cJSON *s = cJSON_CreateObject();
+        cJSON_AddNumberToObject(s, "sensor", i);
+        cJSON_AddNumberToObject(s, "gain", info.gain);
+        cJSON_AddNumberToObject(s, "offset", info.offset_c);
+        cJSON_AddNumberToObject(s, "points", info.points);
+        cJSON_AddNumberToObject(s, "raw", info.raw_c);
+        cJSON_AddItemToArray(arr, s);
+    }
+
+    const char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json_str, HTTPD_RESP_USE_STRLEN);
+    free((void *)json_str);
+    cJSON_Delete(root);
+    return ESP_OK;
+}
+
+// POST /api/calib: {"sensor":0,"ref":24.6} captura un punto con la lectura
+// actual, {"sensor":0,"fit":true} ajusta y guarda, {"sensor":0,"reset":true}
+// vuelve a la lectura sin corregir
+static esp_err_t calib_post_handler(httpd_req_t *req) {
+    if (!require_session(req)) return ESP_FAIL;
+
+    char buf[96];
+    if (recv_small_body(req, buf, sizeof(buf)) != ESP_OK) return ESP_FAIL;
+
+    cJSON *root = cJSON_Parse(buf);
+    if (root == NULL) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "JSON invalido"); return ESP_FAIL; }
+
+    const cJSON *sensor = cJSON_GetObjectItem(root, "sensor");
+    const cJSON *ref = cJSON_GetObjectItem(root, "ref");
+    int idx = cJSON_IsNumber(sensor) ? sensor->valueint : 0;
+    float value = 0;
+    esp_err_t err = ESP_ERR_INVALID_ARG;
+    const char *fmt = "{\"status\":\"ok\"}";
+    if (cJSON_IsNumber(ref)) {
+        err = temp_sensor_cal_add_point(idx, ref->valuedouble, &value);
+        fmt = "{\"status\":\"ok\",\"raw\":%.2f}";
+    } else if (cJSON_IsTrue(cJSON_GetObjectItem(root, "fit"))) {
+        err = temp_sensor_cal_fit(idx, &value);
+        fmt = "{\"status\":\"ok\",\"err_max\":%.2f}";
+    } else if (cJSON_IsTrue(cJSON_GetObjectItem(root, "reset"))) {
+        err = temp_sensor_cal_reset(idx);
+    }
+    cJSON_Delete(root);
+
+    if (err == ESP_ERR_NO_MEM) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Maximo de puntos alcanzado"); return ESP_FAIL; }
+    if (err == ESP_ERR_INVALID_STATE) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "El sensor aun no tiene lecturas"); return ESP_FAIL; }
+    if (err == ESP_ERR_INVALID_ARG) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Sensor, referencia o puntos invalidos");
+        return ESP_FAIL;
     }
+    if (err != ESP_OK) { httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err)); return ESP_FAIL; }
 
+    char resp[48];
+    snprintf(resp, sizeof(resp), fmt, value);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, resp, HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+// Estado de la conexión al router (nunca devuelve la clave)
+static esp_err_t wifi_get_handler(httpd_req_t *req) {
+    if (!require_session(req)) return ESP_FAIL;
+
+    wifi_app_sta_metrics_t m;
+    wifi_app_get_sta_metrics(&m);
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "ssid", m.ssid);
+    cJSON_AddBoolToObject(root, "connected", m.connected);
+    cJSON_AddNumberToObject(root, "rssi", m.rssi);
+    cJSON_AddNumberToObject(root, "uptime_s", m.uptime_s);
+    cJSON_AddNumberToObject(root, "retries", m.retries);
+    cJSON_AddNumberToObject(root, "reconnects", m.reconnects);
+    cJSON_AddNumberToObject(root, "last_reason", m.last_reason);
+    cJSON_AddNumberToObject(root, "last_reconnect_ms", m.last_reconnect_ms);
+
+    const char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json_str, HTTPD_RESP_USE_STRLEN);
+    free((void *)json_str);
     cJSON_Delete(root);
+    return ESP_OK;
+}
+
+// Aprovisionamiento: {"ssid": "...", "pass": "..."}
+static esp_err_t wifi_post_handler(httpd_req_t *req) {
+    if (!require_session(req)) return ESP_FAIL;
+
+    char buf[256];
+    if (recv_small_body(req, buf, sizeof(buf)) != ESP_OK) return ESP_FAIL;
+
+    cJSON *root = cJSON_Parse(buf);
+    if (root == NULL) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "JSON invalido"); return ESP_FAIL; }
+
+    const cJSON *ssid = cJSON_GetObjectItem(root, "ssid");
+    const cJSON *pass = cJSON_GetObjectItem(root, "pass");
+    esp_err_t err = ESP_ERR_INVALID_ARG;
+    if (cJSON_IsString(ssid)) {
+        err = wifi_app_set_credentials(ssid->valuestring, cJSON_IsString(pass) ? pass->valuestring : "");
+    }
+    cJSON_Delete(root);
+
+    if (err != ESP_OK) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, esp_err_to_name(err)); return ESP_FAIL; }
+    httpd_resp_send(req, "{\"status\":\"ok\"}", HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+// POST /api/pin: {"old":"1234","new":"5678"}. Los errores cuentan para la
+// espera igual que en el teclado (no se puede probar PINs por la web)
+static esp_err_t pin_post_handler(httpd_req_t *req) {
+    if (!require_session(req)) return ESP_FAIL;
+
+    char buf[96];
+    if (recv_small_body(req, buf, sizeof(buf)) != ESP_OK) return ESP_FAIL;
+
+    cJSON *root = cJSON_Parse(buf);
+    if (root == NULL) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "JSON invalido"); return ESP_FAIL; }
+
+    const cJSON *old_pin = cJSON_GetObjectItem(root, "old");
+    const cJSON *new_pin = cJSON_GetObjectItem(root, "new");
+    esp_err_t err = ESP_ERR_INVALID_ARG;
+    if (cJSON_IsString(old_pin) && cJSON_IsString(new_pin)) {
+        err = pin_change(old_pin->valuestring, new_pin->valuestring);
+    }
+    cJSON_Delete(root);
+
+    if (err == ESP_ERR_INVALID_ARG) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "El PIN nuevo debe tener 4 a 8 digitos");
+        return ESP_FAIL;
+    }
+    if (err == ESP_ERR_INVALID_STATE) { send_pin_rejected(req); return ESP_FAIL; }
+    if (err != ESP_OK) { httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err)); return ESP_FAIL; }
+
+    // Las sesiones abiertas con el PIN viejo dejan de valer
+    auth_revoke_all();
+    httpd_resp_send(req, "{\"status\":\"ok\"}", HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+// POST /api/login: {"pin":"1234"} -> token (cookie + JSON para clientes sin cookies)
+static esp_err_t login_post_handler(httpd_req_t *req) {
+    char buf[64];
+    if (recv_small_body(req, buf, sizeof(buf)) != ESP_OK) return ESP_FAIL;
+
+    cJSON *root = cJSON_Parse(buf);
+    if (root == NULL) { httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "JSON invalido"); return ESP_FAIL; }
+
+    const cJSON *pin = cJSON_GetObjectItem(root, "pin");
+    char token[AUTH_TOKEN_LEN + 1];
+    pin_result_t res = cJSON_IsString(pin) ? auth_login(pin->valuestring, token) : PIN_WRONG;
+    cJSON_Delete(root);
+
+    if (res != PIN_OK) { send_pin_rejected(req); return ESP_FAIL; }
+
+    char cookie[AUTH_TOKEN_LEN + 80];
+    snprintf(cookie, sizeof(cookie), "session=%s; Path=/; Max-Age=%d; HttpOnly; SameSite=Strict", token, AUTH_SESSION_TTL_S);
+    httpd_resp_set_hdr(req, "Set-Cookie", cookie);
+
+    char resp[AUTH_TOKEN_LEN + 48];
+    snprintf(resp, sizeof(resp), "{\"token\":\"%s\",\"expires_s\":%d}", token, AUTH_SESSION_TTL_S);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, resp, HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+// POST /api/logout: borra la cookie (el token vence solo; /api/pin cierra todas)
+static esp_err_t logout_post_handler(httpd_req_t *req) {
+    httpd_resp_set_hdr(req, "Set-Cookie", "session=; Path=/; Max-Age=0; HttpOnly; SameSite=Strict");
     httpd_resp_send(req, "{\"status\":\"ok\"}", HTTPD_RESP_USE_STRLEN);
     return ESP_OK;
 }
@@ -188,9 +849,24 @@ static esp_err_t settings_post_handler(httpd_req_t *req) {
 httpd_handle_t start_webserver(void)
 {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
-    config.stack_size = 8192; 
+    config.stack_size = HTTP_SERVER_TASK_STACK_SIZE;
+    config.task_priority = HTTP_SERVER_TASK_PRIORITY;
+    config.core_id = HTTP_SERVER_TASK_CORE_ID;
+    config.max_uri_handlers = 16;
+    // Con todos los sockets ocupados se cierra el menos usado en vez de rechazar
+    config.max_open_sockets = HTTPD_MAX_SOCKETS;
+    config.lru_purge_enable = true;
+    // Keep-alive TCP: las páginas que consultan /api/status reutilizan la
+    // conexión y los clientes que desaparecen (AP) liberan su socket
+    config.keep_alive_enable = true;
+    config.keep_alive_idle = HTTPD_KEEPALIVE_IDLE_S;
+    config.keep_alive_interval = HTTPD_KEEPALIVE_INTVL_S;
+    config.keep_alive_count = HTTPD_KEEPALIVE_COUNT;
     httpd_handle_t server = NULL;
 
+    start_async_req_workers();
+    auth_init();
+
     if (httpd_start(&server, &config) == ESP_OK) {
         httpd_uri_t uri_root = { .uri = "/", .method = HTTP_GET, .handler = webpage_get_handler };
         httpd_register_uri_handler(server, &uri_root);
@@ -198,9 +874,36 @@ httpd_handle_t start_webserver(void)
         httpd_uri_t uri_status = { .uri = "/api/status", .method = HTTP_GET, .handler = status_get_handler };
         httpd_register_uri_handler(server, &uri_status);
 
+        httpd_uri_t uri_boot = { .uri = "/api/boot", .method = HTTP_GET, .handler = boot_get_handler };
+        httpd_register_uri_handler(server, &uri_boot);
+
         httpd_uri_t uri_settings = { .uri = "/api/settings", .method = HTTP_POST, .handler = settings_post_handler };
         httpd_register_uri_handler(server, &uri_settings);
 
+        httpd_uri_t uri_zones = { .uri = "/api/zones", .method = HTTP_POST, .handler = zones_post_handler };
+        httpd_register_uri_handler(server, &uri_zones);
+
+        httpd_uri_t uri_calib_get = { .uri = "/api/calib", .method = HTTP_GET, .handler = calib_get_handler };
+        httpd_register_uri_handler(server, &uri_calib_get);
+
+        httpd_uri_t uri_calib_post = { .uri = "/api/calib", .method = HTTP_POST, .handler = calib_post_handler };
+        httpd_register_uri_handler(server, &uri_calib_post);
+
+        httpd_uri_t uri_wifi_get = { .uri = "/api/wifi", .method = HTTP_GET, .handler = wifi_get_handler };
+        httpd_register_uri_handler(server, &uri_wifi_get);
+
+        httpd_uri_t uri_wifi_post = { .uri = "/api/wifi", .method = HTTP_POST, .handler = wifi_post_handler };
+        httpd_register_uri_handler(server, &uri_wifi_post);
+
+        httpd_uri_t uri_pin_post = { .uri = "/api/pin", .method = HTTP_POST, .handler = pin_post_handler };
+        httpd_register_uri_handler(server, &uri_pin_post);
+
+        httpd_uri_t uri_login = { .uri = "/api/login", .method = HTTP_POST, .handler = login_post_handler };
+        httpd_register_uri_handler(server, &uri_login);
+
+        httpd_uri_t uri_logout = { .uri = "/api/logout", .method = HTTP_POST, .handler = logout_post_handler };
+        httpd_register_uri_handler(server, &uri_logout);
+
         httpd_uri_t uri_ota = { .uri = "/ota", .method = HTTP_POST, .handler = ota_update_post_handler };
         httpd_register_uri_handler(server, &uri_ota);
 
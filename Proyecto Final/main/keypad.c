@@ -1,5 +1,8 @@
 #include "Keypad.h"
 #include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
 
 static const char *TAG = "KEYPAD";
 
@@ -16,6 +19,20 @@ const char keys[4][4] = {
 const gpio_num_t rowPins[4] = { R1_PIN, R2_PIN, R3_PIN, R4_PIN };
 const gpio_num_t colPins[4] = { C1_PIN, C2_PIN, C3_PIN, C4_PIN };
 
+// Las filas se manejan con los registros W1TS/W1TC (GPIO 0..31)
+_Static_assert(R1_PIN < 32 && R2_PIN < 32 && R3_PIN < 32 && R4_PIN < 32,
+               "Las filas del teclado deben ser GPIO 0..31");
+
+#define KEYPAD_SETTLE_US   2    // Pull-up interno (~45k) + cableado: la columna sube en ~1 us
+#define KEYPAD_DEBOUNCE_MS 20
+#define KEYPAD_QUEUE_LEN   8
+
+static uint16_t stable;                     // Estado sin rebotes (bit = KEYPAD_BIT)
+static char queue[KEYPAD_QUEUE_LEN];        // Teclas presionadas aún no leídas
+static uint8_t q_head, q_count;
+static uint16_t ghosted;                    // Último estado descartado por fantasma
+static uint32_t ghost_scans;
+
 void keypad_init(void)
 {
     // Configurar FILAS como SALIDAS (OUTPUT)
@@ -37,42 +54,98 @@ void keypad_init(void)
     ESP_LOGI(TAG, "Keypad inicializado al estilo Arduino.");
 }
 
-char keypad_get_key(void)
+static inline uint32_t pin_low(uint32_t in_lo, uint32_t in_hi, gpio_num_t pin)
 {
-    char key = '\0'; // Carácter nulo por defecto
+    uint32_t in = (pin < 32) ? in_lo : in_hi;
+    return ((in >> (pin & 31)) & 1) ^ 1;
+}
+
+uint16_t keypad_scan(void)
+{
+    uint16_t bitmap = 0;
 
-    // Algoritmo de Escaneo (Idéntico a la librería Keypad.h de Arduino)
     for (int r = 0; r < 4; r++) {
-        // 1. Activar Fila actual (Ponerla en LOW)
-        gpio_set_level(rowPins[r], 0);
+        // Fila en LOW, esperar a que las columnas se asienten y leer las
+        // cuatro de una vez (las columnas 32/33 están en el segundo registro)
+        REG_WRITE(GPIO_OUT_W1TC_REG, 1u << rowPins[r]);
+        esp_rom_delay_us(KEYPAD_SETTLE_US);
+        uint32_t in_lo = REG_READ(GPIO_IN_REG);
+        uint32_t in_hi = REG_READ(GPIO_IN1_REG);
+        REG_WRITE(GPIO_OUT_W1TS_REG, 1u << rowPins[r]);
 
-        // 2. Revisar todas las Columnas
         for (int c = 0; c < 4; c++) {
-            // Si la columna lee 0 (LOW), significa que el circuito se cerró
-            if (gpio_get_level(colPins[c]) == 0) {
-                
-                // Pequeño delay para evitar rebotes (Debounce)
-                vTaskDelay(pdMS_TO_TICKS(20)); 
-
-                // Confirmamos si sigue presionada
-                if (gpio_get_level(colPins[c]) == 0) {
-                    key = keys[r][c]; // Obtenemos el carácter de la matriz
-
-                    // Esperamos a que el usuario suelte la tecla (para no repetir)
-                    while (gpio_get_level(colPins[c]) == 0) {
-                        vTaskDelay(pdMS_TO_TICKS(10));
-                    }
-                    
-                    // Restauramos la fila a HIGH antes de salir
-                    gpio_set_level(rowPins[r], 1);
-                    return key; 
+            if (pin_low(in_lo, in_hi, colPins[c])) bitmap |= KEYPAD_BIT(r, c);
+        }
+    }
+    return bitmap;
+}
+
+// Sin diodos, tres teclas en las esquinas de un rectángulo cierran la
+// cuarta: si dos filas comparten dos o más columnas no se sabe cuál es real
+bool keypad_is_ghosted(uint16_t bitmap)
+{
+    for (int r1 = 0; r1 < 3; r1++) {
+        for (int r2 = r1 + 1; r2 < 4; r2++) {
+            uint8_t common = (bitmap >> (4 * r1)) & (bitmap >> (4 * r2)) & 0x0F;
+            if (common & (common - 1)) return true;
+        }
+    }
+    return false;
+}
+
+static void push_key(char key)
+{
+    if (q_count == KEYPAD_QUEUE_LEN) return;
+    queue[(q_head + q_count) % KEYPAD_QUEUE_LEN] = key;
+    q_count++;
+}
+
+char keypad_get_key(void)
+{
+    uint16_t now = keypad_scan();
+
+    if (now != stable && (ghosted == 0 || now != ghosted)) {
+        // Debounce: solo cuando algo cambió se confirma tras 20 ms
+        vTaskDelay(pdMS_TO_TICKS(KEYPAD_DEBOUNCE_MS));
+        if (keypad_scan() == now) {
+            if (keypad_is_ghosted(now)) {
+                // Se conserva el último estado válido hasta que suelten alguna
+                ghosted = now;
+                ghost_scans++;
+            } else {
+                ghosted = 0;
+                // Rollover: cada tecla nueva es un evento aunque otras sigan
+                // presionadas (en orden de la matriz si llegan juntas)
+                uint16_t pressed = now & ~stable;
+                for (int i = 0; i < 16; i++) {
+                    if (pressed & (1u << i)) push_key(keys[i / 4][i % 4]);
                 }
+                stable = now;
             }
         }
+    }
 
-        // 3. Desactivar Fila actual (Volver a ponerla en HIGH)
-        gpio_set_level(rowPins[r], 1);
+    if (q_count == 0) return '\0'; // Ninguna tecla presionada
+    char key = queue[q_head];
+    q_head = (q_head + 1) % KEYPAD_QUEUE_LEN;
+    q_count--;
+    return key;
+}
+
+uint16_t keypad_get_state(void)
+{
+    return stable;
+}
+
+uint16_t keypad_key_bit(char key)
+{
+    for (int i = 0; i < 16; i++) {
+        if (keys[i / 4][i % 4] == key) return 1u << i;
     }
+    return 0;
+}
 
-    return '\0'; // Ninguna tecla presionada
+uint32_t keypad_ghost_count(void)
+{
+    return ghost_scans;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef KEYPAD_H
 #define KEYPAD_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -19,8 +21,28 @@
 #define C3_PIN GPIO_NUM_33
 #define C4_PIN GPIO_NUM_32
 
+// Bit de cada tecla en el mapa de 16 bits (fila r, columna c)
+#define KEYPAD_BIT(r, c) (1u << ((r) * 4 + (c)))
+
 // Declaración de funciones
 void keypad_init(void);
+
+// Próxima tecla presionada o '\0'. No espera a que la suelten: con varias
+// presionadas a la vez cada una llega una vez (rollover). Solo demora
+// 20 ms (debounce) en el ciclo en que algo cambió.
 char keypad_get_key(void);
 
+// Un barrido directo por registros (4 escrituras + 8 lecturas): mapa de las
+// teclas presionadas ahora, sin debounce.
+uint16_t keypad_scan(void);
+
+// Teclas que siguen presionadas (con debounce), para combinaciones:
+// (keypad_get_state() & (keypad_key_bit('*') | keypad_key_bit('#'))) == ...
+uint16_t keypad_get_state(void);
+uint16_t keypad_key_bit(char key);
+
+// true si el mapa es ambiguo (tres esquinas de un rectángulo cierran la cuarta)
+bool keypad_is_ghosted(uint16_t bitmap);
+uint32_t keypad_ghost_count(void);
+
 #endif // KEYPAD_H
\ No newline at end of file
@@ -11,6 +11,12 @@
 #include <time.h>
 #include <sys/time.h>
 #include "LedRGB.h"
+#include "Schedule.h"
+#include "Settings.h"
+#include "Zones.h"
+#include "PowerMgmt.h"
+#include "BootProfile.h"
+#include "TimeSync.h"
 
 
 // --- TUS LIBRERÍAS DE HARDWARE ---
@@ -18,6 +24,9 @@
 #include "Sensor.h"
 #include "Temp_LM35.h"
 #include "Display.h"
+#include "Widgets.h"
+#include "Menu.h"
+#include "Pin.h"
 #include "Keypad.h"
 
 // --- TUS LIBRERÍAS DE INTERNET ---
@@ -29,57 +38,30 @@ static const char *TAG = "MAIN_APP";
 // ==========================================================
 // 1. VARIABLES GLOBALES (Compartidas con Web y Hardware)
 // ==========================================================
-// Variables de Lógica de Control
-int system_mode = 0;        // 0:Manual, 1:Auto, 2:Prog
-int manual_pwm_val = 0;     // Valor seteado desde la Web
+// Variables de Lógica de Control (la configuración vive en Settings.c,
+// el estado de cada ventilador en Zones.c; aquí se refleja la zona 0)
 float current_temp = 0.0;
 bool pir_state = false;
 int current_pwm_output = 0; // Lo que realmente va al motor
-float auto_tmin = 20.0;
-float auto_tmax = 30.0;
-
-// Estructura para Horarios (Requerida por http_server.c)
-typedef struct {
-    bool active;
-    int start_hour;
-    int end_hour;
-    float t_zero;
-    float t_hundred;
-} schedule_t;
-
-schedule_t schedules[3] = {
-    {false, 8, 12, 20.0, 30.0},
-    {false, 14, 18, 22.0, 32.0},
-    {false, 20, 23, 18.0, 25.0}
-};
 
 // Variables de SEGURIDAD (Keypad)
 bool is_locked = true;       // El sistema inicia bloqueado
-char input_buffer[10] = "";  // Buffer para guardar la clave tecleada
-const char MASTER_PASS[] = "1234"; // CLAVE MAESTRA
+char input_buffer[10] = "";  // Buffer para guardar la clave tecleada (PIN en Pin.c)
 
 // ==========================================================
 // 2. FUNCIÓN DE CARGA DE DATOS (NVS)
 // ==========================================================
 void load_settings_from_nvs() {
-    nvs_handle_t my_handle;
-    if (nvs_open("storage", NVS_READONLY, &my_handle) == ESP_OK) {
-        int32_t val = 0;
-        if(nvs_get_i32(my_handle, "sys_mode", &val) == ESP_OK) system_mode = val;
-        if(nvs_get_i32(my_handle, "man_pwm", &val) == ESP_OK) manual_pwm_val = val;
-        if(nvs_get_i32(my_handle, "auto_tmin", &val) == ESP_OK) auto_tmin = val / 100.0;
-        if(nvs_get_i32(my_handle, "auto_tmax", &val) == ESP_OK) auto_tmax = val / 100.0;
-        
-        // Cargar horarios (simplificado para brevedad)
-        char key[16];
-        for(int i=0; i<3; i++) {
-             if(nvs_get_i32(my_handle, (sprintf(key,"sch%d_act",i),key), &val) == ESP_OK) schedules[i].active = val;
-             if(nvs_get_i32(my_handle, (sprintf(key,"sch%d_sh",i),key), &val) == ESP_OK) schedules[i].start_hour = val;
-             if(nvs_get_i32(my_handle, (sprintf(key,"sch%d_eh",i),key), &val) == ESP_OK) schedules[i].end_hour = val;
-             if(nvs_get_i32(my_handle, (sprintf(key,"sch%d_t0",i),key), &val) == ESP_OK) schedules[i].t_zero = val / 100.0;
-             if(nvs_get_i32(my_handle, (sprintf(key,"sch%d_t1",i),key), &val) == ESP_OK) schedules[i].t_hundred = val / 100.0;
-        }
-        nvs_close(my_handle);
+    settings_load_nvs(); // Configuración y horarios (un solo registro, ver Settings.c)
+    zones_load_nvs();
+    temp_sensor_load_calibration();
+}
+
+static void init_nvs(void) {
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        nvs_flash_init();
     }
 }
 
@@ -89,32 +71,49 @@ void load_settings_from_nvs() {
 void system_control_task(void *pvParameters)
 {
     char key;
+    zone_state_t zone0;
+
+    // Copia local de la configuración: solo se relee si cambió la generación
+    settings_t cfg;
+    uint32_t cfg_gen = settings_get(&cfg);
+
     while (1) {
+        if (cfg_gen != settings_generation()) {
+            cfg_gen = settings_get(&cfg);
+        }
+
         // --- A. LEER ENTRADAS ---
-        pir_state = sensors_get_pir_state(); // Usamos tu librería Sensor.h
-        current_temp = temp_sensor_read_celsius(); // Usamos tu librería Temp_LM35.h
+        zones_read_inputs(); // LM35 y PIR de cada zona (Temp_LM35.h, Sensor.h)
         key = keypad_get_key(); // Usamos tu librería Keypad.h
         
 
         // --- B. LÓGICA DE TECLADO (SEGURIDAD) ---
-        if (key != '\0') {
-            ESP_LOGI(TAG, "Tecla: %c", key);
+        if (key != '\0' && menu_is_open()) {
+            // Menú de configuración: todas las teclas son del menú
+            menu_handle_key(key);
+        }
+        else if (key != '\0') {
+            // Los dígitos no se registran: son el PIN
+            if (key < '0' || key > '9') ESP_LOGI(TAG, "Tecla: %c", key);
             
-            if (key == '*') { 
+            if (key == 'A' && !is_locked) {
+                // A: menú de configuración local (ver Menu.h)
+                menu_open();
+            }
+            else if (key == '*') { 
                 // Asterisco: Borrar / Bloquear
                 memset(input_buffer, 0, sizeof(input_buffer));
                 is_locked = true; 
             } 
             else if (key == '#') {
-                // Numeral: Confirmar contraseña
-                if (strcmp(input_buffer, MASTER_PASS) == 0) {
+                // Numeral: Confirmar contraseña (hash + espera tras varios errores)
+                pin_result_t res = pin_check(input_buffer);
+                if (res == PIN_OK) {
                     is_locked = false; // ¡DESBLOQUEADO!
-                    memset(input_buffer, 0, sizeof(input_buffer));
-                } else {
-                    // Clave incorrecta
-                    memset(input_buffer, 0, sizeof(input_buffer));
-                    // Aquí podrías poner un mensaje de error temporal en el OLED si quisieras
+                } else if (res == PIN_WRONG) {
+                    ESP_LOGW(TAG, "PIN incorrecto");
                 }
+                memset(input_buffer, 0, sizeof(input_buffer));
             } 
             else {
                 // Números: Agregar al buffer
@@ -126,67 +125,59 @@ void system_control_task(void *pvParameters)
             }
         }
 
-        // --- C. LÓGICA DE CONTROL (VENTILADOR) ---
-        int target_pwm = 0;
-
-        if (is_locked) {
-            // SI ESTÁ BLOQUEADO: Motor apagado siempre
-            target_pwm = 0;
-        } 
-        else {
-            // SI ESTÁ DESBLOQUEADO: Usar lógica normal
-            
-            // 1. MANUAL
-            if (system_mode == 0) target_pwm = manual_pwm_val;
-            
-            // 2. AUTO
-            else if (system_mode == 1) {
-                if (!pir_state) target_pwm = 0;
-                else {
-                    if (current_temp <= auto_tmin) target_pwm = 0;
-                    else if (current_temp >= auto_tmax) target_pwm = 100;
-                    else target_pwm = (int)((current_temp - auto_tmin) * 100 / (auto_tmax - auto_tmin));
-                }
-            }
-            
-            // 3. PROGRAMADO
-            else if (system_mode == 2) {
-                time_t now; struct tm timeinfo; time(&now); localtime_r(&now, &timeinfo);
-                int h = timeinfo.tm_hour;
-                target_pwm = 0;
-                if (pir_state) {
-                    for(int i=0; i<3; i++) {
-                        if(schedules[i].active && h >= schedules[i].start_hour && h < schedules[i].end_hour) {
-                            float t0 = schedules[i].t_zero; float t100 = schedules[i].t_hundred;
-                            if (current_temp <= t0) target_pwm = 0;
-                            else if (current_temp >= t100) target_pwm = 100;
-                            else target_pwm = (int)((current_temp - t0) * 100 / (t100 - t0));
-                            break;
-                        }
-                    }
-                }
-            }
+        // --- C. LÓGICA DE CONTROL (VENTILADORES) ---
+        // Bloqueado: todos los motores apagados; si no, cada zona según su modo
+        bool fan_on = zones_update(&cfg, cfg_gen, is_locked, time(NULL));
+        power_set_fan_active(fan_on); // El LEDC no puede dormir con un motor girando
+        power_mark_control_ready();
+
+        zones_get_state(&zone0, 1);
+        current_temp = zone0.temp;
+        pir_state = zone0.pir;
+        current_pwm_output = zone0.pwm;
+        widget_spark_feed(current_temp); // También con el menú abierto
+
+        // Copia en memoria RTC para arrancar rápido tras un reset o deep sleep
+        power_rtc_state_t st = {
+            .system_mode = cfg.system_mode,
+            .manual_pwm = cfg.manual_pwm,
+            .auto_tmin_cc = (int32_t)(cfg.auto_tmin * 100),
+            .auto_tmax_cc = (int32_t)(cfg.auto_tmax * 100),
+        };
+        power_rtc_save(&st);
+
+        // Bloqueado y sin nadie en la sala: deep sleep (despierta con PIR o timer)
+        if (power_idle_tick(is_locked, zones_any_motion())) {
+            zones_stop_all();
+            display_set_power(false);
+            display_power_wait(100); // Que el 0xAE salga antes de dormir
+            power_enter_deep_sleep(&st);
         }
 
-        // Aplicar al Motor
-        motor_set_speed_percent(target_pwm); // Usamos tu librería Motor.h
-        current_pwm_output = target_pwm;
-
-        led_rgb_update(is_locked);
+        uint32_t lockout_ms = pin_lockout_remaining_ms();
+        if (lockout_ms > 0) led_rgb_lockout();
+        else led_rgb_update(is_locked);
 
         // --- D. ACTUALIZAR PANTALLA OLED ---
         // Usamos tu librería Display.h
-        if (is_locked) {
-            display_update_ui("BLOQUEADO", input_buffer, 0, current_temp);
+        if (is_locked && lockout_ms > 0) {
+            char wait_str[16];
+            snprintf(wait_str, sizeof(wait_str), "ESPERE %lus", (unsigned long)((lockout_ms + 999) / 1000));
+            display_update_ui(wait_str, input_buffer, 0, current_temp, true, zones_any_fault());
+        } else if (is_locked) {
+            display_update_ui("BLOQUEADO", input_buffer, 0, current_temp, true, zones_any_fault());
+        } else if (menu_is_open()) {
+            menu_render(); // Solo se reenvían las líneas que cambiaron
         } else {
             // Mostrar modo en pantalla
             char mode_str[10];
-            if(system_mode==0) strcpy(mode_str, "MANUAL");
-            else if(system_mode==1) strcpy(mode_str, "AUTO");
+            if(cfg.system_mode==SETTINGS_MODE_MANUAL) strcpy(mode_str, "MANUAL");
+            else if(cfg.system_mode==SETTINGS_MODE_AUTO) strcpy(mode_str, "AUTO");
             else strcpy(mode_str, "PROG");
             
-            display_update_ui(mode_str, "OK", target_pwm, current_temp);
+            display_update_ui(mode_str, "OK", current_pwm_output, current_temp, false, zones_any_fault());
         }
+        display_submit(); // Solo copia el cuadro: el I2C corre en la tarea del display
 
         // Pequeño delay para no saturar la CPU
         vTaskDelay(pdMS_TO_TICKS(100));
@@ -198,28 +189,60 @@ void system_control_task(void *pvParameters)
 // ==========================================================
 void app_main(void)
 {
-    // 1. NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        nvs_flash_init();
-    }
-    load_settings_from_nvs();
+    // Arranque por etapas: primero motor + control (con el estado en RTC o NVS),
+    // después pantalla, horarios y red en segundo plano. Ver BootProfile.h.
+    boot_profile_mark("app_main");
+
+    // 0. ENERGÍA (light sleep automático + causa de despertar)
+    power_init();
 
-    // 2. INICIALIZAR HARDWARE (Tus librerías)
-    motor_init();
-    sensors_init();   // PIR
-    temp_sensor_init(); // LM35
-    display_init();     // OLED
+    // 1. HARDWARE CRÍTICO (motor en 0% cuanto antes)
+    zones_init();       // Motor, LM35 y PIR de cada zona
     keypad_init();      // Teclado
     led_rgb_init();
+    boot_profile_mark("hardware");
+
+    // 2. ESTADO: memoria RTC (reset por software / deep sleep) o NVS
+    power_rtc_state_t st;
+    bool from_rtc = power_rtc_restore(&st);
+    if (from_rtc) {
+        settings_t cfg = {
+            .system_mode = st.system_mode,
+            .manual_pwm = st.manual_pwm,
+            .auto_tmin = st.auto_tmin_cc / 100.0,
+            .auto_tmax = st.auto_tmax_cc / 100.0,
+        };
+        settings_init(&cfg);
+        boot_profile_mark("estado_rtc");
+    } else {
+        init_nvs();
+        boot_profile_mark("nvs");
+        load_settings_from_nvs();
+        pin_init();
+        boot_profile_mark("estado_nvs");
+    }
 
-    // 3. INICIALIZAR INTERNET
-    wifi_app_start(); // Esto arranca el WiFi y luego el WebServer automáticamente
-
-    // 4. INICIALIZAR TAREA DE CONTROL
+    // 3. TAREA DE CONTROL (desde aquí el ventilador ya responde)
     // La fijamos al Core 1 para dejar el Core 0 al WiFi
     xTaskCreatePinnedToCore(system_control_task, "SystemCtrl", 4096, NULL, 5, NULL, 1);
-    
+
+    // 4. ETAPAS DIFERIDAS (el control ya corre en paralelo)
+    if (from_rtc) {
+        init_nvs(); // WiFi y horarios la necesitan, el control no
+        boot_profile_mark("nvs");
+        settings_load_nvs(); // El horario no viaja en RTC: se recarga junto con la configuración
+        zones_load_nvs();
+        temp_sensor_load_calibration();
+        pin_init();     // Hasta aquí pin_check() responde PIN_LOCKED
+        boot_profile_mark("horarios");
+    }
+    time_sync_init();   // Última hora conocida (NVS) hasta que responda el SNTP
+    boot_profile_mark("hora");
+    display_init();     // OLED (hasta aquí display_update_ui no hace nada)
+    boot_profile_mark("display");
+
+    wifi_app_start(); // Esto arranca el WiFi y luego el WebServer (SNTP al obtener IP)
+    boot_profile_mark("wifi_start");
+
     ESP_LOGI(TAG, "SISTEMA INICIADO COMPLETO");
 }
\ No newline at end of file
@@ -23,4 +23,15 @@
 #define HTTP_SERVER_MONITOR_PRIORITY		3
 #define HTTP_SERVER_MONITOR_CORE_ID			0
 
+// HTTP Server workers (handlers largos como OTA)
+#define HTTP_SERVER_WORKER_COUNT			2
+#define HTTP_SERVER_WORKER_STACK_SIZE		6144
+#define HTTP_SERVER_WORKER_PRIORITY			3
+#define HTTP_SERVER_WORKER_CORE_ID			0
+
+// Display OLED (dibuja los cuadros que entrega la tarea de control)
+#define DISPLAY_TASK_STACK_SIZE				3072
+#define DISPLAY_TASK_PRIORITY				2
+#define DISPLAY_TASK_CORE_ID				1
+
 #endif /* MAIN_TASKS_COMMON_H_ */
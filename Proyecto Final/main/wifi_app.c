@@ -2,16 +2,19 @@
 #include "freertos/event_groups.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
+#include <string.h>
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_wifi.h"
 #include "lwip/netdb.h"
 #include "nvs.h"
-#include "esp_sntp.h"
+#include "esp_timer.h"
+#include "TimeSync.h"
 
 #include "tasks_common.h"
 #include "wifi_app.h"
 #include "http_server.h" 
+#include "BootProfile.h"
 
 static const char TAG [] = "wifi_app";
 
@@ -21,30 +24,122 @@ static QueueHandle_t wifi_app_queue_handle;
 esp_netif_t* esp_netif_sta = NULL;
 esp_netif_t* esp_netif_ap  = NULL;
 
-// 1. MANEJO DE TIEMPO (NTP)
-static void obtain_time(void)
-{   
-    setenv("TZ", "EST5", 1); // UTC-5
-    tzset();
+// Estado del gestor de reconexión STA
+static esp_timer_handle_t reconnect_timer = NULL;
+static bool sta_has_credentials = false;
+static bool sta_connected = false;
+static uint32_t sta_retries = 0;          // Intentos desde la última caída
+static uint32_t sta_reconnects = 0;       // Reconexiones exitosas totales
+static uint8_t sta_last_reason = 0;
+static int64_t sta_lost_us = 0;           // Momento de la caída
+static int64_t sta_connected_us = 0;      // Momento en que se obtuvo IP
+static uint32_t sta_last_reconnect_ms = 0;
+static uint8_t sta_cached_bssid[6];
+static uint8_t sta_cached_channel = 0;    // 0 = sin caché (escaneo completo)
 
-    ESP_LOGI(TAG, "Inicializando SNTP...");
-    esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
-    esp_sntp_setservername(0, "pool.ntp.org");
-    esp_sntp_init();
+// 1. MANEJO DE TIEMPO (NTP): ver TimeSync.c (asíncrono, por callback)
 
-    time_t now = 0;
-    struct tm timeinfo = {0};
-    int retry = 0;
-    const int retry_count = 10;
+// 1.1 CREDENCIALES Y CACHÉ DEL AP EN NVS (namespace "wifi")
+static void wifi_app_load_credentials(void)
+{
+    nvs_handle_t h;
+    if (nvs_open("wifi", NVS_READONLY, &h) != ESP_OK) return;
 
-    while (timeinfo.tm_year < (2016 - 1900) && ++retry < retry_count)
-    {
-        ESP_LOGI(TAG, "Esperando hora... (%d/%d)", retry, retry_count);
-        vTaskDelay(2000 / portTICK_PERIOD_MS);
-        time(&now);
-        localtime_r(&now, &timeinfo);
+    // sta.ssid no termina en NUL si el SSID tiene los 32 caracteres: se lee
+    // en un buffer de 33 y se copia el largo exacto
+    char ssid[MAX_SSID_LENGTH + 1];
+    size_t len = sizeof(ssid);
+    if (nvs_get_str(h, "ssid", ssid, &len) == ESP_OK && len > 1) {
+        memcpy(wifi_config->sta.ssid, ssid, len - 1);
+        len = sizeof(wifi_config->sta.password);
+        nvs_get_str(h, "pass", (char *)wifi_config->sta.password, &len);
+        sta_has_credentials = true;
+
+        len = sizeof(sta_cached_bssid);
+        if (nvs_get_blob(h, "bssid", sta_cached_bssid, &len) != ESP_OK ||
+            nvs_get_u8(h, "chan", &sta_cached_channel) != ESP_OK) {
+            sta_cached_channel = 0;
+        }
     }
-    ESP_LOGI(TAG, "Hora sincronizada!");
+    nvs_close(h);
+}
+
+static void wifi_app_save_ap_cache(const uint8_t *bssid, uint8_t channel)
+{
+    if (channel == sta_cached_channel && memcmp(bssid, sta_cached_bssid, 6) == 0) return;
+    memcpy(sta_cached_bssid, bssid, 6);
+    sta_cached_channel = channel;
+
+    nvs_handle_t h;
+    if (nvs_open("wifi", NVS_READWRITE, &h) == ESP_OK) {
+        nvs_set_blob(h, "bssid", bssid, 6);
+        nvs_set_u8(h, "chan", channel);
+        nvs_commit(h);
+        nvs_close(h);
+    }
+}
+
+esp_err_t wifi_app_set_credentials(const char *ssid, const char *password)
+{
+    if (ssid == NULL || strlen(ssid) == 0 || strlen(ssid) > MAX_SSID_LENGTH) return ESP_ERR_INVALID_ARG;
+    if (password == NULL) password = "";
+    if (strlen(password) >= MAX_PASSWORD_LENGTH) return ESP_ERR_INVALID_ARG;
+
+    nvs_handle_t h;
+    esp_err_t err = nvs_open("wifi", NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+    nvs_set_str(h, "ssid", ssid);
+    nvs_set_str(h, "pass", password);
+    nvs_erase_key(h, "bssid"); // Red nueva: la caché ya no sirve
+    nvs_erase_key(h, "chan");
+    err = nvs_commit(h);
+    nvs_close(h);
+    if (err != ESP_OK) return err;
+
+    xSemaphoreTake(mySemaphore, portMAX_DELAY);
+    memset(&wifi_config->sta, 0, sizeof(wifi_config->sta));
+    memcpy(wifi_config->sta.ssid, ssid, strlen(ssid));     // Hasta 32, sin NUL si está lleno
+    strlcpy((char *)wifi_config->sta.password, password, sizeof(wifi_config->sta.password));
+    sta_cached_channel = 0;
+    sta_has_credentials = true;
+    xSemaphoreGive(mySemaphore);
+
+    wifi_app_send_message(WIFI_APP_MSG_CONNECTING_FROM_HTTP_SERVER);
+    return ESP_OK;
+}
+
+void wifi_app_get_sta_metrics(wifi_app_sta_metrics_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    xSemaphoreTake(mySemaphore, portMAX_DELAY);
+    memcpy(out->ssid, wifi_config->sta.ssid, strnlen((const char *)wifi_config->sta.ssid, MAX_SSID_LENGTH));
+    xSemaphoreGive(mySemaphore);
+
+    out->connected = sta_connected;
+    out->retries = sta_retries;
+    out->reconnects = sta_reconnects;
+    out->last_reason = sta_last_reason;
+    out->last_reconnect_ms = sta_last_reconnect_ms;
+    if (sta_connected) {
+        out->uptime_s = (uint32_t)((esp_timer_get_time() - sta_connected_us) / 1000000);
+        wifi_ap_record_t ap;
+        if (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) out->rssi = ap.rssi;
+    }
+}
+
+// 1.2 RECONEXIÓN CON BACKOFF EXPONENCIAL
+static void wifi_app_reconnect_timer_cb(void *arg)
+{
+    wifi_app_send_message_from_cb(WIFI_APP_CONNECT_TO_STA);
+}
+
+static uint32_t wifi_app_backoff_ms(uint32_t retry)
+{
+    // Primer intento inmediato (reconexión rápida con BSSID/canal en caché),
+    // luego 250 ms, 500 ms, 1 s ... hasta WIFI_STA_BACKOFF_MAX_MS
+    if (retry == 0) return 0;
+    uint32_t ms = WIFI_STA_BACKOFF_BASE_MS << (retry - 1 < 8 ? retry - 1 : 8);
+    return ms < WIFI_STA_BACKOFF_MAX_MS ? ms : WIFI_STA_BACKOFF_MAX_MS;
 }
 
 // 2. EVENT HANDLER
@@ -55,8 +150,19 @@ static void wifi_app_event_handler(void *arg, esp_event_base_t event_base, int32
         switch (event_id) {
             case WIFI_EVENT_AP_START: ESP_LOGI(TAG, "AP Iniciado"); break;
             case WIFI_EVENT_STA_START: ESP_LOGI(TAG, "STA Iniciado"); break;
-            case WIFI_EVENT_STA_CONNECTED: ESP_LOGI(TAG, "Conectado al Router"); break;
-            case WIFI_EVENT_STA_DISCONNECTED: ESP_LOGI(TAG, "Desconectado"); break;
+            case WIFI_EVENT_STA_CONNECTED: {
+                wifi_event_sta_connected_t *ev = (wifi_event_sta_connected_t *)event_data;
+                ESP_LOGI(TAG, "Conectado al Router (canal %d)", ev->channel);
+                wifi_app_save_ap_cache(ev->bssid, ev->channel);
+                break;
+            }
+            case WIFI_EVENT_STA_DISCONNECTED: {
+                wifi_event_sta_disconnected_t *ev = (wifi_event_sta_disconnected_t *)event_data;
+                ESP_LOGI(TAG, "Desconectado (motivo %d)", ev->reason);
+                sta_last_reason = ev->reason;
+                wifi_app_send_message_from_cb(WIFI_APP_MSG_STA_DISCONNECTED);
+                break;
+            }
         }
     }
     else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP)
@@ -116,10 +222,32 @@ static void wifi_app_soft_ap_config(void)
 
 static void wifi_app_connect_sta(void)
 {
-    // Aquí puedes hardcodear tu red de casa si no usas la app
-    // wifi_config->sta.ssid = ...
-    ESP_ERROR_CHECK(esp_wifi_set_config(ESP_IF_WIFI_STA, wifi_app_get_wifi_config()));
-    ESP_ERROR_CHECK(esp_wifi_connect());
+    if (!sta_has_credentials) return;
+
+    // Con BSSID/canal en caché se salta el escaneo completo (reconexión en ms);
+    // tras varios fallos se vuelve al escaneo por si el AP cambió de canal
+    bool use_cache = sta_cached_channel != 0 && sta_retries < MAX_CONNECTION_RETRIES;
+
+    xSemaphoreTake(mySemaphore, portMAX_DELAY);
+    wifi_config->sta.bssid_set = use_cache;
+    wifi_config->sta.channel = use_cache ? sta_cached_channel : 0;
+    if (use_cache) memcpy(wifi_config->sta.bssid, sta_cached_bssid, 6);
+    esp_err_t err = esp_wifi_set_config(ESP_IF_WIFI_STA, wifi_app_get_wifi_config());
+    xSemaphoreGive(mySemaphore);
+
+    if (err == ESP_OK) err = esp_wifi_connect();
+    if (err != ESP_OK) ESP_LOGW(TAG, "esp_wifi_connect: %s", esp_err_to_name(err));
+}
+
+static void wifi_app_schedule_reconnect(void)
+{
+    if (!sta_has_credentials) return;
+    uint32_t delay_ms = wifi_app_backoff_ms(sta_retries);
+    sta_retries++;
+    ESP_LOGI(TAG, "Reintento %lu en %lu ms", (unsigned long)sta_retries, (unsigned long)delay_ms);
+    esp_timer_stop(reconnect_timer);
+    if (delay_ms == 0) wifi_app_connect_sta();
+    else esp_timer_start_once(reconnect_timer, (uint64_t)delay_ms * 1000);
 }
 
 static void wifi_app_task(void *pvParameters)
@@ -130,7 +258,15 @@ static void wifi_app_task(void *pvParameters)
     wifi_app_soft_ap_config();
     ESP_ERROR_CHECK(esp_wifi_start());
 
+    const esp_timer_create_args_t timer_args = {
+        .callback = &wifi_app_reconnect_timer_cb,
+        .name = "wifi_reconnect",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &reconnect_timer));
+
     wifi_app_send_message(WIFI_APP_MSG_START_HTTP_SERVER);
+    wifi_app_load_credentials();
+    if (sta_has_credentials) wifi_app_send_message(WIFI_APP_CONNECT_TO_STA);
 
     for (;;)
     {
@@ -141,15 +277,45 @@ static void wifi_app_task(void *pvParameters)
                 case WIFI_APP_MSG_START_HTTP_SERVER:
                     ESP_LOGI(TAG, "Iniciando WebServer...");
                     start_webserver(); 
+                    boot_profile_mark("httpd");
+                    boot_profile_report();
                     break;
 
                 case WIFI_APP_MSG_CONNECTING_FROM_HTTP_SERVER:
+                    // Credenciales nuevas: cortar la conexión actual y empezar de cero
+                    esp_timer_stop(reconnect_timer);
+                    sta_retries = 0;
+                    if (sta_connected) esp_wifi_disconnect(); // El evento de desconexión reconecta
+                    else wifi_app_connect_sta();
+                    break;
+
+                case WIFI_APP_CONNECT_TO_STA:
                     wifi_app_connect_sta();
                     break;
 
+                case WIFI_APP_MSG_STA_DISCONNECTED:
+                    if (sta_connected) sta_lost_us = esp_timer_get_time();
+                    sta_connected = false;
+                    wifi_app_schedule_reconnect();
+                    break;
+
                 case WIFI_APP_MSG_STA_CONNECTED_GOT_IP:
+                    esp_timer_stop(reconnect_timer);
+                    sta_connected = true;
+                    sta_connected_us = esp_timer_get_time();
+                    if (sta_lost_us != 0) {
+                        sta_reconnects++;
+                        sta_last_reconnect_ms = (uint32_t)((sta_connected_us - sta_lost_us) / 1000);
+                        ESP_LOGI(TAG, "Reconectado en %lu ms", (unsigned long)sta_last_reconnect_ms);
+                        sta_lost_us = 0;
+                    }
+                    sta_retries = 0;
                     ESP_LOGI(TAG, "Conectado. Obteniendo Hora...");
-                    obtain_time(); 
+                    time_sync_start(); // No bloquea: la hora llega por callback
+                    break;
+
+                case WIFI_APP_MSG_TIME_SYNCED:
+                    time_sync_persist();
                     break;
                 default: break;
             }
@@ -164,6 +330,13 @@ BaseType_t wifi_app_send_message(wifi_app_message_e msgID)
     return xQueueSend(wifi_app_queue_handle, &msg, portMAX_DELAY);
 }
 
+BaseType_t wifi_app_send_message_from_cb(wifi_app_message_e msgID)
+{
+    wifi_app_queue_message_t msg;
+    msg.msgID = msgID;
+    return xQueueSend(wifi_app_queue_handle, &msg, 0);
+}
+
 wifi_config_t* wifi_app_get_wifi_config(void) { return wifi_config; }
 
 void wifi_app_start(void)
@@ -172,7 +345,7 @@ void wifi_app_start(void)
     esp_log_level_set("wifi", ESP_LOG_NONE);
     wifi_config = (wifi_config_t*)malloc(sizeof(wifi_config_t));
     memset(wifi_config, 0x00, sizeof(wifi_config_t));
-    wifi_app_queue_handle = xQueueCreate(3, sizeof(wifi_app_queue_message_t));
+    wifi_app_queue_handle = xQueueCreate(8, sizeof(wifi_app_queue_message_t));
     mySemaphore = xSemaphoreCreateBinary();
     xSemaphoreGive(mySemaphore);
     xTaskCreatePinnedToCore(&wifi_app_task, "wifi_app_task", 4096, NULL, 5, NULL, 0);
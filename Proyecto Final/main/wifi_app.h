@@ -8,6 +8,7 @@
 #include "esp_netif.h"
 #include "esp_wifi_types.h"
 #include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
 
 // -----------------------------------------------------
 // 1. CONFIGURACIÓN DEL PUNTO DE ACCESO (AP)
@@ -23,10 +24,16 @@
 #define WIFI_AP_GATEWAY             "192.168.0.1"       
 #define WIFI_AP_NETMASK             "255.255.255.0"     
 #define WIFI_AP_BANDWIDTH           WIFI_BW_HT20        
+#if CONFIG_VENT_POWER_SAVE
+#define WIFI_STA_POWER_SAVE         WIFI_PS_MIN_MODEM   // Necesario para el light sleep automático
+#else
 #define WIFI_STA_POWER_SAVE         WIFI_PS_NONE        
+#endif
 #define MAX_SSID_LENGTH             32                  
 #define MAX_PASSWORD_LENGTH         64                  
-#define MAX_CONNECTION_RETRIES      5                   
+#define MAX_CONNECTION_RETRIES      5                   // Intentos con BSSID en caché antes de escanear
+#define WIFI_STA_BACKOFF_BASE_MS    250                 
+#define WIFI_STA_BACKOFF_MAX_MS     30000               
 
 // Objetos de red (declaración externa)
 extern esp_netif_t* esp_netif_sta;
@@ -45,8 +52,24 @@ typedef enum wifi_app_message
     WIFI_APP_MSG_STA_CONNECTED_GOT_IP,
     WIFI_APP_MSG_STA_DISCONNECTED,
     WIFI_APP_CONNECT_TO_STA,
+    WIFI_APP_MSG_TIME_SYNCED,
 } wifi_app_message_e;
 
+/**
+ * Métricas de la conexión STA (para /api/wifi)
+ */
+typedef struct
+{
+    char ssid[MAX_SSID_LENGTH + 1];
+    bool connected;
+    int8_t rssi;
+    uint32_t uptime_s;          // Tiempo desde que se obtuvo IP
+    uint32_t retries;           // Intentos desde la última caída
+    uint32_t reconnects;        // Reconexiones exitosas
+    uint8_t last_reason;        // Último wifi_err_reason_t
+    uint32_t last_reconnect_ms; // Caída -> IP de la última reconexión
+} wifi_app_sta_metrics_t;
+
 /**
  * Estructura de la cola de mensajes
  */
@@ -70,14 +93,27 @@ void wifi_app_start(void);
  */
 BaseType_t wifi_app_send_message(wifi_app_message_e msgID);
 
+/**
+ * Igual que wifi_app_send_message pero sin esperar si la cola está llena
+ * (para callbacks de otras pilas, p. ej. SNTP en el contexto de lwIP)
+ */
+BaseType_t wifi_app_send_message_from_cb(wifi_app_message_e msgID);
+
 /**
  * Obtiene la configuración actual del WiFi
  */
 wifi_config_t* wifi_app_get_wifi_config(void);
 
 /**
- * Inicializa/Fuerza la sincronización de hora NTP
+ * Guarda SSID/clave del router en NVS y lanza la conexión STA.
+ * El SSID puede tener los 32 caracteres completos (sin NUL en sta.ssid);
+ * la clave, hasta 63.
+ */
+esp_err_t wifi_app_set_credentials(const char *ssid, const char *password);
+
+/**
+ * Copia RSSI, tiempo conectado y contadores de reconexión
  */
-void init_obtain_time(void);
+void wifi_app_get_sta_metrics(wifi_app_sta_metrics_t *out);
 
 #endif /* MAIN_WIFI_APP_H_ */
\ No newline at end of file
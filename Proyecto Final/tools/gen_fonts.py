@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""Genera las fuentes del OLED (Fonts.c) en tiempo de compilación.
+
+Fuente base: 5x7 ASCII completo (32..126) más el símbolo de grados en 0x7F.
+Los tamaños grandes salen de escalarla con Scale2x/Scale3x (suavizan las
+diagonales en vez de duplicar píxeles), así que no hace falta ninguna
+fuente externa ni bibliotecas de imágenes.
+
+Formato de cada glifo (el mismo que espera el SH1106): `pages` tiras de
+`width` bytes, una por página de 8 px; cada byte es una columna con el bit 0
+arriba. El espacio entre letras ya está incluido en `width`, de modo que
+dibujar un carácter es un memcpy por página.
+
+Uso: gen_fonts.py <salida.c>
+"""
+
+import argparse
+
+DEGREE = 0x7F
+
+# Columnas de cada carácter (bit 0 = fila de arriba)
+BASE_5X7 = """
+20 00 00 00 00 00
+21 00 00 5F 00 00
+22 07 00 07 00 00
+23 14 7F 14 7F 14
+24 24 2A 7F 2A 12
+25 23 13 08 64 62
+26 36 49 55 22 50
+27 00 05 03 00 00
+28 00 1C 22 41 00
+29 00 41 22 1C 00
+2A 14 08 3E 08 14
+2B 08 08 3E 08 08
+2C 00 50 30 00 00
+2D 08 08 08 08 08
+2E 00 60 60 00 00
+2F 20 10 08 04 02
+30 3E 51 49 45 3E
+31 00 42 7F 40 00
+32 42 61 51 49 46
+33 21 41 45 4B 31
+34 18 14 12 7F 10
+35 27 45 45 45 39
+36 3C 4A 49 49 30
+37 01 71 09 05 03
+38 36 49 49 49 36
+39 06 49 49 29 1E
+3A 00 36 36 00 00
+3B 00 56 36 00 00
+3C 08 14 22 41 00
+3D 14 14 14 14 14
+3E 00 41 22 14 08
+3F 02 01 51 09 06
+40 32 49 79 41 3E
+41 7E 11 11 11 7E
+42 7F 49 49 49 36
+43 3E 41 41 41 22
+44 7F 41 41 22 1C
+45 7F 49 49 49 41
+46 7F 09 09 09 01
+47 3E 41 49 49 7A
+48 7F 08 08 08 7F
+49 00 41 7F 41 00
+4A 20 40 41 3F 01
+4B 7F 08 14 22 41
+4C 7F 40 40 40 40
+4D 7F 02 0C 02 7F
+4E 7F 04 08 10 7F
+4F 3E 41 41 41 3E
+50 7F 09 09 09 06
+51 3E 41 51 21 5E
+52 7F 09 19 29 46
+53 46 49 49 49 31
+54 01 01 7F 01 01
+55 3F 40 40 40 3F
+56 1F 20 40 20 1F
+57 3F 40 38 40 3F
+58 63 14 08 14 63
+59 07 08 70 08 07
+5A 61 51 49 45 43
+5B 00 7F 41 41 00
+5C 02 04 08 10 20
+5D 00 41 41 7F 00
+5E 04 02 01 02 04
+5F 40 40 40 40 40
+60 00 01 02 04 00
+61 20 54 54 54 78
+62 7F 48 44 44 38
+63 38 44 44 44 20
+64 38 44 44 48 7F
+65 38 54 54 54 18
+66 08 7E 09 01 02
+67 0C 52 52 52 3E
+68 7F 08 04 04 78
+69 00 44 7D 40 00
+6A 20 40 44 3D 00
+6B 7F 10 28 44 00
+6C 00 41 7F 40 00
+6D 7C 04 18 04 78
+6E 7C 08 04 04 78
+6F 38 44 44 44 38
+70 7C 14 14 14 08
+71 08 14 14 18 7C
+72 7C 08 04 04 08
+73 48 54 54 54 20
+74 04 3F 44 40 20
+75 3C 40 40 20 7C
+76 1C 20 40 20 1C
+77 3C 40 30 40 3C
+78 44 28 10 28 44
+79 0C 50 50 50 3C
+7A 44 64 54 4C 44
+7B 00 08 36 41 00
+7C 00 00 7F 00 00
+7D 00 41 36 08 00
+7E 10 08 08 10 08
+7F 00 06 09 09 06
+"""
+
+# name, escala, ancho de celda (px), caracteres (None = 32..127 completo)
+FONTS = [
+    ("font_5x7", 1, 6, None),
+    ("font_10x16", 2, 11, None),
+    ("font_digits", 3, 17, " %+-.0123456789:C" + chr(DEGREE)),
+]
+
+
+def load_base():
+    glyphs = {}
+    for line in BASE_5X7.strip().splitlines():
+        fields = [int(x, 16) for x in line.split()]
+        code, cols = fields[0], fields[1:]
+        # Matriz [fila][columna] de 8 filas (la 8.ª queda vacía)
+        glyphs[code] = [[(cols[x] >> y) & 1 for x in range(5)] for y in range(8)]
+    return glyphs
+
+
+def pixel(img, x, y):
+    if 0 <= y < len(img) and 0 <= x < len(img[0]):
+        return img[y][x]
+    return 0
+
+
+def scale2x(img):
+    h, w = len(img), len(img[0])
+    out = [[0] * (w * 2) for _ in range(h * 2)]
+    for y in range(h):
+        for x in range(w):
+            e = img[y][x]
+            b, d = pixel(img, x, y - 1), pixel(img, x - 1, y)
+            f, hh = pixel(img, x + 1, y), pixel(img, x, y + 1)
+            e0 = d if (d == b and b != f and d != hh) else e
+            e1 = f if (b == f and b != d and f != hh) else e
+            e2 = d if (d == hh and d != b and hh != f) else e
+            e3 = f if (hh == f and d != hh and b != f) else e
+            out[2 * y][2 * x], out[2 * y][2 * x + 1] = e0, e1
+            out[2 * y + 1][2 * x], out[2 * y + 1][2 * x + 1] = e2, e3
+    return out
+
+
+def scale3x(img):
+    h, w = len(img), len(img[0])
+    out = [[0] * (w * 3) for _ in range(h * 3)]
+    for y in range(h):
+        for x in range(w):
+            a, b, c = pixel(img, x - 1, y - 1), pixel(img, x, y - 1), pixel(img, x + 1, y - 1)
+            d, e, f = pixel(img, x - 1, y), img[y][x], pixel(img, x + 1, y)
+            g, hh, i = pixel(img, x - 1, y + 1), pixel(img, x, y + 1), pixel(img, x + 1, y + 1)
+            r = [e] * 9
+            if b != hh and d != f:
+                r[0] = d if d == b else e
+                r[1] = b if (d == b and e != c) or (b == f and e != a) else e
+                r[2] = f if b == f else e
+                r[3] = d if (d == b and e != g) or (d == hh and e != a) else e
+                r[5] = f if (b == f and e != i) or (hh == f and e != c) else e
+                r[6] = d if d == hh else e
+                r[7] = hh if (d == hh and e != i) or (hh == f and e != g) else e
+                r[8] = f if hh == f else e
+            for k in range(9):
+                out[3 * y + k // 3][3 * x + k % 3] = r[k]
+    return out
+
+
+def pack(img, width, pages):
+    """Tiras por página, columna a columna; lo que sobra a la derecha es el espacio."""
+    h, w = len(img), len(img[0])
+    out = []
+    for p in range(pages):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = p * 8 + bit
+                if x < w and y < h and img[y][x]:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+
+def emit_font(name, scale, width, chars, base):
+    codes = list(range(0x20, 0x80)) if chars is None else sorted(ord(c) for c in chars)
+    pages = scale  # 8 filas base * escala / 8
+    data = []
+    comments = []
+    for code in codes:
+        img = base[code]
+        if scale == 2:
+            img = scale2x(img)
+        elif scale == 3:
+            img = scale3x(img)
+        data.append(pack(img, width, pages))
+        # Entre comillas: un \ al final de un comentario // uniría la línea siguiente
+        comments.append("grados" if code == DEGREE else f"'{chr(code)}'")
+
+    lines = [f"static const uint8_t {name}_glyphs[] = {{"]
+    for glyph, label in zip(data, comments):
+        hexes = ", ".join(f"0x{b:02X}" for b in glyph)
+        lines.append(f"    {hexes}, // {label}")
+    lines.append("};")
+    lines.append("")
+
+    index = "NULL"
+    if chars is not None:
+        slots = [0xFF] * 96
+        for slot, code in enumerate(codes):
+            slots[code - 0x20] = slot
+        lines.append(f"static const uint8_t {name}_index[96] = {{")
+        for row in range(0, 96, 16):
+            lines.append("    " + ", ".join(f"0x{s:02X}" for s in slots[row:row + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        index = f"{name}_index"
+
+    lines.append(f"const font_t {name} = {{")
+    lines.append(f"    .width = {width},")
+    lines.append(f"    .pages = {pages},")
+    lines.append(f"    .glyphs = {name}_glyphs,")
+    lines.append(f"    .index = {index},")
+    lines.append("};")
+    lines.append("")
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Genera Fonts.c con las fuentes del OLED")
+    parser.add_argument("salida", help="archivo .c a escribir")
+    args = parser.parse_args()
+    base = load_base()
+    out = [
+        "// Generado por tools/gen_fonts.py al compilar: no editar a mano.",
+        '#include "Fonts.h"',
+        "#include <stddef.h>",
+        "",
+    ]
+    for name, scale, width, chars in FONTS:
+        out += emit_font(name, scale, width, chars, base)
+    with open(args.salida, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
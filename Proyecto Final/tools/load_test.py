@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Carga de prueba para el servidor HTTP del ventilador.
+
+Simula varios clientes que, como la página web, mantienen conexiones
+keep-alive abiertas y consultan /api/status cada cierto intervalo. Sirve
+para comprobar el presupuesto de sockets de http_server.c: con más
+conexiones que HTTPD_MAX_SOCKETS el httpd cierra la menos usada (LRU) y el
+cliente tiene que reconectar, lo que aparece como "reconexiones".
+
+Con --ota además sube un firmware mientras dura la carga (necesita --pin
+para iniciar sesión) y así se ve si el sondeo sigue respondiendo con el
+worker ocupado.
+
+Solo usa la biblioteca estándar.
+
+Uso: load_test.py <host> [--clients N] [--conns N] [--seconds S]
+                         [--interval S] [--cbor] [--ota firmware.bin --pin PIN]
+"""
+
+import argparse
+import http.client
+import json
+import threading
+import time
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = []
+        self.codes = {}
+        self.errors = {}
+        self.reconnects = 0
+
+    def ok(self, code, seconds):
+        with self.lock:
+            self.latencies.append(seconds)
+            self.codes[code] = self.codes.get(code, 0) + 1
+
+    def error(self, exc):
+        name = type(exc).__name__
+        with self.lock:
+            self.errors[name] = self.errors.get(name, 0) + 1
+            self.reconnects += 1
+
+
+def percentile(values, p):
+    if not values:
+        return float("nan")
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p / 100 * len(values)))]
+
+
+def poll_client(args, stats, stop):
+    # Cada cliente reparte sus pedidos entre 'conns' conexiones persistentes
+    conns = [None] * args.conns
+    headers = {"Accept": "application/cbor"} if args.cbor else {}
+    turn = 0
+    while not stop.is_set():
+        i = turn % args.conns
+        turn += 1
+        try:
+            if conns[i] is None:
+                conns[i] = http.client.HTTPConnection(args.host, args.port, timeout=5)
+            t0 = time.monotonic()
+            conns[i].request("GET", "/api/status", headers=headers)
+            resp = conns[i].getresponse()
+            resp.read()
+            stats.ok(resp.status, time.monotonic() - t0)
+        except (OSError, http.client.HTTPException) as exc:
+            # Socket cerrado por el LRU del httpd, timeout o reset: reconectar
+            stats.error(exc)
+            conns[i].close()
+            conns[i] = None
+        stop.wait(args.interval / args.conns)
+    for c in conns:
+        if c is not None:
+            c.close()
+
+
+def login(args):
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=10)
+    conn.request("POST", "/api/login", body=json.dumps({"pin": args.pin}),
+                 headers={"Content-Type": "application/json"})
+    resp = conn.getresponse()
+    body = resp.read()
+    conn.close()
+    if resp.status != 200:
+        raise SystemExit(f"login: HTTP {resp.status} {body.decode(errors='replace')}")
+    return json.loads(body)["token"]
+
+
+def upload_ota(args, token, result):
+    with open(args.ota, "rb") as f:
+        image = f.read()
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=120)
+    t0 = time.monotonic()
+    try:
+        conn.request("POST", "/ota", body=image,
+                     headers={"Authorization": f"Bearer {token}",
+                              "Content-Type": "application/octet-stream"})
+        resp = conn.getresponse()
+        resp.read()
+        result["status"] = resp.status
+    except (OSError, http.client.HTTPException) as exc:
+        result["status"] = type(exc).__name__
+    result["seconds"] = time.monotonic() - t0
+    result["bytes"] = len(image)
+    conn.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Carga de prueba de /api/status")
+    parser.add_argument("host", help="IP del equipo (AP: 192.168.0.1)")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=6, help="clientes simultáneos")
+    parser.add_argument("--conns", type=int, default=2, help="conexiones keep-alive por cliente")
+    parser.add_argument("--seconds", type=float, default=30.0, help="duración de la prueba")
+    parser.add_argument("--interval", type=float, default=1.0, help="segundos entre sondeos de cada cliente")
+    parser.add_argument("--cbor", action="store_true", help="pedir el estado en CBOR")
+    parser.add_argument("--ota", help="firmware a subir durante la carga")
+    parser.add_argument("--pin", help="PIN para iniciar sesión (necesario con --ota)")
+    args = parser.parse_args()
+    if args.ota and not args.pin:
+        parser.error("--ota necesita --pin")
+
+    stats = Stats()
+    stop = threading.Event()
+    threads = [threading.Thread(target=poll_client, args=(args, stats, stop))
+               for _ in range(args.clients)]
+
+    ota_result = {}
+    if args.ota:
+        token = login(args)
+        threads.append(threading.Thread(target=upload_ota, args=(args, token, ota_result)))
+
+    t0 = time.monotonic()
+    for t in threads:
+        t.start()
+    time.sleep(args.seconds)
+    stop.set()
+    for t in threads:
+        t.join()
+    elapsed = time.monotonic() - t0
+
+    lat = [x * 1000 for x in stats.latencies]
+    total = len(lat)
+    print(f"destino: {args.host}:{args.port}")
+    print(f"clientes: {args.clients} x {args.conns} conexiones, {elapsed:.1f} s")
+    print(f"pedidos: {total} ({total / elapsed:.1f}/s)  códigos: {dict(sorted(stats.codes.items()))}")
+    print(f"latencia ms: p50 {percentile(lat, 50):.1f}  p95 {percentile(lat, 95):.1f}  "
+          f"p99 {percentile(lat, 99):.1f}  máx {max(lat, default=float('nan')):.1f}")
+    print(f"reconexiones: {stats.reconnects}  errores: {stats.errors or '-'}")
+    if ota_result:
+        print(f"ota: {ota_result['status']} en {ota_result['seconds']:.1f} s "
+              f"({ota_result['bytes'] / 1024:.0f} KB)")
+
+
+if __name__ == "__main__":
+    main()
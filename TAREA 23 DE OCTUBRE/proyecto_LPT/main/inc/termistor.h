@@ -1,6 +1,7 @@
 #ifndef TERMISTOR_H_
 #define TERMISTOR_H_
 
+#include <stdbool.h>
 #include "esp_adc/adc_oneshot.h"
 
 // Fija la resistencia de referencia (R2) en ohmios
@@ -10,7 +11,22 @@
 // Ahora acepta el handle directamente, no un puntero a un handle.
 void termistor_init(adc_oneshot_unit_handle_t adc_handle);
 
-// Función para leer la temperatura en grados Celsius
+// Función para leer la temperatura en grados Celsius.
+// Devuelve NAN si el termistor está abierto o en corto, o si falla la lectura.
 float termistor_get_temperature_celsius(void);
 
+// --- Calibración por puntos (se guarda en NVS) ---
+// Captura la última resistencia medida junto con la temperatura real
+// (termómetro de referencia). ESP_ERR_INVALID_STATE si aún no hay lecturas.
+esp_err_t termistor_cal_add_point(float ref_celsius, float *resistance);
+
+// Ajusta Steinhart-Hart con los puntos (2 o más), lo guarda y lo aplica
+esp_err_t termistor_cal_fit(float *err_max_c);
+
+// Vuelve al modelo Beta nominal y borra la calibración guardada
+esp_err_t termistor_cal_reset(void);
+
+int termistor_cal_points(void);
+bool termistor_is_calibrated(void);
+
 #endif /* TERMISTOR_H_ */
\ No newline at end of file
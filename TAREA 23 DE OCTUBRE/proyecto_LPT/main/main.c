@@ -1,9 +1,11 @@
+#include <math.h>
 #include <stdio.h>
 #include <string.h> // Necesario para la manipulación de strings si decides pasar comandos directos
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_adc/adc_oneshot.h"
+#include "nvs_flash.h"
 
 // Incluye los archivos de cabecera de los sensores
 #include "termistor.h"
@@ -46,7 +48,8 @@ static bool is_monitoring_enabled = true;
  * @return float Valor de intensidad normalizado (0.0 a 1.0) para el canal de color.
  */
 float map_temp_to_color_intensity(float temp_celsius, float min_temp, float max_temp) {
-    if (temp_celsius <= min_temp) {
+    // Sin lectura del termistor (NAN) el canal queda apagado
+    if (isnan(temp_celsius) || temp_celsius <= min_temp) {
         return 0.0f;
     }
     if (temp_celsius >= max_temp) {
@@ -133,7 +136,11 @@ void app_sensors_task(void *pvParameters) {
         
         if (is_monitoring_enabled) { //  Condición para activar/desactivar
             ESP_LOGI(TAG, "--- Lectura ---");
-            ESP_LOGI(TAG, "Temperatura del Termistor: %.2f C", current_temperature);
+            if (isnan(current_temperature)) {
+                ESP_LOGW(TAG, "Temperatura del Termistor: sin lectura (abierto, en corto o error del ADC)");
+            } else {
+                ESP_LOGI(TAG, "Temperatura del Termistor: %.2f C", current_temperature);
+            }
             ESP_LOGI(TAG, "Valor del Potenciómetro (Brillo): %.2f (0.0 a 1.0)", normalized_pot_value);
             ESP_LOGI(TAG, "LED RGB (R, G, B): %" PRIu32 "%%, %" PRIu32 "%%, %" PRIu32 "%%", 
                         final_r_duty, final_g_duty, final_b_duty);
@@ -147,6 +154,15 @@ void app_sensors_task(void *pvParameters) {
 }
 
 void app_main(void) {
+    // ----------------------------------------------------------------------
+    // 0. NVS (calibración del termistor)
+    // ----------------------------------------------------------------------
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ESP_ERROR_CHECK(nvs_flash_init());
+    }
+
     // ----------------------------------------------------------------------
     // 1. Inicialización de UART CMD (para cambiar los thresholds y recibir comandos)
     // ----------------------------------------------------------------------
@@ -1,6 +1,9 @@
 #include "termistor.h"
 #include "esp_log.h"
 #include "esp_adc/adc_oneshot.h"
+#include "filtro_adc.h"
+#include "freertos/FreeRTOS.h"
+#include "cali_sensor.h"
 #include <math.h> // Necesario para la función log() y pow()
 
 static const char *TERM_TAG = "TERMISTOR";
@@ -16,6 +19,8 @@ static adc_channel_t termistor_channel = ADC_CHANNEL_9;
 #define V_REF                   3.3f 
 // Resolucion maxima del ADC (12 bits)
 #define ADC_MAX_VAL             4095.0f 
+// Lecturas por medición: se promedian las 4 centrales (los picos no entran)
+#define TERMISTOR_LECTURAS      8
 // Resistor fijo en el divisor de voltaje (comunmente 10k Ohm)
 #define SERIES_RESISTOR         10000.0f 
 
@@ -24,6 +29,16 @@ static adc_channel_t termistor_channel = ADC_CHANNEL_9;
 #define TEMPERATURE_NOMINAL     25.0f       // Temperatura nominal (Celsius)
 #define B_COEFFICIENT           3950.0f     // Coeficiente Beta (Kelvin)
 
+// --- CALIBRACIÓN (Steinhart-Hart ajustado con puntos de referencia) ---
+// Si hay coeficientes guardados en NVS reemplazan al modelo Beta de arriba.
+#define TERMISTOR_CAL_KEY       "ntc"
+
+static cali_sh_t s_sh;
+static bool s_sh_valid = false;
+static cali_puntos_t s_puntos;
+static float s_last_resistance = NAN;   // Última resistencia medida (para capturar puntos)
+static portMUX_TYPE s_cal_mux = portMUX_INITIALIZER_UNLOCKED;
+
 // Función de inicialización
 void termistor_init(adc_oneshot_unit_handle_t adc_handle) {
     global_adc_handle = adc_handle;
@@ -38,22 +53,47 @@ void termistor_init(adc_oneshot_unit_handle_t adc_handle) {
     // Configurar el canal
     ESP_ERROR_CHECK(adc_oneshot_config_channel(global_adc_handle, termistor_channel, &config));
     ESP_LOGI(TERM_TAG, "Termistor en canal %d inicializado con atenuación DB_11.", termistor_channel);
+
+    // Calibración guardada (necesita la NVS iniciada)
+    cali_sh_t sh;
+    if (cali_sensor_cargar(TERMISTOR_CAL_KEY, &sh, sizeof(sh)) == ESP_OK) {
+        portENTER_CRITICAL(&s_cal_mux);
+        s_sh = sh;
+        s_sh_valid = true;
+        portEXIT_CRITICAL(&s_cal_mux);
+        ESP_LOGI(TERM_TAG, "Calibración Steinhart-Hart cargada (a=%.6e b=%.6e c=%.6e)", sh.a, sh.b, sh.c);
+    }
 }
 
 // Función para obtener la temperatura en Celsius
 float termistor_get_temperature_celsius(void) {
     if (global_adc_handle == NULL) {
-        ESP_LOGE(TERM_TAG, "ADC handle no inicializado. Devuelve 0.0");
-        return 0.0f;
+        ESP_LOGE(TERM_TAG, "ADC handle no inicializado. Devuelve NAN");
+        return NAN;
     }
 
-    int raw_val;
-    // Leer el valor crudo del ADC
-    esp_err_t ret = adc_oneshot_read(global_adc_handle, termistor_channel, &raw_val);
+    // Leer varias muestras crudas del ADC
+    int32_t muestras[TERMISTOR_LECTURAS];
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < TERMISTOR_LECTURAS && ret == ESP_OK; i++) {
+        int v = 0;
+        ret = adc_oneshot_read(global_adc_handle, termistor_channel, &v);
+        muestras[i] = v;
+    }
     
     if (ret != ESP_OK) {
         ESP_LOGE(TERM_TAG, "Error al leer ADC: %s", esp_err_to_name(ret));
-        return 0.0f;
+        return NAN;
+    }
+    int raw_val = (int)filtro_media_recortada(muestras, TERMISTOR_LECTURAS, 2);
+
+    // En los extremos la fórmula de abajo no tiene solución: con 0 divide
+    // por cero (R infinita, termistor abierto) y con el tope da R = 0 (en
+    // corto, log(0)). Se trata igual que un error de lectura: NAN, que no
+    // se confunde con una temperatura.
+    if (raw_val <= 0 || raw_val >= (int)ADC_MAX_VAL) {
+        ESP_LOGE(TERM_TAG, "Termistor %s (crudo %d)", raw_val <= 0 ? "abierto" : "en corto", raw_val);
+        return NAN;
     }
 
     // 1. Calcular la Resistencia del Termistor (R_th)
@@ -67,8 +107,20 @@ float termistor_get_temperature_celsius(void) {
     // Simplificando la formula usando valores ADC:
     // R_th = R_serie * (ADC_MAX_VAL / raw_val - 1)
     float resistance = SERIES_RESISTOR * ((ADC_MAX_VAL / (float)raw_val) - 1.0f);
+    s_last_resistance = resistance;
 
-    // 2. Usar la ecuación de Steinhart-Hart simplificada (Modelo Beta)
+    // 2. Con calibración: Steinhart-Hart completo con los coeficientes ajustados
+    cali_sh_t sh;
+    bool calibrated;
+    portENTER_CRITICAL(&s_cal_mux);
+    sh = s_sh;
+    calibrated = s_sh_valid;
+    portEXIT_CRITICAL(&s_cal_mux);
+    if (calibrated) {
+        return cali_sh_celsius(&sh, resistance);
+    }
+
+    // Sin calibración: ecuación de Steinhart-Hart simplificada (Modelo Beta)
     
     float steinhart;
     
@@ -99,3 +151,50 @@ float termistor_get_temperature_celsius(void) {
 
     return temp_celsius;
 }
+
+esp_err_t termistor_cal_add_point(float ref_celsius, float *resistance)
+{
+    float r = s_last_resistance;
+    if (!isfinite(r) || r <= 0.0f) return ESP_ERR_INVALID_STATE;   // Sin lecturas válidas
+    esp_err_t err = cali_puntos_agregar(&s_puntos, r, ref_celsius);
+    if (err == ESP_OK && resistance != NULL) *resistance = r;
+    return err;
+}
+
+esp_err_t termistor_cal_fit(float *err_max_c)
+{
+    cali_sh_t sh;
+    esp_err_t err = cali_sh_ajustar(&s_puntos, &sh, err_max_c);
+    if (err != ESP_OK) return err;
+    err = cali_sensor_guardar(TERMISTOR_CAL_KEY, &sh, sizeof(sh));
+    if (err != ESP_OK) return err;
+
+    portENTER_CRITICAL(&s_cal_mux);
+    s_sh = sh;
+    s_sh_valid = true;
+    portEXIT_CRITICAL(&s_cal_mux);
+    cali_puntos_limpiar(&s_puntos);
+    ESP_LOGI(TERM_TAG, "Calibración Steinhart-Hart guardada (a=%.6e b=%.6e c=%.6e)", sh.a, sh.b, sh.c);
+    return ESP_OK;
+}
+
+esp_err_t termistor_cal_reset(void)
+{
+    esp_err_t err = cali_sensor_borrar(TERMISTOR_CAL_KEY);
+    if (err != ESP_OK) return err;
+    portENTER_CRITICAL(&s_cal_mux);
+    s_sh_valid = false;
+    portEXIT_CRITICAL(&s_cal_mux);
+    cali_puntos_limpiar(&s_puntos);
+    return ESP_OK;
+}
+
+int termistor_cal_points(void)
+{
+    return s_puntos.n;
+}
+
+bool termistor_is_calibrated(void)
+{
+    return s_sh_valid;
+}
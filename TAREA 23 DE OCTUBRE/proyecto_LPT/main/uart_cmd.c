@@ -3,13 +3,64 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "termistor.h"
 
 static const char *TAG = "UART_CMD";
 
 #define UART_PORT_NUM      UART_NUM_0
 #define BUF_SIZE           1024
 
+static void send_response(const char *resp, int n)
+{
+    if (n > 0) uart_write_bytes(UART_PORT_NUM, resp, n);
+}
+
+// Calibración del termistor contra un termómetro de referencia:
+// CAL_NTC <°C> captura un punto, CAL_NTC_FIT ajusta y guarda,
+// CAL_NTC_RESET vuelve al modelo Beta y CAL_NTC_INFO muestra el estado
+static void process_cal_command(const char *cmd)
+{
+    char resp[96];
+    if (strcmp(cmd, "CAL_NTC_FIT") == 0) {
+        float err_max = 0;
+        esp_err_t err = termistor_cal_fit(&err_max);
+        if (err == ESP_OK) {
+            send_response(resp, snprintf(resp, sizeof(resp), "CAL_NTC: calibrado, error max %.2f C\n", err_max));
+        } else {
+            send_response(resp, snprintf(resp, sizeof(resp), "Error: CAL_NTC_FIT (%s), hacen falta 2+ puntos coherentes\n",
+                                         esp_err_to_name(err)));
+        }
+    } else if (strcmp(cmd, "CAL_NTC_RESET") == 0) {
+        esp_err_t err = termistor_cal_reset();
+        send_response(resp, snprintf(resp, sizeof(resp), "CAL_NTC: %s\n",
+                                     err == ESP_OK ? "modelo Beta nominal" : esp_err_to_name(err)));
+    } else if (strcmp(cmd, "CAL_NTC_INFO") == 0) {
+        send_response(resp, snprintf(resp, sizeof(resp), "CAL_NTC: %s, %d puntos capturados\n",
+                                     termistor_is_calibrated() ? "calibrado" : "sin calibrar", termistor_cal_points()));
+    } else if (strncmp(cmd, "CAL_NTC ", 8) == 0) {
+        // Solo un número: "CAL_NTC abc" no puede entrar al ajuste como 0 °C
+        char *fin;
+        float ref = strtof(cmd + 8, &fin);
+        while (*fin == ' ') fin++;
+        if (fin == cmd + 8 || *fin != '\0' || !isfinite(ref)) {
+            send_response(resp, snprintf(resp, sizeof(resp), "Error: CAL_NTC '%.40s' no es una temperatura\n", cmd + 8));
+            return;
+        }
+        float r = 0;
+        esp_err_t err = termistor_cal_add_point(ref, &r);
+        if (err == ESP_OK) {
+            send_response(resp, snprintf(resp, sizeof(resp), "CAL_NTC: punto %d = %.0f ohm a %.2f C\n",
+                                         termistor_cal_points(), r, ref));
+        } else {
+            send_response(resp, snprintf(resp, sizeof(resp), "Error: CAL_NTC (%s)\n", esp_err_to_name(err)));
+        }
+    }
+}
+
 /**
  * @brief Tarea para leer comandos de la UART (terminal serial).
  * @param arg No utilizado.
@@ -31,6 +82,9 @@ void uart_rx_task(void *arg)
             // Ejemplo simple de procesamiento de comandos
             if (strcmp((char *)data, "status\r\n") == 0 || strcmp((char *)data, "status\n") == 0) {
                 uart_write_bytes(UART_PORT_NUM, "STATUS: OK\n", 11);
+            } else if (strncmp((char *)data, "CAL_NTC", 7) == 0) {
+                data[strcspn((char *)data, "\r\n")] = '\0';
+                process_cal_command((char *)data);
             }
         }
     }
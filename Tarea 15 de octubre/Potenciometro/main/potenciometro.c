@@ -1,13 +1,12 @@
 #include "potenciometro.h"
 #include "driver/adc.h"
 #include "esp_adc/adc_oneshot.h"
-#include "esp_adc/adc_cali.h"
-#include "esp_adc/adc_cali_scheme.h"
 #include "esp_err.h"
+#include "filtro_adc.h"
+#include "cali_adc.h"
 
 static adc_oneshot_unit_handle_t s_adc1 = NULL;
-static adc_cali_handle_t         s_cali = NULL;
-static bool                      s_tiene_cali = false;
+static const cali_adc_tabla_t   *s_cali = NULL;
 
 bool potenciometro_init(void)
 {
@@ -24,21 +23,8 @@ bool potenciometro_init(void)
     };
     ESP_ERROR_CHECK(adc_oneshot_config_channel(s_adc1, POT_ADC_CHANNEL, &ccfg));
 
-    // 3) Intentar calibracion por "curve fitting" (si el chip la soporta)
-#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
-    adc_cali_curve_fitting_config_t cal = {
-        .unit_id  = POT_ADC_UNIT,
-        .atten    = POT_ADC_ATTEN,
-        .bitwidth = POT_ADC_BITWIDTH,
-    };
-    if (adc_cali_create_scheme_curve_fitting(&cal, &s_cali) == ESP_OK) {
-        s_tiene_cali = true;
-    } else {
-        s_tiene_cali = false;
-    }
-#else
-    s_tiene_cali = false;
-#endif
+    // 3) Tabla crudo -> mV con la calibracion de eFuse (se evalua una vez)
+    s_cali = cali_adc_obtener(POT_ADC_UNIT, POT_ADC_ATTEN);
     return true;
 }
 
@@ -54,11 +40,13 @@ int potenciometro_leer_crudo(void)
 int potenciometro_leer_crudo_prom(int n)
 {
     if (n <= 1) return potenciometro_leer_crudo();
-    int64_t acum = 0;
+    if (n > FILTRO_MAX_MUESTRAS) n = FILTRO_MAX_MUESTRAS;
+    int32_t muestras[FILTRO_MAX_MUESTRAS];
     for (int i = 0; i < n; ++i) {
-        acum += potenciometro_leer_crudo();
+        muestras[i] = potenciometro_leer_crudo();
     }
-    return (int)(acum / n);
+    // Media recortada (descarta el 25% de cada extremo): ignora picos sueltos
+    return (int)filtro_media_recortada(muestras, n, n / 4);
 }
 
 int potenciometro_leer_milivoltios(void)
@@ -66,10 +54,8 @@ int potenciometro_leer_milivoltios(void)
     int raw = potenciometro_leer_crudo_prom(8);
     int mv  = 0;
 
-    if (s_tiene_cali && s_cali) {
-        if (adc_cali_raw_to_voltage(s_cali, raw, &mv) != ESP_OK) {
-            mv = 0;
-        }
+    if (s_cali) {
+        mv = cali_adc_mv(s_cali, raw);
     } else {
         // Aproximación sin calibración (12 bits, 0..4095 -> 0..3300mV)
         mv = (int)( (raw * 3300.0f) / 4095.0f );
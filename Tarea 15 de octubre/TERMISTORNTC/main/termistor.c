@@ -2,24 +2,20 @@
 #include <stdio.h>
 #include "termistor.h"
 #include "esp_adc/adc_oneshot.h"
+#include "filtro_adc.h"
 
-/* Calibración: puede no estar disponible según eFuses/IDF/target.
-   Protegemos con macros para compilar en todos los casos. */
-#include "esp_adc/adc_cali.h"
-#include "esp_adc/adc_cali_scheme.h"
+/* Calibración: la tabla de cali_adc ya resuelve si el chip trae eFuses
+   (curva o recta) o si hay que usar la aproximación nominal. */
+#include "cali_adc.h"
 
 static adc_oneshot_unit_handle_t s_adc1 = NULL;
-static adc_cali_handle_t         s_cali = NULL;
-static bool                      s_has_cali = false;
+static const cali_adc_tabla_t   *s_cali = NULL;
 
 static float raw_to_mv(int raw)
 {
-    int mv = 0;
-#if defined(ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED)
-    if (s_has_cali && adc_cali_raw_to_voltage(s_cali, raw, &mv) == ESP_OK) {
-        return (float)mv;
+    if (s_cali) {
+        return (float)cali_adc_mv(s_cali, raw);
     }
-#endif
     // Aprox. 12 bits, 11 dB -> ~0..3300 mV
     return (raw / 4095.0f) * 3300.0f;
 }
@@ -37,24 +33,13 @@ bool termistor_init(void)
     if (adc_oneshot_config_channel(s_adc1, NTC_ADC_CHANNEL, &ch_cfg) != ESP_OK)
         return false;
 
-    // Calibración si el esquema está soportado
-#if defined(ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED)
-    adc_cali_curve_fitting_config_t cali_cfg = {
-        .unit_id  = ADC_UNIT_1,
-        .atten    = ADC_ATTEN_DB_11,
-        .bitwidth = ADC_BITWIDTH_DEFAULT
-    };
-    if (adc_cali_create_scheme_curve_fitting(&cali_cfg, &s_cali) == ESP_OK) {
-        s_has_cali = true;
-        printf("ADC calibrado (curve fitting)\n");
+    // Calibración evaluada una vez en la tabla crudo -> mV
+    s_cali = cali_adc_obtener(ADC_UNIT_1, ADC_ATTEN_DB_11);
+    if (s_cali && s_cali->calibrada) {
+        printf("ADC calibrado (tabla, error max %u mV)\n", s_cali->err_max_mv);
     } else {
-        s_has_cali = false;
         printf("ADC sin calibración (aprox lineal)\n");
     }
-#else
-    s_has_cali = false;
-    printf("ADC: esquema de calibración no soportado; usaré aproximación lineal\n");
-#endif
 
     return true;
 }
@@ -62,12 +47,14 @@ bool termistor_init(void)
 int termistor_read_raw(void)
 {
     const int N = 8;
-    int sum = 0, v = 0;
+    int32_t muestras[8];
+    int v = 0;
     for (int i = 0; i < N; ++i) {
         adc_oneshot_read(s_adc1, NTC_ADC_CHANNEL, &v);
-        sum += v;
+        muestras[i] = v;
     }
-    return sum / N;
+    // Media de las 4 centrales: los picos no entran al promedio
+    return filtro_media_recortada(muestras, N, 2);
 }
 
 float termistor_read_millivolts(void)
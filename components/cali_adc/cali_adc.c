@@ -0,0 +1,130 @@
+#include "cali_adc.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char *TAG = "CALI_ADC";
+
+static cali_adc_tabla_t tablas[CALI_ADC_MAX_TABLAS];
+static int n_tablas;
+
+static SemaphoreHandle_t lock = NULL;
+static StaticSemaphore_t lock_buf;
+static portMUX_TYPE lock_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void cali_lock(void)
+{
+    if (lock == NULL) {
+        // Varios drivers piden su tabla desde tareas distintas
+        taskENTER_CRITICAL(&lock_mux);
+        if (lock == NULL) lock = xSemaphoreCreateMutexStatic(&lock_buf);
+        taskEXIT_CRITICAL(&lock_mux);
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+}
+
+static void cali_unlock(void)
+{
+    xSemaphoreGive(lock);
+}
+
+// Fondo de escala aproximado de cada atenuacion (solo sin eFuse)
+static int fondo_nominal_mv(adc_atten_t aten)
+{
+    switch (aten) {
+    case ADC_ATTEN_DB_0:   return 1100;
+    case ADC_ATTEN_DB_2_5: return 1500;
+    case ADC_ATTEN_DB_6:   return 2200;
+    default:               return 3300;
+    }
+}
+
+static bool crear_esquema(adc_unit_t unidad, adc_atten_t aten, adc_cali_handle_t *h)
+{
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t curva = {
+        .unit_id = unidad, .atten = aten, .bitwidth = ADC_BITWIDTH_12,
+    };
+    if (adc_cali_create_scheme_curve_fitting(&curva, h) == ESP_OK) return true;
+#endif
+#if ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_line_fitting_config_t recta = {
+        .unit_id = unidad, .atten = aten, .bitwidth = ADC_BITWIDTH_12,
+    };
+    if (adc_cali_create_scheme_line_fitting(&recta, h) == ESP_OK) return true;
+#endif
+    return false;
+}
+
+static void borrar_esquema(adc_cali_handle_t h)
+{
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    if (adc_cali_delete_scheme_curve_fitting(h) == ESP_OK) return;
+#endif
+#if ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_delete_scheme_line_fitting(h);
+#endif
+}
+
+static int convertir(adc_cali_handle_t h, bool calibrada, int fondo_mv, int crudo)
+{
+    int mv = 0;
+    if (calibrada && adc_cali_raw_to_voltage(h, crudo, &mv) == ESP_OK) return mv;
+    return crudo * fondo_mv / (CALI_ADC_CUENTAS - 1);
+}
+
+static void armar(cali_adc_tabla_t *t)
+{
+    adc_cali_handle_t h = NULL;
+    int fondo = fondo_nominal_mv(t->aten);
+    t->calibrada = crear_esquema(t->unidad, t->aten, &h);
+
+    const int paso = 1 << CALI_ADC_PASO_LOG2;
+    for (int i = 0; i < CALI_ADC_NODOS - 1; i++) {
+        t->mv[i] = convertir(h, t->calibrada, fondo, i * paso);
+    }
+    // El ultimo nodo (4096) no existe en el ADC: se extrapola con el ultimo tramo
+    int ultimo = convertir(h, t->calibrada, fondo, CALI_ADC_CUENTAS - 1);
+    int previo = convertir(h, t->calibrada, fondo, CALI_ADC_CUENTAS - paso);
+    t->mv[CALI_ADC_NODOS - 1] = (paso == 1) ? ultimo
+                                            : ultimo + (ultimo - previo + (paso - 1) / 2) / (paso - 1);
+
+    // Error real de la tabla frente a la calibracion, cuenta por cuenta
+    int err_max = 0;
+    for (int crudo = 0; crudo < CALI_ADC_CUENTAS; crudo++) {
+        int d = cali_adc_mv(t, crudo) - convertir(h, t->calibrada, fondo, crudo);
+        if (d < 0) d = -d;
+        if (d > err_max) err_max = d;
+    }
+    t->err_max_mv = err_max;
+
+    if (t->calibrada) borrar_esquema(h);
+    ESP_LOGI(TAG, "ADC%d aten %d: %s, %d nodos (%u B), error max %d mV",
+             t->unidad + 1, t->aten, t->calibrada ? "eFuse" : "sin calibracion",
+             CALI_ADC_NODOS, (unsigned)sizeof(t->mv), err_max);
+}
+
+const cali_adc_tabla_t *cali_adc_obtener(adc_unit_t unidad, adc_atten_t aten)
+{
+    const cali_adc_tabla_t *res = NULL;
+    cali_lock();
+    for (int i = 0; i < n_tablas; i++) {
+        if (tablas[i].unidad == unidad && tablas[i].aten == aten) {
+            res = &tablas[i];
+            break;
+        }
+    }
+    if (res == NULL && n_tablas < CALI_ADC_MAX_TABLAS) {
+        cali_adc_tabla_t *t = &tablas[n_tablas++];
+        t->unidad = unidad;
+        t->aten = aten;
+        armar(t);
+        res = t;
+    }
+    cali_unlock();
+    if (res == NULL) ESP_LOGE(TAG, "Sin lugar para otra tabla (CALI_ADC_MAX_TABLAS)");
+    return res;
+}
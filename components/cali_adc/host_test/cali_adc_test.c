@@ -0,0 +1,144 @@
+// Error de la tabla crudo -> mV frente a una calibracion sintetica: una
+// recta con el offset y la pendiente de un ESP32 mas una comba suave de
+// ~30 mV, como las curvas de eFuse. Se compila una vez por paso
+// (CALI_ADC_PASO_LOG2) y se comparan todas las cuentas. Tambien se prueban
+// la version con fraccion, el reparto de tablas y el caso sin eFuse.
+// Devuelve 1 si algo no cumple.
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "cali_adc.h"
+#include "esp_adc/adc_cali_scheme.h"
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+// Peor error aceptado por paso: 0 sin comprimir, y la interpolacion no
+// puede sumar mas que lo que se curva la calibracion entre dos nodos
+#if CALI_ADC_PASO_LOG2 == 0
+#define ERROR_MAX_MV 0
+#elif CALI_ADC_PASO_LOG2 <= 6
+#define ERROR_MAX_MV 1
+#else
+#define ERROR_MAX_MV 2
+#endif
+
+// ---------------------------------------------------------------
+// Calibracion sintetica
+// ---------------------------------------------------------------
+static const int fondo_mv[] = { 1100, 1500, 2200, 3150 };
+static bool efuse = true;
+static int esquemas_vivos;
+
+static int curva(adc_atten_t aten, int crudo)
+{
+    double x = crudo / 4095.0;
+    double v = 142 + x * (fondo_mv[aten] - 142) + 30 * sin(3 * x * M_PI) * (1 - x) + 18 * x * x * x;
+    return (int)lround(v);
+}
+
+struct adc_cali_esquema { adc_atten_t aten; };
+static struct adc_cali_esquema esquemas[4];
+
+esp_err_t adc_cali_create_scheme_curve_fitting(const adc_cali_curve_fitting_config_t *cfg, adc_cali_handle_t *h)
+{
+    if (!efuse) return ESP_FAIL;
+    esquemas[cfg->atten].aten = cfg->atten;
+    *h = &esquemas[cfg->atten];
+    esquemas_vivos++;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_delete_scheme_curve_fitting(adc_cali_handle_t h)
+{
+    (void)h;
+    esquemas_vivos--;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t h, int crudo, int *mv)
+{
+    *mv = curva(h->aten, crudo);
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------
+// Pruebas
+// ---------------------------------------------------------------
+static void probar_error(void)
+{
+    const cali_adc_tabla_t *t = cali_adc_obtener(ADC_UNIT_1, ADC_ATTEN_DB_12);
+    CHECK(t != NULL && t->calibrada, "no armo la tabla de 12 dB");
+    if (t == NULL) return;
+    CHECK(esquemas_vivos == 0, "quedo un esquema de calibracion sin borrar");
+
+    int err_max = 0;
+    for (int crudo = 0; crudo < CALI_ADC_CUENTAS; crudo++) {
+        int d = abs(cali_adc_mv(t, crudo) - curva(ADC_ATTEN_DB_12, crudo));
+        if (d > err_max) err_max = d;
+    }
+    printf("paso %d: %4d nodos (%4zu B), error max %d mV\n", CALI_ADC_PASO_LOG2, CALI_ADC_NODOS,
+           sizeof(t->mv), err_max);
+    CHECK(err_max <= ERROR_MAX_MV, "error %d mV (limite %d mV)", err_max, ERROR_MAX_MV);
+    CHECK(t->err_max_mv == err_max, "la tabla informa %d mV y el error real es %d mV", t->err_max_mv, err_max);
+
+    // Fuera de rango se satura en los extremos
+    CHECK(cali_adc_mv(t, -5) == cali_adc_mv(t, 0), "crudo negativo");
+    CHECK(cali_adc_mv(t, 5000) == cali_adc_mv(t, CALI_ADC_CUENTAS - 1), "crudo mayor que 4095");
+}
+
+static void probar_q4(void)
+{
+    const cali_adc_tabla_t *t = cali_adc_obtener(ADC_UNIT_1, ADC_ATTEN_DB_0);
+    if (t == NULL) return;
+
+    // En cuentas enteras coincide con cali_adc_mv salvo el redondeo de esta
+    int peor = 0;
+    for (int crudo = 0; crudo < CALI_ADC_CUENTAS; crudo++) {
+        int d = abs(cali_adc_mv_q4(t, crudo * 16) - cali_adc_mv(t, crudo) * 16);
+        if (d > peor) peor = d;
+    }
+    CHECK(peor <= 8, "q4 se aparta %d/16 mV de cali_adc_mv", peor);
+
+    // La curva crece: con fraccion tampoco puede bajar
+    int32_t previo = cali_adc_mv_q4(t, 0);
+    bool monotona = true;
+    for (int32_t q = 1; q < CALI_ADC_CUENTAS * 16; q++) {
+        int32_t mv = cali_adc_mv_q4(t, q);
+        if (mv < previo) monotona = false;
+        previo = mv;
+    }
+    CHECK(monotona, "q4 no es monotona");
+}
+
+static void probar_tablas(void)
+{
+    const cali_adc_tabla_t *a = cali_adc_obtener(ADC_UNIT_1, ADC_ATTEN_DB_12);
+    CHECK(a == cali_adc_obtener(ADC_UNIT_1, ADC_ATTEN_DB_12), "la misma configuracion armo otra tabla");
+    CHECK(a != cali_adc_obtener(ADC_UNIT_2, ADC_ATTEN_DB_12), "otra unidad devolvio la misma tabla");
+
+    // Sin eFuse queda la recta nominal de la atenuacion
+    efuse = false;
+    const cali_adc_tabla_t *n = cali_adc_obtener(ADC_UNIT_1, ADC_ATTEN_DB_6);
+    CHECK(n != NULL && !n->calibrada, "sin eFuse la tabla figura calibrada");
+    if (n != NULL) {
+        CHECK(abs(cali_adc_mv(n, CALI_ADC_CUENTAS - 1) - 2200) <= 1, "fondo nominal de 6 dB: %d mV",
+              cali_adc_mv(n, CALI_ADC_CUENTAS - 1));
+    }
+
+    // Ya hay CALI_ADC_MAX_TABLAS (12 dB, 0 dB, ADC2 12 dB y 6 dB)
+    CHECK(cali_adc_obtener(ADC_UNIT_2, ADC_ATTEN_DB_0) == NULL, "entro una tabla de mas");
+    CHECK(cali_adc_obtener(ADC_UNIT_1, ADC_ATTEN_DB_0) != NULL, "lleno, una tabla existente no se encontro");
+}
+
+int main(void)
+{
+    probar_error();
+    probar_q4();
+    probar_tablas();
+
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
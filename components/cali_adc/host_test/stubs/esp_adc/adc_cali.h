@@ -0,0 +1,8 @@
+// API de calibracion que usa cali_adc.c; la prueba la implementa
+#pragma once
+
+#include "esp_adc/adc_oneshot.h"
+
+typedef struct adc_cali_esquema *adc_cali_handle_t;
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t h, int crudo, int *mv);
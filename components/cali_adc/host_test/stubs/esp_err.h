@@ -0,0 +1,7 @@
+// Lo minimo de esp_err.h de ESP-IDF para compilar en el host
+#pragma once
+
+typedef int esp_err_t;
+
+#define ESP_OK   0
+#define ESP_FAIL -1
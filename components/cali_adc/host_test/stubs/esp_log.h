@@ -0,0 +1,7 @@
+// Logs de ESP-IDF: la prueba imprime lo que mide por su cuenta
+#pragma once
+
+#include <stdio.h>
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ((void)(tag))
@@ -0,0 +1,10 @@
+// FreeRTOS para el host, con un solo hilo
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portMAX_DELAY                UINT32_MAX
@@ -0,0 +1,7 @@
+// Valores por defecto del Kconfig de cali_adc; el Makefile cambia el paso
+#pragma once
+
+#ifndef CONFIG_CALI_ADC_PASO_LOG2
+#define CONFIG_CALI_ADC_PASO_LOG2 4
+#endif
+#define CONFIG_CALI_ADC_MAX_TABLAS 4
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_adc/adc_oneshot.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==== Cache de calibracion del ADC ====
+// adc_cali_raw_to_voltage evalua el esquema de eFuse (line/curve fitting)
+// en cada llamada. Aca se evalua una sola vez por unidad y atenuacion y
+// queda una tabla crudo -> mV compartida por todos los canales con esa
+// configuracion: convertir es leer (y, si la tabla esta comprimida,
+// interpolar entre dos nodos).
+
+#define CALI_ADC_PASO_LOG2  CONFIG_CALI_ADC_PASO_LOG2
+#define CALI_ADC_MAX_TABLAS CONFIG_CALI_ADC_MAX_TABLAS
+#define CALI_ADC_CUENTAS    4096    // 12 bits
+#define CALI_ADC_NODOS      ((CALI_ADC_CUENTAS >> CALI_ADC_PASO_LOG2) + 1)
+
+typedef struct {
+    adc_unit_t  unidad;
+    adc_atten_t aten;
+    bool        calibrada;      // false: aproximacion nominal (sin eFuse)
+    uint16_t    err_max_mv;     // Error de la interpolacion frente a la calibracion
+    uint16_t    mv[CALI_ADC_NODOS];
+} cali_adc_tabla_t;
+
+/**
+ * @brief Tabla de la unidad y atenuacion pedidas. La primera vez la arma
+ * (4096 conversiones, unos ms); despues devuelve la misma.
+ *
+ * @return NULL solo si ya hay CALI_ADC_MAX_TABLAS distintas.
+ */
+const cali_adc_tabla_t *cali_adc_obtener(adc_unit_t unidad, adc_atten_t aten);
+
+/**
+ * @brief Crudo (0..4095) a milivoltios.
+ */
+static inline int cali_adc_mv(const cali_adc_tabla_t *t, int crudo)
+{
+    if (crudo < 0) crudo = 0;
+    if (crudo >= CALI_ADC_CUENTAS) crudo = CALI_ADC_CUENTAS - 1;
+#if CALI_ADC_PASO_LOG2 == 0
+    return t->mv[crudo];
+#else
+    int i = crudo >> CALI_ADC_PASO_LOG2;
+    int f = crudo & ((1 << CALI_ADC_PASO_LOG2) - 1);
+    int a = t->mv[i];
+    return a + (((t->mv[i + 1] - a) * f + (1 << (CALI_ADC_PASO_LOG2 - 1))) >> CALI_ADC_PASO_LOG2);
+#endif
+}
+
+/**
+ * @brief Igual que cali_adc_mv pero con 4 bits de fraccion a la entrada
+ * (crudo * 16, p. ej. un promedio) y a la salida (mV * 16). Sirve cuando
+ * una cuenta vale menos de 1 mV (atenuaciones bajas) y no se quiere
+ * perder esa resolucion al redondear.
+ */
+static inline int32_t cali_adc_mv_q4(const cali_adc_tabla_t *t, int32_t crudo_q4)
+{
+    const int despl = CALI_ADC_PASO_LOG2 + 4;
+    if (crudo_q4 < 0) crudo_q4 = 0;
+    if (crudo_q4 > (CALI_ADC_CUENTAS - 1) << 4) crudo_q4 = (CALI_ADC_CUENTAS - 1) << 4;
+    int i = crudo_q4 >> despl;
+    int32_t f = crudo_q4 & ((1 << despl) - 1);
+    int32_t a = t->mv[i];
+    return (a << 4) + (((t->mv[i + 1] - a) * f + ((1 << (despl - 4)) >> 1)) >> (despl - 4));
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,202 @@
+#include "cali_sensor.h"
+#include <math.h>
+#include <stdbool.h>
+#include "nvs.h"
+
+#define KELVIN 273.15
+
+void cali_puntos_limpiar(cali_puntos_t *p)
+{
+    p->n = 0;
+}
+
+esp_err_t cali_puntos_agregar(cali_puntos_t *p, float medido, float referencia)
+{
+    if (!isfinite(medido) || !isfinite(referencia)) return ESP_ERR_INVALID_ARG;
+    for (int i = 0; i < p->n; i++) {
+        if (fabsf(p->referencia[i] - referencia) < 0.05f) {
+            p->medido[i] = medido;
+            p->referencia[i] = referencia;
+            return ESP_OK;
+        }
+    }
+    if (p->n >= CALI_SENSOR_MAX_PUNTOS) return ESP_ERR_NO_MEM;
+    p->medido[p->n] = medido;
+    p->referencia[p->n] = referencia;
+    p->n++;
+    return ESP_OK;
+}
+
+// ==== Lineal ====
+esp_err_t cali_lineal_ajustar(const cali_puntos_t *p, int32_t escala, cali_lineal_t *out, float *err_max)
+{
+    if (p->n == 0 || escala <= 0) return ESP_ERR_INVALID_ARG;
+
+    double xm = 0, ym = 0;
+    for (int i = 0; i < p->n; i++) {
+        xm += p->medido[i];
+        ym += p->referencia[i];
+    }
+    xm /= p->n;
+    ym /= p->n;
+
+    // Con un punto (o todos a la misma temperatura) solo se corrige el offset
+    double ganancia = 1.0;
+    if (p->n >= 2) {
+        double sxx = 0, sxy = 0;
+        for (int i = 0; i < p->n; i++) {
+            sxx += (p->medido[i] - xm) * (p->medido[i] - xm);
+            sxy += (p->medido[i] - xm) * (p->referencia[i] - ym);
+        }
+        if (sxx < 1e-6) return ESP_ERR_INVALID_ARG;
+        ganancia = sxy / sxx;
+    }
+    if (ganancia < 0.5 || ganancia > 2.0) return ESP_ERR_INVALID_ARG;
+    double offset = ym - ganancia * xm;
+
+    out->ganancia_q16 = (int32_t)lround(ganancia * 65536.0);
+    out->offset = (int32_t)lround(offset * escala);
+
+    if (err_max != NULL) {
+        // Residuo con los coeficientes ya redondeados, como se van a aplicar
+        double peor = 0;
+        for (int i = 0; i < p->n; i++) {
+            int32_t x = (int32_t)lround(p->medido[i] * escala);
+            double d = fabs(cali_lineal_aplicar(out, x) / (double)escala - p->referencia[i]);
+            if (d > peor) peor = d;
+        }
+        *err_max = (float)peor;
+    }
+    return ESP_OK;
+}
+
+// ==== Steinhart-Hart ====
+float cali_sh_celsius(const cali_sh_t *sh, float r_ohm)
+{
+    float l = logf(r_ohm);
+    return 1.0f / (sh->a + sh->b * l + sh->c * l * l * l) - (float)KELVIN;
+}
+
+// Sistema 3x3 por eliminacion con pivoteo parcial (m[i][3] es el lado derecho)
+static bool resolver3(double m[3][4], double x[3])
+{
+    for (int col = 0; col < 3; col++) {
+        int piv = col;
+        for (int f = col + 1; f < 3; f++) {
+            if (fabs(m[f][col]) > fabs(m[piv][col])) piv = f;
+        }
+        if (fabs(m[piv][col]) < 1e-12) return false;
+        if (piv != col) {
+            for (int k = 0; k < 4; k++) {
+                double t = m[col][k];
+                m[col][k] = m[piv][k];
+                m[piv][k] = t;
+            }
+        }
+        for (int f = col + 1; f < 3; f++) {
+            double q = m[f][col] / m[col][col];
+            for (int k = col; k < 4; k++) m[f][k] -= q * m[col][k];
+        }
+    }
+    for (int f = 2; f >= 0; f--) {
+        double s = m[f][3];
+        for (int k = f + 1; k < 3; k++) s -= m[f][k] * x[k];
+        x[f] = s / m[f][f];
+    }
+    return true;
+}
+
+esp_err_t cali_sh_ajustar(const cali_puntos_t *p, cali_sh_t *out, float *err_max)
+{
+    if (p->n < 2) return ESP_ERR_INVALID_ARG;
+
+    // ln R se normaliza por su media: las columnas 1, L y L^3 quedan del
+    // mismo orden y las ecuaciones normales no pierden precision
+    double lm = 0, lmin = INFINITY, lmax = -INFINITY;
+    for (int i = 0; i < p->n; i++) {
+        if (!(p->medido[i] > 0) || p->referencia[i] <= -KELVIN) return ESP_ERR_INVALID_ARG;
+        double l = log(p->medido[i]);
+        lm += l;
+        if (l < lmin) lmin = l;
+        if (l > lmax) lmax = l;
+    }
+    lm /= p->n;
+    if (lmax - lmin < 1e-3) return ESP_ERR_INVALID_ARG;
+
+    int cols = (p->n >= 3) ? 3 : 2;
+    double m[3][4] = { { 0 } };
+    for (int i = 0; i < p->n; i++) {
+        double u = log(p->medido[i]) / lm;
+        double fila[3] = { 1.0, u, u * u * u };
+        double y = 1.0 / (p->referencia[i] + KELVIN);
+        for (int r = 0; r < cols; r++) {
+            for (int k = 0; k < cols; k++) m[r][k] += fila[r] * fila[k];
+            m[r][3] += fila[r] * y;
+        }
+    }
+    if (cols == 2) {
+        // Sin tercer punto: c = 0 (ecuacion trivial para que el sistema cierre)
+        m[2][2] = 1.0;
+    }
+
+    double x[3];
+    if (!resolver3(m, x)) return ESP_ERR_INVALID_ARG;
+    double a = x[0], b = x[1] / lm, c = x[2] / (lm * lm * lm);
+
+    // La NTC baja su resistencia al calentarse: d(1/T)/d(ln R) > 0 en todo
+    // el rango calibrado (b + 3cL^2 es monotono en L, alcanza con los bordes)
+    if (b + 3 * c * lmin * lmin <= 0 || b + 3 * c * lmax * lmax <= 0) return ESP_ERR_INVALID_ARG;
+
+    out->a = (float)a;
+    out->b = (float)b;
+    out->c = (float)c;
+
+    if (err_max != NULL) {
+        float peor = 0;
+        for (int i = 0; i < p->n; i++) {
+            float d = fabsf(cali_sh_celsius(out, p->medido[i]) - p->referencia[i]);
+            if (d > peor) peor = d;
+        }
+        *err_max = peor;
+    }
+    return ESP_OK;
+}
+
+// ==== NVS ====
+esp_err_t cali_sensor_guardar(const char *clave, const void *coef, size_t len)
+{
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(CALI_SENSOR_NVS_NS, NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+    err = nvs_set_blob(h, clave, coef, len);
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    return err;
+}
+
+esp_err_t cali_sensor_cargar(const char *clave, void *coef, size_t len)
+{
+    nvs_handle_t h;
+    if (nvs_open(CALI_SENSOR_NVS_NS, NVS_READONLY, &h) != ESP_OK) return ESP_ERR_NOT_FOUND;
+    size_t guardado = 0;
+    esp_err_t err = nvs_get_blob(h, clave, NULL, &guardado);
+    if (err == ESP_OK && guardado == len) {
+        err = nvs_get_blob(h, clave, coef, &guardado);
+    } else {
+        err = ESP_ERR_NOT_FOUND;
+    }
+    nvs_close(h);
+    return err;
+}
+
+esp_err_t cali_sensor_borrar(const char *clave)
+{
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(CALI_SENSOR_NVS_NS, NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+    err = nvs_erase_key(h, clave);
+    if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    return err;
+}
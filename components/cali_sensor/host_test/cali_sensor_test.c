@@ -0,0 +1,291 @@
+// Precision de los ajustes con datos sinteticos: un LM35 con error de
+// ganancia y offset conocido y un NTC de 10k cuya curva real es un
+// Steinhart-Hart. Se mide el peor error corregido en todo el rango con
+// puntos exactos y con ruido, los rechazos y la ida y vuelta por NVS.
+// Devuelve 1 si algo no cumple.
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cali_sensor.h"
+#include "nvs.h"
+
+#define INTENTOS 500        // Ajustes con ruido por cantidad de puntos
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+// ---------------------------------------------------------------
+// NVS en memoria
+// ---------------------------------------------------------------
+#define NVS_CLAVES 8
+
+static struct {
+    char clave[16];
+    uint8_t valor[64];
+    size_t len;
+    bool usada;
+} nvs[NVS_CLAVES];
+
+static int nvs_buscar(const char *clave)
+{
+    for (int i = 0; i < NVS_CLAVES; i++) {
+        if (nvs[i].usada && strcmp(nvs[i].clave, clave) == 0) return i;
+    }
+    return -1;
+}
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *h) { (void)ns; (void)mode; *h = 1; return ESP_OK; }
+esp_err_t nvs_commit(nvs_handle_t h) { (void)h; return ESP_OK; }
+void nvs_close(nvs_handle_t h) { (void)h; }
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *clave, const void *v, size_t len)
+{
+    (void)h;
+    int i = nvs_buscar(clave);
+    for (int j = 0; i < 0 && j < NVS_CLAVES; j++) {
+        if (!nvs[j].usada) i = j;
+    }
+    if (i < 0 || len > sizeof(nvs[i].valor)) return ESP_ERR_NO_MEM;
+    snprintf(nvs[i].clave, sizeof(nvs[i].clave), "%s", clave);
+    memcpy(nvs[i].valor, v, len);
+    nvs[i].len = len;
+    nvs[i].usada = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *clave, void *v, size_t *len)
+{
+    (void)h;
+    int i = nvs_buscar(clave);
+    if (i < 0) return ESP_ERR_NVS_NOT_FOUND;
+    if (v != NULL) {
+        if (*len < nvs[i].len) return ESP_ERR_INVALID_ARG;
+        memcpy(v, nvs[i].valor, nvs[i].len);
+    }
+    *len = nvs[i].len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *clave)
+{
+    (void)h;
+    int i = nvs_buscar(clave);
+    if (i < 0) return ESP_ERR_NVS_NOT_FOUND;
+    nvs[i].usada = false;
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------
+// Sensores sinteticos
+// ---------------------------------------------------------------
+static double gauss(void)
+{
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+static double ahora_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// LM35 con error de ganancia y offset (lo que da un divisor o una
+// referencia del ADC fuera de tolerancia)
+#define LM35_GANANCIA 0.97
+#define LM35_OFFSET   -2.8
+
+static double lm35_lee(double t) { return t * LM35_GANANCIA + LM35_OFFSET; }
+
+// NTC "real": Steinhart-Hart de un 10k tipico, distinto del Beta 3950 que
+// trae la hoja de datos
+static const double SH_A = 1.009249522e-3, SH_B = 2.378405444e-4, SH_C = 2.019202697e-7;
+
+static double ntc_r(double t)
+{
+    double y = 1 / (t + 273.15);
+    double lo = 1, hi = 1e7;
+    for (int i = 0; i < 200; i++) {
+        double m = sqrt(lo * hi), l = log(m);
+        if (SH_A + SH_B * l + SH_C * l * l * l > y) hi = m;
+        else lo = m;
+    }
+    return sqrt(lo * hi);
+}
+
+static double beta_3950(double r) { return 1 / (1 / 298.15 + log(r / 10000) / 3950) - 273.15; }
+
+// ---------------------------------------------------------------
+// Lineal: puntos repartidos en 15..40 C, error evaluado en 10..45 C
+// ---------------------------------------------------------------
+static double error_lineal(int n, double ruido, float *err_ajuste)
+{
+    cali_puntos_t p;
+    cali_puntos_limpiar(&p);
+    for (int i = 0; i < n; i++) {
+        double ref = 15 + i * (25.0 / (n > 1 ? n - 1 : 1));
+        cali_puntos_agregar(&p, (float)(lm35_lee(ref) + ruido * gauss()), (float)ref);
+    }
+    cali_lineal_t c;
+    if (cali_lineal_ajustar(&p, 100, &c, err_ajuste) != ESP_OK) return INFINITY;
+
+    double peor = 0;
+    for (double t = 10; t <= 45; t += 0.25) {
+        int32_t x = (int32_t)lround(lm35_lee(t) * 100);
+        double d = fabs(cali_lineal_aplicar(&c, x) / 100.0 - t);
+        if (d > peor) peor = d;
+    }
+    return peor;
+}
+
+static void probar_lineal(void)
+{
+    printf("LM35 (lee %.2f*T %+.1f C), peor error corregido en 10..45 C:\n", LM35_GANANCIA, LM35_OFFSET);
+    printf("  sin calibrar: %.2f C\n", fabs(lm35_lee(45) - 45));
+    for (int n = 1; n <= 5; n++) {
+        float residuo;
+        double exacto = error_lineal(n, 0, &residuo);
+        double peor = 0;
+        for (int k = 0; k < INTENTOS; k++) peor = fmax(peor, error_lineal(n, 0.05, NULL));
+        printf("  %d puntos: exacto %.3f C (residuo %.3f), ruido 0.05 C peor de %d: %.3f C\n",
+               n, exacto, residuo, INTENTOS, peor);
+
+        // Con dos o mas puntos el modelo es exacto salvo el redondeo del
+        // punto fijo (centesimas y ganancia Q16)
+        if (n >= 2) {
+            CHECK(exacto <= 0.011, "lineal %d puntos exacto: %.4f C", n, exacto);
+            CHECK(residuo <= 0.011, "lineal %d puntos residuo: %.4f C", n, residuo);
+            CHECK(peor <= 0.35, "lineal %d puntos con ruido: %.3f C", n, peor);
+        } else {
+            // Un punto solo corrige el offset: no puede ser mejor que el
+            // error de ganancia en los extremos
+            CHECK(exacto > 0.3 && exacto < fabs(lm35_lee(45) - 45), "lineal 1 punto: %.3f C", exacto);
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+// Steinhart-Hart: puntos repartidos en 5..45 C, error evaluado en 0..50 C
+// ---------------------------------------------------------------
+static double error_sh(int n, double ruido_t, double ruido_r, float *err_ajuste)
+{
+    cali_puntos_t p;
+    cali_puntos_limpiar(&p);
+    for (int i = 0; i < n; i++) {
+        double ref = 5 + i * (40.0 / (n - 1));
+        double r = ntc_r(ref) * (1 + ruido_r * gauss());
+        cali_puntos_agregar(&p, (float)r, (float)(ref + ruido_t * gauss()));
+    }
+    cali_sh_t sh;
+    if (cali_sh_ajustar(&p, &sh, err_ajuste) != ESP_OK) return INFINITY;
+
+    double peor = 0;
+    for (double t = 0; t <= 50; t += 0.25) {
+        double d = fabs(cali_sh_celsius(&sh, (float)ntc_r(t)) - t);
+        if (d > peor) peor = d;
+    }
+    return peor;
+}
+
+static void probar_sh(void)
+{
+    double beta = 0;
+    for (double t = 0; t <= 50; t += 0.25) beta = fmax(beta, fabs(beta_3950(ntc_r(t)) - t));
+    printf("NTC 10k (Steinhart-Hart real), peor error en 0..50 C:\n");
+    printf("  Beta 3950 de la hoja de datos: %.2f C\n", beta);
+
+    static const int cantidades[] = { 2, 3, 4, 5, 8 };
+    for (size_t i = 0; i < sizeof(cantidades) / sizeof(cantidades[0]); i++) {
+        int n = cantidades[i];
+        float residuo;
+        double exacto = error_sh(n, 0, 0, &residuo);
+        double peor = 0;
+        for (int k = 0; k < INTENTOS; k++) peor = fmax(peor, error_sh(n, 0.05, 0.001, NULL));
+        printf("  %d puntos: exacto %.4f C (residuo %.4f), ruido 0.05 C y 0.1 %% peor de %d: %.3f C\n",
+               n, exacto, residuo, INTENTOS, peor);
+
+        if (n == 2) {
+            // Modelo Beta ajustado: mejor que el de la hoja de datos
+            CHECK(exacto < beta, "SH 2 puntos %.3f C no mejora Beta 3950 (%.3f C)", exacto, beta);
+        } else {
+            // Con 3 o mas el modelo es el mismo que el real: solo queda el
+            // redondeo de float
+            CHECK(exacto <= 0.01, "SH %d puntos exacto: %.4f C", n, exacto);
+            CHECK(residuo <= 0.01, "SH %d puntos residuo: %.4f C", n, residuo);
+            CHECK(peor <= 0.5, "SH %d puntos con ruido: %.3f C", n, peor);
+        }
+    }
+
+    // Costo del ajuste con el maximo de puntos (se hace una vez, en el equipo)
+    cali_puntos_t p;
+    cali_puntos_limpiar(&p);
+    for (int i = 0; i < CALI_SENSOR_MAX_PUNTOS; i++) {
+        double ref = 5 + i * 40.0 / (CALI_SENSOR_MAX_PUNTOS - 1);
+        cali_puntos_agregar(&p, (float)ntc_r(ref), (float)ref);
+    }
+    cali_sh_t sh;
+    float residuo;
+    double t0 = ahora_ns();
+    for (int k = 0; k < 100000; k++) cali_sh_ajustar(&p, &sh, &residuo);
+    printf("  ajuste con %d puntos: %.0f ns\n", CALI_SENSOR_MAX_PUNTOS, (ahora_ns() - t0) / 100000);
+}
+
+// ---------------------------------------------------------------
+// Rechazos, reemplazo de puntos y NVS
+// ---------------------------------------------------------------
+static void probar_bordes(void)
+{
+    cali_puntos_t p;
+    cali_lineal_t c;
+    cali_sh_t sh;
+
+    // Lecturas casi iguales con referencias distintas: ganancia absurda
+    cali_puntos_limpiar(&p);
+    cali_puntos_agregar(&p, 20, 20);
+    cali_puntos_agregar(&p, 20.01f, 30);
+    CHECK(cali_lineal_ajustar(&p, 100, &c, NULL) == ESP_ERR_INVALID_ARG, "acepto ganancia fuera de 0.5..2");
+
+    // La resistencia sube con la temperatura: no es un NTC
+    cali_puntos_limpiar(&p);
+    cali_puntos_agregar(&p, 5000, 20);
+    cali_puntos_agregar(&p, 10000, 30);
+    CHECK(cali_sh_ajustar(&p, &sh, NULL) == ESP_ERR_INVALID_ARG, "acepto una curva creciente");
+
+    cali_puntos_limpiar(&p);
+    cali_puntos_agregar(&p, 10000, 25);
+    CHECK(cali_sh_ajustar(&p, &sh, NULL) == ESP_ERR_INVALID_ARG, "SH con un punto");
+    CHECK(cali_puntos_agregar(&p, NAN, 25) == ESP_ERR_INVALID_ARG, "acepto NAN");
+
+    // Lleno: el noveno no entra, pero repetir una referencia reemplaza
+    cali_puntos_limpiar(&p);
+    for (int i = 0; i < CALI_SENSOR_MAX_PUNTOS; i++) cali_puntos_agregar(&p, i, i);
+    CHECK(cali_puntos_agregar(&p, 50, 50) == ESP_ERR_NO_MEM, "entro un punto de mas");
+    CHECK(cali_puntos_agregar(&p, 99, 3.02f) == ESP_OK && p.n == CALI_SENSOR_MAX_PUNTOS && p.medido[3] == 99,
+          "repetir la referencia 3 no reemplazo el punto");
+
+    // NVS: ida y vuelta, tamano de otro modelo y borrado
+    cali_sh_t guardado = { 1, 2, 3 }, leido;
+    CHECK(cali_sensor_guardar("ntc0", &guardado, sizeof(guardado)) == ESP_OK, "guardar");
+    CHECK(cali_sensor_cargar("ntc0", &leido, sizeof(leido)) == ESP_OK && memcmp(&leido, &guardado, sizeof(leido)) == 0,
+          "ida y vuelta por NVS");
+    CHECK(cali_sensor_cargar("ntc0", &c, sizeof(c)) == ESP_ERR_NOT_FOUND, "cargo un modelo de otro tamano");
+    CHECK(cali_sensor_borrar("ntc0") == ESP_OK && cali_sensor_cargar("ntc0", &leido, sizeof(leido)) == ESP_ERR_NOT_FOUND,
+          "borrar");
+    CHECK(cali_sensor_borrar("ntc0") == ESP_OK, "borrar lo que no existe");
+}
+
+int main(void)
+{
+    srand(1);
+    probar_lineal();
+    probar_sh();
+    probar_bordes();
+
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
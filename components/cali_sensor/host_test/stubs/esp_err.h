@@ -0,0 +1,11 @@
+// Lo minimo de esp_err.h de ESP-IDF para compilar en el host
+#pragma once
+
+typedef int esp_err_t;
+
+#define ESP_OK                0
+#define ESP_FAIL              -1
+#define ESP_ERR_NO_MEM        0x101
+#define ESP_ERR_INVALID_ARG   0x102
+#define ESP_ERR_NOT_FOUND     0x105
+#define ESP_ERR_NVS_NOT_FOUND 0x1102
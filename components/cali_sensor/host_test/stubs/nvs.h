@@ -0,0 +1,16 @@
+// API de NVS que usa cali_sensor.c; la prueba la implementa en memoria
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *h);
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *clave, const void *v, size_t len);
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *clave, void *v, size_t *len);
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *clave);
+esp_err_t nvs_commit(nvs_handle_t h);
+void nvs_close(nvs_handle_t h);
@@ -0,0 +1,87 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==== Calibracion de sensores contra puntos de referencia ====
+// Se capturan pares (lectura del sensor, valor de referencia) con un
+// termometro patron, se ajusta el modelo en el equipo y los coeficientes
+// quedan en NVS (espacio "cali", una clave por sensor). Aplicar la
+// correccion en la lectura no usa floats en el modelo lineal.
+
+#define CALI_SENSOR_MAX_PUNTOS  8
+#define CALI_SENSOR_NVS_NS      "cali"
+
+typedef struct {
+    uint8_t n;
+    float   medido[CALI_SENSOR_MAX_PUNTOS];      // Lectura sin corregir (o resistencia)
+    float   referencia[CALI_SENSOR_MAX_PUNTOS];  // Valor real (°C)
+} cali_puntos_t;
+
+void cali_puntos_limpiar(cali_puntos_t *p);
+
+/**
+ * @brief Agrega un par. Un punto con la misma referencia (+-0.05) que uno
+ * anterior lo reemplaza: repetir la captura no pesa doble en el ajuste.
+ * @return ESP_ERR_NO_MEM si ya hay CALI_SENSOR_MAX_PUNTOS.
+ */
+esp_err_t cali_puntos_agregar(cali_puntos_t *p, float medido, float referencia);
+
+// ---- Modelo lineal (LM35 y similares): y = ganancia * x + offset ----
+typedef struct {
+    int32_t ganancia_q16;   // 65536 = 1.0
+    int32_t offset;         // En las unidades de la lectura (p. ej. centesimas)
+} cali_lineal_t;
+
+#define CALI_LINEAL_IDENTIDAD ((cali_lineal_t){ .ganancia_q16 = 65536, .offset = 0 })
+
+static inline int32_t cali_lineal_aplicar(const cali_lineal_t *c, int32_t x)
+{
+    return (int32_t)(((int64_t)x * c->ganancia_q16 + (1 << 15)) >> 16) + c->offset;
+}
+
+/**
+ * @brief Minimos cuadrados sobre los puntos (con uno solo, solo offset).
+ * 'escala' pasa de las unidades de los puntos a las de la lectura en punto
+ * fijo (100 si los puntos estan en °C y la lectura en centesimas).
+ *
+ * @param err_max Mayor residuo del ajuste en unidades de los puntos (puede ser NULL).
+ * @return ESP_ERR_INVALID_ARG sin puntos, con lecturas todas iguales o con
+ *         una ganancia fuera de 0.5..2 (referencia mal cargada).
+ */
+esp_err_t cali_lineal_ajustar(const cali_puntos_t *p, int32_t escala, cali_lineal_t *out, float *err_max);
+
+// ---- Steinhart-Hart (NTC): 1/T = a + b ln R + c (ln R)^3, T en kelvin ----
+typedef struct {
+    float a, b, c;
+} cali_sh_t;
+
+float cali_sh_celsius(const cali_sh_t *sh, float r_ohm);
+
+/**
+ * @brief Ajusta a, b y c con los puntos (medido = resistencia en ohm).
+ * Con 2 puntos fija c = 0 (modelo Beta); con 3 es exacto y con mas es por
+ * minimos cuadrados.
+ * @return ESP_ERR_INVALID_ARG con menos de 2 puntos o si la curva
+ *         resultante no es decreciente (puntos inconsistentes).
+ */
+esp_err_t cali_sh_ajustar(const cali_puntos_t *p, cali_sh_t *out, float *err_max);
+
+// ---- Persistencia ----
+esp_err_t cali_sensor_guardar(const char *clave, const void *coef, size_t len);
+
+/**
+ * @return ESP_ERR_NOT_FOUND si no hay calibracion guardada o si su tamano
+ *         no coincide (otro modelo).
+ */
+esp_err_t cali_sensor_cargar(const char *clave, void *coef, size_t len);
+
+esp_err_t cali_sensor_borrar(const char *clave);
+
+#ifdef __cplusplus
+}
+#endif
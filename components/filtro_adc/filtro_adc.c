@@ -0,0 +1,185 @@
+#include "filtro_adc.h"
+
+// Intercambio condicional sin saltos: deja min en v[a] y max en v[b].
+// Las muestras del ADC caben de sobra en 31 bits, asi que la resta no desborda.
+#define CSWAP(v, a, b) do {                          \
+        int32_t _x = (v)[a], _y = (v)[b];            \
+        int32_t _d = _x - _y;                        \
+        int32_t _m = _d >> 31; /* -1 si x < y */     \
+        (v)[a] = _y + (_d & _m);                     \
+        (v)[b] = _x - (_d & _m);                     \
+    } while (0)
+
+static inline int32_t div_redondeo(int64_t num, int32_t den)
+{
+    return (int32_t)((num >= 0) ? (num + den / 2) / den : (num - den / 2) / den);
+}
+
+// Red par-impar completa: n rondas de comparadores vecinos.
+static void ordenar_red(int32_t *v, size_t n)
+{
+    for (size_t r = 0; r < n; ++r) {
+        for (size_t i = r & 1; i + 1 < n; i += 2) {
+            CSWAP(v, i, i + 1);
+        }
+    }
+}
+
+// ==== Redes de seleccion de mediana (Paeth / Devillard) ====
+static int32_t mediana3(int32_t *p)
+{
+    CSWAP(p, 0, 1); CSWAP(p, 1, 2); CSWAP(p, 0, 1);
+    return p[1];
+}
+
+static int32_t mediana5(int32_t *p)
+{
+    CSWAP(p, 0, 1); CSWAP(p, 3, 4); CSWAP(p, 0, 3);
+    CSWAP(p, 1, 4); CSWAP(p, 1, 2); CSWAP(p, 2, 3);
+    CSWAP(p, 1, 2);
+    return p[2];
+}
+
+static int32_t mediana7(int32_t *p)
+{
+    CSWAP(p, 0, 5); CSWAP(p, 0, 3); CSWAP(p, 1, 6);
+    CSWAP(p, 2, 4); CSWAP(p, 0, 1); CSWAP(p, 3, 5);
+    CSWAP(p, 2, 6); CSWAP(p, 2, 3); CSWAP(p, 3, 6);
+    CSWAP(p, 4, 5); CSWAP(p, 1, 4); CSWAP(p, 1, 3);
+    CSWAP(p, 3, 4);
+    return p[3];
+}
+
+static int32_t mediana9(int32_t *p)
+{
+    CSWAP(p, 1, 2); CSWAP(p, 4, 5); CSWAP(p, 7, 8);
+    CSWAP(p, 0, 1); CSWAP(p, 3, 4); CSWAP(p, 6, 7);
+    CSWAP(p, 1, 2); CSWAP(p, 4, 5); CSWAP(p, 7, 8);
+    CSWAP(p, 0, 3); CSWAP(p, 5, 8); CSWAP(p, 4, 7);
+    CSWAP(p, 3, 6); CSWAP(p, 1, 4); CSWAP(p, 2, 5);
+    CSWAP(p, 4, 7); CSWAP(p, 2, 4); CSWAP(p, 4, 6);
+    CSWAP(p, 2, 4);
+    return p[4];
+}
+
+int32_t filtro_mediana(int32_t *v, size_t n)
+{
+    switch (n) {
+        case 0: return 0;
+        case 1: return v[0];
+        case 3: return mediana3(v);
+        case 5: return mediana5(v);
+        case 7: return mediana7(v);
+        case 9: return mediana9(v);
+        default:
+            if (n > FILTRO_MAX_MUESTRAS) n = FILTRO_MAX_MUESTRAS;
+            ordenar_red(v, n);
+            return v[(n - 1) / 2];
+    }
+}
+
+int32_t filtro_media_recortada(int32_t *v, size_t n, size_t recorte)
+{
+    if (n == 0) return 0;
+    if (n > FILTRO_MAX_MUESTRAS) n = FILTRO_MAX_MUESTRAS;
+    if (recorte > (n - 1) / 2) recorte = (n - 1) / 2;
+
+    ordenar_red(v, n);
+
+    int64_t acum = 0;
+    size_t cuenta = n - 2 * recorte;
+    for (size_t i = recorte; i < n - recorte; ++i) {
+        acum += v[i];
+    }
+    return div_redondeo(acum, (int32_t)cuenta);
+}
+
+size_t filtro_mediana_decimar(int32_t *in, size_t n, size_t k, int32_t *out)
+{
+    if (k == 0) return 0;
+    size_t grupos = n / k;
+    for (size_t g = 0; g < grupos; ++g) {
+        out[g] = filtro_mediana(in + g * k, k);
+    }
+    return grupos;
+}
+
+// ==== Decimador CIC ====
+bool filtro_cic_init(filtro_cic_t *f, uint8_t orden, uint8_t log2_r)
+{
+    if (orden < 1 || orden > FILTRO_CIC_MAX_ORDEN) return false;
+    if (log2_r < 1 || orden * log2_r > 19) return false; // 12 bits + ganancia <= 31
+
+    f->orden  = orden;
+    f->log2_r = log2_r;
+    f->fase   = 0;
+    for (int i = 0; i < FILTRO_CIC_MAX_ORDEN; ++i) {
+        f->integ[i] = 0;
+        f->comb[i]  = 0;
+    }
+    return true;
+}
+
+// Un paso del filtro; devuelve true cuando toca sacar una muestra.
+static bool cic_paso(filtro_cic_t *f, int32_t x, int32_t *y_out)
+{
+    uint32_t acum = (uint32_t)x;
+    for (int i = 0; i < f->orden; ++i) {
+        f->integ[i] += acum;
+        acum = f->integ[i];
+    }
+
+    if (++f->fase < (1u << f->log2_r)) return false;
+    f->fase = 0;
+
+    for (int i = 0; i < f->orden; ++i) {
+        uint32_t previo = f->comb[i];
+        f->comb[i] = acum;
+        acum -= previo;
+    }
+    *y_out = (int32_t)acum >> (f->orden * f->log2_r);
+    return true;
+}
+
+void filtro_cic_cebar(filtro_cic_t *f, int32_t x0)
+{
+    // La respuesta al impulso dura orden * (R - 1) + 1 muestras:
+    // tras orden * R muestras constantes el filtro queda estacionario.
+    int32_t descarte;
+    uint32_t pasos = (uint32_t)f->orden << f->log2_r;
+    f->fase = 0;
+    for (uint32_t i = 0; i < pasos; ++i) {
+        cic_paso(f, x0, &descarte);
+    }
+}
+
+size_t filtro_cic_procesar(filtro_cic_t *f, const int32_t *in, size_t n, int32_t *out)
+{
+    size_t producidas = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (cic_paso(f, in[i], &out[producidas])) {
+            producidas++;
+        }
+    }
+    return producidas;
+}
+
+// ==== EMA en punto fijo ====
+void filtro_ema_init(filtro_ema_t *f, uint8_t alfa_q8)
+{
+    f->y_q8     = 0;
+    f->alfa_q8  = alfa_q8;
+    f->iniciado = false;
+}
+
+int32_t filtro_ema_actualizar(filtro_ema_t *f, int32_t x)
+{
+    int32_t x_q8 = x * 256;
+    if (!f->iniciado) {
+        f->y_q8 = x_q8;
+        f->iniciado = true;
+    } else {
+        f->y_q8 += (int32_t)(((int64_t)(x_q8 - f->y_q8) * f->alfa_q8) / 256);
+    }
+    return div_redondeo(f->y_q8, 256);
+}
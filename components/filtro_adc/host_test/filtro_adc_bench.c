@@ -0,0 +1,124 @@
+// Prueba de resultados contra una referencia (qsort) y costo por muestra
+// de cada filtro, en ns y en ciclos a RELOJ_MHZ (el reloj de la maquina
+// que corre la prueba; make RELOJ_MHZ=... para cambiarlo). Devuelve 1 si
+// algun resultado no coincide.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "filtro_adc.h"
+
+#define REPETICIONES 200000
+
+#ifndef RELOJ_MHZ
+#define RELOJ_MHZ    3000
+#endif
+
+static int cmp(const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double ahora_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static int probar(void)
+{
+    int malas = 0;
+    int32_t v[FILTRO_MAX_MUESTRAS], ref[FILTRO_MAX_MUESTRAS];
+
+    // Mediana: el inferior de los centrales, como qsort
+    for (int n = 1; n <= 16; n++) {
+        for (int it = 0; it < 20000; it++) {
+            for (int i = 0; i < n; i++) v[i] = ref[i] = rand() % 4096 - 100;
+            qsort(ref, n, sizeof(int32_t), cmp);
+            if (filtro_mediana(v, n) != ref[(n - 1) / 2]) malas++;
+        }
+    }
+
+    // Media recortada de 64 sin 16 por extremo
+    for (int it = 0; it < 1000; it++) {
+        for (int i = 0; i < 64; i++) v[i] = ref[i] = rand() % 4096;
+        qsort(ref, 64, sizeof(int32_t), cmp);
+        int64_t suma = 0;
+        for (int i = 16; i < 48; i++) suma += ref[i];
+        if (filtro_media_recortada(v, 64, 16) != (int32_t)((suma + 16) / 32)) malas++;
+    }
+
+    // CIC de orden 1 = promedio de cada bloque de R
+    filtro_cic_t f;
+    int32_t in[64], out[16];
+    filtro_cic_init(&f, 1, 3);
+    for (int i = 0; i < 64; i++) in[i] = rand() % 4096;
+    size_t k = filtro_cic_procesar(&f, in, 64, out);
+    for (size_t j = 0; j < k; j++) {
+        int64_t suma = 0;
+        for (int i = 0; i < 8; i++) suma += in[j * 8 + i];
+        if (out[j] != suma / 8) malas++;
+    }
+
+    // CIC de orden 3 cebado con una constante: la salida no se mueve
+    filtro_cic_init(&f, 3, 4);
+    filtro_cic_cebar(&f, 1234);
+    for (int i = 0; i < 64; i++) in[i] = 1234;
+    k = filtro_cic_procesar(&f, in, 64, out);
+    for (size_t j = 0; j < k; j++) {
+        if (out[j] != 1234) malas++;
+    }
+
+    printf("resultados: %s (%d distintos)\n", malas ? "FALLA" : "ok", malas);
+    return malas;
+}
+
+static volatile int32_t sumidero;
+
+#define MEDIR(nombre, n, expr)                                              \
+    do {                                                                    \
+        double t0 = ahora_ns();                                             \
+        for (int r = 0; r < REPETICIONES; r++) {                            \
+            for (int i = 0; i < (n); i++) buf[i] = (int32_t)((i * 2654435761u + r) & 4095); \
+            sumidero = (int32_t)(expr);                                     \
+        }                                                                   \
+        double ns = (ahora_ns() - t0) / REPETICIONES / (n);                 \
+        printf("%-24s %6.2f ns %6.1f ciclos/muestra\n", nombre, ns - base, \
+               (ns - base) * RELOJ_MHZ / 1000);                             \
+    } while (0)
+
+static void medir(void)
+{
+    int32_t buf[FILTRO_MAX_MUESTRAS], out[16];
+    filtro_cic_t f;
+    double base = 0;
+
+    // Costo de llenar el buffer, que se descuenta de cada medicion
+    {
+        double t0 = ahora_ns();
+        for (int r = 0; r < REPETICIONES; r++) {
+            for (int i = 0; i < 64; i++) buf[i] = (int32_t)((i * 2654435761u + r) & 4095);
+            sumidero = buf[0];
+        }
+        base = (ahora_ns() - t0) / REPETICIONES / 64;
+    }
+
+    printf("costo por muestra (ciclos a %d MHz)\n", RELOJ_MHZ);
+    MEDIR("mediana de 5", 5, filtro_mediana(buf, 5));
+    MEDIR("mediana de 9", 9, filtro_mediana(buf, 9));
+    MEDIR("mediana de 16", 16, filtro_mediana(buf, 16));
+    MEDIR("recortada 8 (2)", 8, filtro_media_recortada(buf, 8, 2));
+    MEDIR("recortada 64 (16)", 64, filtro_media_recortada(buf, 64, 16));
+    MEDIR("decimar 60 (mediana 5)", 60, filtro_mediana_decimar(buf, 60, 5, out));
+    filtro_cic_init(&f, 2, 3);
+    MEDIR("CIC orden 2, R = 8", 64, filtro_cic_procesar(&f, buf, 64, out));
+}
+
+int main(void)
+{
+    srand(1);
+    int malas = probar();
+    medir();
+    return malas != 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==== Filtros en punto fijo para lecturas del ADC ====
+// Pensados para muestras crudas (0..4095) o milivoltios: todo es entero,
+// sin floats ni memoria dinamica, para poder usarlos en cualquier tarea.
+
+// Maximo de muestras por bloque (buffers en pila de los drivers)
+#define FILTRO_MAX_MUESTRAS     64
+// Orden maximo del decimador CIC
+#define FILTRO_CIC_MAX_ORDEN    4
+
+/**
+ * @brief Mediana de n muestras usando redes de ordenamiento sin saltos.
+ *
+ * Para n = 3, 5, 7 y 9 usa redes de seleccion optimas; para otros n
+ * usa una red par-impar completa. Reordena el arreglo en sitio.
+ *
+ * @param v Muestras (se modifican).
+ * @param n Cantidad de muestras (1..FILTRO_MAX_MUESTRAS).
+ * @return Valor mediano (para n par, el inferior de los dos centrales).
+ */
+int32_t filtro_mediana(int32_t *v, size_t n);
+
+/**
+ * @brief Media recortada: ordena y promedia descartando 'recorte' muestras
+ * en cada extremo. Rechaza picos (p. ej. rafagas de TX del WiFi).
+ *
+ * @param v Muestras (se ordenan en sitio).
+ * @param n Cantidad de muestras (1..FILTRO_MAX_MUESTRAS).
+ * @param recorte Muestras descartadas por extremo (se limita a (n-1)/2).
+ * @return Media redondeada de las muestras centrales.
+ */
+int32_t filtro_media_recortada(int32_t *v, size_t n, size_t recorte);
+
+/**
+ * @brief Decima un bloque tomando la mediana de cada grupo de k muestras.
+ *
+ * @param in  Muestras de entrada (se reordenan por grupos).
+ * @param n   Cantidad de muestras; las que no completan un grupo se ignoran.
+ * @param k   Tamano del grupo (3, 5, 7 o 9 son los mas baratos).
+ * @param out Salida, n / k valores.
+ * @return Cantidad de valores escritos en out.
+ */
+size_t filtro_mediana_decimar(int32_t *in, size_t n, size_t k, int32_t *out);
+
+/**
+ * Decimador CIC (Hogenauer) de orden N y factor R = 2^log2_r.
+ * Con orden 1 es una media movil de R muestras decimada por R.
+ * Aritmetica modular en 32 bits: la ganancia R^N debe caber, es decir
+ * bits_entrada + orden * log2_r <= 32.
+ */
+typedef struct {
+    uint8_t  orden;
+    uint8_t  log2_r;
+    uint16_t fase;
+    uint32_t integ[FILTRO_CIC_MAX_ORDEN];
+    uint32_t comb[FILTRO_CIC_MAX_ORDEN];
+} filtro_cic_t;
+
+/**
+ * @brief Inicializa el decimador.
+ * @return false si orden/log2_r estan fuera de rango.
+ */
+bool filtro_cic_init(filtro_cic_t *f, uint8_t orden, uint8_t log2_r);
+
+/**
+ * @brief Lleva el filtro al estado estacionario para una entrada constante,
+ * evitando el transitorio inicial de orden * R muestras.
+ */
+void filtro_cic_cebar(filtro_cic_t *f, int32_t x0);
+
+/**
+ * @brief Procesa un bloque de muestras.
+ * @param out Debe tener espacio para n / R + 1 valores.
+ * @return Cantidad de salidas producidas (ya normalizadas por R^N).
+ */
+size_t filtro_cic_procesar(filtro_cic_t *f, const int32_t *in, size_t n, int32_t *out);
+
+/**
+ * Media movil exponencial en punto fijo (estado en Q8).
+ * alfa_q8 = alfa * 256, p. ej. 26 ~ 0.10.
+ */
+typedef struct {
+    int32_t y_q8;
+    uint8_t alfa_q8;
+    bool    iniciado;
+} filtro_ema_t;
+
+void    filtro_ema_init(filtro_ema_t *f, uint8_t alfa_q8);
+int32_t filtro_ema_actualizar(filtro_ema_t *f, int32_t x);
+
+#ifdef __cplusplus
+}
+#endif
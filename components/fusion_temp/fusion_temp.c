@@ -0,0 +1,122 @@
+#include "fusion_temp.h"
+
+// Peso de cada diferencia nueva en la varianza aprendida (1/16)
+#define R_APRENDE_LOG2  4
+// Primeras lecturas: el promedio de R se arma rapido y despues se asienta
+#define R_ARRANQUE      16
+// Peso de cada innovacion en la pendiente (1/2048 por segundo de innovacion):
+// mas chico sigue antes una rampa y mete mas ruido en la salida quieta
+#define DERIVA_LOG2     11
+
+void fusion_init(fusion_t *f, uint32_t q_cc2_s)
+{
+    *f = (fusion_t){ .q = q_cc2_s };
+}
+
+int fusion_agregar_fuente(fusion_t *f, uint32_t r_inicial)
+{
+    if (f->n_fuentes >= FUSION_MAX_FUENTES) return -1;
+    if (r_inicial < FUSION_R_MIN) r_inicial = FUSION_R_MIN;
+    f->fuente[f->n_fuentes] = (fusion_fuente_t){ .r = r_inicial };
+    return f->n_fuentes++;
+}
+
+void fusion_predecir(fusion_t *f, uint32_t dt_ms)
+{
+    if (!f->iniciado) return;
+    f->x_q8 += (int32_t)(((int64_t)f->deriva_q8 * dt_ms + 500) / 1000);
+    f->dt_ms = dt_ms;
+    uint64_t p = f->p_q8 + (((uint64_t)f->q * dt_ms << 8) + 500) / 1000;
+    f->p_q8 = (p > UINT32_MAX) ? UINT32_MAX : (uint32_t)p;
+}
+
+// Varianza de ruido a partir de diferencias sucesivas: var(dz) = 2R
+static void aprender_r(fusion_fuente_t *s, int32_t z_cc)
+{
+    if (s->iniciada) {
+        int64_t d = (int64_t)z_cc - s->ultima_cc;
+        uint64_t muestra = (uint64_t)(d * d) / 2;
+        if (muestra > UINT32_MAX / 2) muestra = UINT32_MAX / 2;
+        // Promedio exponencial; al principio con peso 1/n para no depender de r_inicial
+        if (s->lecturas < R_ARRANQUE) {
+            uint32_t n = s->lecturas + 1;
+            s->r = (uint32_t)(((uint64_t)s->r * (n - 1) + muestra) / n);
+        } else {
+            // Un escalon real no es ruido: la muestra se recorta a 9R
+            if (muestra > 9 * (uint64_t)s->r) muestra = 9 * (uint64_t)s->r;
+            int64_t r = (int64_t)s->r + (((int64_t)muestra - s->r) >> R_APRENDE_LOG2);
+            s->r = (uint32_t)r;
+        }
+        if (s->r < FUSION_R_MIN) s->r = FUSION_R_MIN;
+    }
+    s->ultima_cc = z_cc;
+    s->iniciada = true;
+    if (s->lecturas < UINT32_MAX) s->lecturas++;
+}
+
+void fusion_medir(fusion_t *f, int fuente, int32_t z_cc)
+{
+    if (fuente < 0 || fuente >= f->n_fuentes) return;
+    fusion_fuente_t *s = &f->fuente[fuente];
+    aprender_r(s, z_cc);
+
+    if (!f->iniciado) {
+        // La primera lectura fija el estado con la incertidumbre de esa fuente
+        f->x_q8 = z_cc * 256;
+        f->p_q8 = (s->r > UINT32_MAX >> 8) ? UINT32_MAX : s->r << 8;
+        f->iniciado = true;
+        return;
+    }
+
+    uint64_t r_q8 = (uint64_t)s->r << 8;
+    int64_t innov_q8 = (int64_t)z_cc * 256 - f->x_q8;
+
+    // Prueba de 3 sigma: innov^2 > 9 (P + R). Un pico aislado pasa como
+    // ruido; dos seguidos del mismo lado son un cambio que el modelo no
+    // preveia y P toma la innovacion al cuadrado (K casi 1)
+    int64_t innov_cc = innov_q8 / 256;
+    bool salto = false;
+    uint64_t innov2 = (uint64_t)(innov_cc * innov_cc);
+    if (innov2 > 9 * ((f->p_q8 + r_q8) >> 8)) {
+        int8_t signo = (innov_cc > 0) ? 1 : -1;
+        if (f->fuera == signo) {
+            salto = true;
+            // En contra de la pendiente: la rampa termino
+            if ((f->deriva_q8 > 0) != (signo > 0)) f->deriva_q8 = 0;
+            uint64_t p = innov2 << 8;
+            if (p > UINT32_MAX) p = UINT32_MAX;
+            if (p > f->p_q8) f->p_q8 = (uint32_t)p;
+            f->saltos++;
+        }
+        f->fuera = signo;
+    } else {
+        f->fuera = 0;
+    }
+
+    // Ganancia K = P / (P + R) en Q16
+    uint32_t k_q16 = (uint32_t)(((uint64_t)f->p_q8 << 16) / (f->p_q8 + r_q8));
+    f->x_q8 += (int32_t)((innov_q8 * k_q16 + (1 << 15)) >> 16);
+    f->p_q8 -= (uint32_t)(((uint64_t)f->p_q8 * k_q16) >> 16);
+
+    // Pendiente: la innovacion por segundo, integrada despacio. Un salto ya
+    // lo absorbe P; si entrara aca seguiria de largo despues del escalon
+    if (!salto && f->dt_ms > 0) f->deriva_q8 += (int32_t)((innov_q8 * 1000 / f->dt_ms) >> DERIVA_LOG2);
+}
+
+uint32_t fusion_desvio_cc(const fusion_t *f)
+{
+    if (!f->iniciado) return 0;
+    // Raiz entera de P (cc^2 * 256) -> desvio en cc * 16, redondeado a cc
+    uint32_t v = f->p_q8, r = 0, bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (r + 8) >> 4;
+}
@@ -0,0 +1,212 @@
+// Reproduce la traza sintetica (generar_traza.py) con tres cadenas de
+// salida y compara ruido en quieto, respuesta a un escalon y error en una
+// rampa de 1 °C/min:
+//   ema       20 muestras por tick y EMA de alfa 26/256 (driver anterior)
+//   fusion    10 muestras por tick y Kalman con el LM35 solo
+//   fusion+ntc lo mismo con el NTC como segunda fuente y su offset contra
+//             el LM35 seguido despacio, como en Temp_LM35.c
+// Devuelve 1 si la fusion no mejora al EMA o si su desvio no es creible.
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "filtro_adc.h"
+#include "fusion_temp.h"
+
+#define MAX_TICKS       8000
+#define TICK_MS         100
+#define EMA_ALFA_Q8     26      // El del driver anterior
+#define Q_CC2_S         2       // Los de Temp_LM35.c
+#define R_INICIAL       100
+#define NTC_OFFSET_LOG2 8
+#define REPETICIONES    200
+
+enum { CALENTAMIENTO, QUIETO, ESCALON, RAMPA };
+
+typedef struct {
+    int fase;
+    int32_t real_cc, lm35_20_cc, lm35_10_cc, ntc_cc;
+} tick_t;
+
+static tick_t traza[MAX_TICKS];
+static int n_ticks;
+
+static int malas;
+
+#define CHECK(cond, ...) do { if (!(cond)) { malas++; printf("  FALLA: " __VA_ARGS__); printf("\n"); } } while (0)
+
+static double ahora_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static bool leer_traza(const char *ruta)
+{
+    FILE *f = fopen(ruta, "r");
+    if (f == NULL) return false;
+    char linea[128];
+    if (fgets(linea, sizeof(linea), f) == NULL) { fclose(f); return false; }   // Encabezado
+    long ms;
+    tick_t t;
+    while (n_ticks < MAX_TICKS &&
+           fscanf(f, "%ld,%d,%d,%d,%d,%d", &ms, &t.fase, &t.real_cc, &t.lm35_20_cc, &t.lm35_10_cc, &t.ntc_cc) == 6) {
+        traza[n_ticks++] = t;
+    }
+    fclose(f);
+    return n_ticks > 0;
+}
+
+// ---------------------------------------------------------------
+// Cadenas de salida
+// ---------------------------------------------------------------
+typedef enum { EMA, FUSION, FUSION_NTC } cadena_t;
+
+static const char *const nombres[] = { "ema", "fusion", "fusion+ntc" };
+static const int lecturas_adc[] = { 20, 10, 10 + 8 };
+
+typedef struct {
+    filtro_ema_t ema;
+    fusion_t f;
+    int src_lm35, src_ntc;
+    bool ntc_alineado;
+    int32_t ntc_offset_q8;
+} estado_t;
+
+static void iniciar(estado_t *e, cadena_t c)
+{
+    filtro_ema_init(&e->ema, EMA_ALFA_Q8);
+    fusion_init(&e->f, Q_CC2_S);
+    e->src_lm35 = fusion_agregar_fuente(&e->f, R_INICIAL);
+    e->src_ntc = (c == FUSION_NTC) ? fusion_agregar_fuente(&e->f, R_INICIAL) : -1;
+    e->ntc_alineado = false;
+    e->ntc_offset_q8 = 0;
+}
+
+static int32_t paso(estado_t *e, cadena_t c, const tick_t *t)
+{
+    if (c == EMA) return filtro_ema_actualizar(&e->ema, t->lm35_20_cc);
+
+    fusion_predecir(&e->f, TICK_MS);
+    fusion_medir(&e->f, e->src_lm35, t->lm35_10_cc);
+    if (e->src_ntc >= 0) {
+        int32_t diff_q8 = (t->ntc_cc - t->lm35_10_cc) * 256;
+        if (!e->ntc_alineado) {
+            e->ntc_offset_q8 = diff_q8;
+            e->ntc_alineado = true;
+        } else {
+            e->ntc_offset_q8 += (diff_q8 - e->ntc_offset_q8) >> NTC_OFFSET_LOG2;
+        }
+        fusion_medir(&e->f, e->src_ntc, t->ntc_cc - ((e->ntc_offset_q8 + 128) >> 8));
+    }
+    return fusion_valor_cc(&e->f);
+}
+
+// ---------------------------------------------------------------
+// Medidas
+// ---------------------------------------------------------------
+typedef struct {
+    double desvio, max, sesgo, sigma;   // Quieto (°C)
+    double t10_90, t90;                 // Escalon (s)
+    double rampa_rms;                   // °C, con el atraso incluido
+} medida_t;
+
+static medida_t correr(cadena_t c)
+{
+    estado_t e;
+    iniciar(&e, c);
+
+    medida_t m = { 0 };
+    double s = 0, s2 = 0, sigma = 0, r2 = 0;
+    int n = 0, nr = 0, i_escalon = -1, i10 = -1, i90 = -1, i_rampa = -1;
+    int32_t antes_cc = 0, despues_cc = 0;
+
+    for (int i = 0; i < n_ticks; i++) {
+        const tick_t *t = &traza[i];
+        double y = paso(&e, c, t) / 100.0;
+        double err = y - t->real_cc / 100.0;
+
+        if (t->fase == QUIETO) {
+            s += err;
+            s2 += err * err;
+            if (fabs(err) > m.max) m.max = fabs(err);
+            if (c != EMA) sigma += fusion_desvio_cc(&e.f) / 100.0;
+            n++;
+            antes_cc = t->real_cc;
+        } else if (t->fase == ESCALON) {
+            if (i_escalon < 0) i_escalon = i;
+            despues_cc = t->real_cc;
+            double avance = (y * 100 - antes_cc) / (despues_cc - antes_cc);
+            if (i10 < 0 && avance > 0.1) i10 = i;
+            if (i90 < 0 && avance > 0.9) i90 = i;
+        } else if (t->fase == RAMPA) {
+            if (i_rampa < 0) i_rampa = i;
+            // Los primeros 30 s son la transicion al regimen de rampa
+            if (i - i_rampa >= 300) {
+                r2 += err * err;
+                nr++;
+            }
+        }
+    }
+
+    m.sesgo = s / n;
+    m.desvio = sqrt(s2 / n - m.sesgo * m.sesgo);
+    m.sigma = sigma / n;
+    m.t10_90 = (i90 - i10) * TICK_MS / 1000.0;
+    m.t90 = (i90 - i_escalon + 1) * TICK_MS / 1000.0;
+    m.rampa_rms = sqrt(r2 / nr);
+    return m;
+}
+
+static double costo_ns(cadena_t c)
+{
+    estado_t e;
+    volatile uint32_t sumidero = 0;
+    double t0 = ahora_ns();
+    for (int k = 0; k < REPETICIONES; k++) {
+        iniciar(&e, c);
+        for (int i = 0; i < n_ticks; i++) sumidero += (uint32_t)paso(&e, c, &traza[i]);
+    }
+    (void)sumidero;
+    return (ahora_ns() - t0) / ((double)REPETICIONES * n_ticks);
+}
+
+int main(int argc, char **argv)
+{
+    const char *ruta = argc > 1 ? argv[1] : "traza_lm35_ntc.csv";
+    if (!leer_traza(ruta)) {
+        printf("no se pudo leer %s\n", ruta);
+        return 1;
+    }
+    printf("%s: %d ticks de %d ms\n", ruta, n_ticks, TICK_MS);
+    printf("%-11s %6s %6s %7s %6s | %7s %6s | %7s | %4s %7s\n", "", "desvio", "max", "sesgo", "sigma",
+           "10-90 %", "90 %", "rampa", "ADC", "costo");
+
+    medida_t m[3];
+    for (cadena_t c = EMA; c <= FUSION_NTC; c++) {
+        m[c] = correr(c);
+        char sigma[16] = "     -";     // El EMA no informa confianza
+        if (c != EMA) snprintf(sigma, sizeof(sigma), "%6.3f", m[c].sigma);
+        printf("%-11s %6.3f %6.3f %+7.3f %s | %5.1f s %4.1f s | %5.3f C | %4d %5.0f ns\n", nombres[c],
+               m[c].desvio, m[c].max, m[c].sesgo, sigma, m[c].t10_90, m[c].t90, m[c].rampa_rms,
+               lecturas_adc[c], costo_ns(c));
+    }
+
+    // La fusion con la mitad de lecturas del ADC no puede ser mas ruidosa
+    // ni mas lenta que el EMA, ni quedar mas atrasada en la rampa
+    for (cadena_t c = FUSION; c <= FUSION_NTC; c++) {
+        CHECK(m[c].desvio <= m[EMA].desvio, "%s: desvio %.3f C contra %.3f C del EMA", nombres[c], m[c].desvio, m[EMA].desvio);
+        CHECK(m[c].t90 < m[EMA].t90 / 2, "%s: 90 %% del escalon a los %.1f s", nombres[c], m[c].t90);
+        CHECK(m[c].rampa_rms <= m[EMA].rampa_rms, "%s: rampa %.3f C contra %.3f C del EMA", nombres[c],
+              m[c].rampa_rms, m[EMA].rampa_rms);
+        // El desvio informado tiene que ser del orden del medido
+        CHECK(m[c].sigma > m[c].desvio / 3 && m[c].sigma < m[c].desvio * 3,
+              "%s: sigma %.3f C con desvio real %.3f C", nombres[c], m[c].sigma, m[c].desvio);
+    }
+    CHECK(m[FUSION_NTC].desvio <= m[FUSION].desvio * 1.05, "el NTC empeora el desvio");
+
+    printf("resultados: %s\n", malas ? "FALLA" : "ok");
+    return malas ? 1 : 0;
+}
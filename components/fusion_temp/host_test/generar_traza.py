@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Genera la traza sintetica que reproduce fusion_bench: un LM35 y un NTC
+al lado, simulados a 10 Hz (tick de control) con el modelo de ADC de los
+otros bancos de prueba (ruido gaussiano de 12 LSB y un 3 % de picos del WiFi de
+40..120 LSB). Cada fila lleva la lectura de un tick ya convertida a
+centesimas, como sale de la adquisicion de Temp_LM35.c:
+
+  lm35_20_cc  20 muestras, mediana de 5 y media recortada (driver anterior)
+  lm35_10_cc  10 muestras, mediana de 5 y media (driver con fusion)
+  ntc_cc      8 muestras, media recortada, modelo Beta 3950 de un NTC
+              que en realidad es Beta 3800 (error absoluto de ~0.5 C)
+
+No es una grabacion de la placa. Semilla fija: volver a generarla da el
+mismo archivo.
+
+  python3 generar_traza.py traza_lm35_ntc.csv
+"""
+import math
+import random
+import sys
+
+TICK_MS = 100
+RUIDO_LSB = 12
+P_PICO = 0.03
+FS_0DB = 1100       # mV a fondo de escala del rango del LM35 (autorrango)
+FS_12DB = 3300      # Rango del NTC
+NTC_BETA_REAL = 3800
+NTC_BETA_DRIVER = 3950
+
+# Fases: 0 calentamiento, 1 quieto, 2 escalon, 3 rampa
+FASES = (
+    (0, 600, lambda i: 25.0),
+    (1, 3000, lambda i: 25.0),
+    (2, 600, lambda i: 30.0),
+    (3, 1800, lambda i: 30.0 + i / 600.0),   # 1 C/min
+)
+
+
+def muestra(rnd, mv, fs):
+    x = mv / fs * 4095 + RUIDO_LSB * rnd.gauss(0, 1)
+    if rnd.random() < P_PICO:
+        x += rnd.choice((-1, 1)) * rnd.randint(40, 119)
+    return min(max(round(x), 0), 4095)
+
+
+def media_recortada(v, recorte):
+    v = sorted(v)
+    v = v[recorte:len(v) - recorte]
+    return round(sum(v) / len(v))
+
+
+def lm35_cc(rnd, t, n):
+    q4 = [muestra(rnd, t * 10, FS_0DB) * 16 for _ in range(n)]
+    medianas = [sorted(q4[i:i + 5])[2] for i in range(0, n, 5)]
+    avg_q4 = media_recortada(medianas, len(medianas) // 4)
+    mv_q4 = avg_q4 * FS_0DB // 4095
+    return (mv_q4 * 10 + 8) // 16
+
+
+def ntc_cc(rnd, t):
+    r = 10000 * math.exp(NTC_BETA_REAL * (1 / (t + 273.15) - 1 / 298.15))
+    mv = FS_12DB * r / (10000 + r)
+    q4 = [muestra(rnd, mv, FS_12DB) * 16 for _ in range(8)]
+    mv = media_recortada(q4, 2) * FS_12DB / 4095 / 16
+    r = 10000 * mv / (FS_12DB - mv)
+    inv_t = 1 / 298.15 + math.log(r / 10000) / NTC_BETA_DRIVER
+    return round((1 / inv_t - 273.15) * 100)
+
+
+def main():
+    rnd = random.Random(7)
+    ms = 0
+    with open(sys.argv[1] if len(sys.argv) > 1 else "traza_lm35_ntc.csv", "w") as out:
+        out.write("ms,fase,real_cc,lm35_20_cc,lm35_10_cc,ntc_cc\n")
+        for fase, ticks, real in FASES:
+            for i in range(ticks):
+                t = real(i)
+                out.write("%d,%d,%d,%d,%d,%d\n" % (ms, fase, round(t * 100), lm35_cc(rnd, t, 20),
+                                                   lm35_cc(rnd, t, 10), ntc_cc(rnd, t)))
+                ms += TICK_MS
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==== Fusion de sensores de temperatura (Kalman escalar en punto fijo) ====
+// Un solo estado (la temperatura, en centesimas) que avanza como paseo al
+// azar mas una pendiente, y varias fuentes que lo miden, cada una con su
+// varianza de ruido R. La pendiente se aprende integrando despacio las
+// innovaciones (como la beta de un filtro alfa-beta): en una rampa lenta la
+// salida no queda atrasada.
+// R no se configura: se aprende de la varianza de las diferencias entre
+// lecturas sucesivas de cada fuente (var(z[k] - z[k-1]) ~ 2R con la
+// temperatura casi quieta). La varianza P del estado es la confianza de
+// la salida. Con q chico filtra mucho; un cambio real se detecta porque la
+// innovacion sale de 3 sigma dos veces seguidas con el mismo signo, y ahi
+// P se agranda para seguirlo enseguida. Todo en enteros, sin memoria dinamica.
+
+#define FUSION_MAX_FUENTES  4
+#define FUSION_R_MIN        4       // cc^2: piso de R (0.02 °C), evita ganancia 1
+
+typedef struct {
+    bool     iniciada;
+    int32_t  ultima_cc;     // Lectura anterior (para aprender R)
+    uint32_t r;             // Varianza de ruido en cc^2
+    uint32_t lecturas;
+} fusion_fuente_t;
+
+typedef struct {
+    bool     iniciado;
+    int32_t  x_q8;          // Estado en centesimas * 256
+    uint32_t p_q8;          // Varianza del estado en cc^2 * 256
+    uint32_t q;             // Ruido de proceso en cc^2 por segundo
+    int32_t  deriva_q8;     // Pendiente en centesimas * 256 por segundo
+    uint32_t dt_ms;         // Paso del ultimo fusion_predecir
+    int8_t   fuera;         // Signo de la ultima innovacion fuera de 3 sigma (0 = dentro)
+    uint32_t saltos;        // Cambios detectados
+    uint8_t  n_fuentes;
+    fusion_fuente_t fuente[FUSION_MAX_FUENTES];
+} fusion_t;
+
+/**
+ * @brief Inicializa el filtro.
+ * @param q_cc2_s Cuanto puede variar la temperatura real por segundo
+ *        (varianza en cc^2/s). Mas grande = sigue mas rapido y filtra menos.
+ */
+void fusion_init(fusion_t *f, uint32_t q_cc2_s);
+
+/**
+ * @brief Agrega una fuente con su R inicial (cc^2) hasta que aprenda la propia.
+ * @return Indice de la fuente o -1 si no hay lugar.
+ */
+int fusion_agregar_fuente(fusion_t *f, uint32_t r_inicial);
+
+/**
+ * @brief Avanza el modelo 'dt_ms': el estado sigue la pendiente y la
+ * incertidumbre crece q * dt.
+ */
+void fusion_predecir(fusion_t *f, uint32_t dt_ms);
+
+/**
+ * @brief Incorpora una lectura (centesimas) de la fuente indicada.
+ */
+void fusion_medir(fusion_t *f, int fuente, int32_t z_cc);
+
+static inline int32_t fusion_valor_cc(const fusion_t *f)
+{
+    return (f->x_q8 + 128) >> 8;
+}
+
+/**
+ * @brief Desvio estandar de la salida en centesimas (0 sin lecturas).
+ */
+uint32_t fusion_desvio_cc(const fusion_t *f);
+
+#ifdef __cplusplus
+}
+#endif
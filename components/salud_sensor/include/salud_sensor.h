@@ -0,0 +1,66 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==== Salud de un sensor (plausibilidad de cada lectura) ====
+// Tres pruebas incrementales por lectura, todas con el estado de la lectura
+// anterior: rango fisico, valor crudo trabado y velocidad de cambio. Una
+// lectura mala aislada no declara la falla: hacen falta 'malas_para_falla'
+// seguidas, y para salir 'buenas_para_salir' buenas seguidas. Cuesta unas
+// pocas comparaciones, una multiplicacion y una division; sin floats ni
+// memoria dinamica.
+
+typedef enum {
+    SALUD_OK = 0,
+    SALUD_ERROR_LECTURA,    // El driver no pudo leer
+    SALUD_FUERA_RANGO,      // Fuera del rango fisico (abierto, en corto, saturado)
+    SALUD_TRABADO,          // El mismo valor crudo demasiadas veces seguidas
+    SALUD_SALTO,            // Cambio mas rapido de lo que puede el sensor
+} salud_falla_t;
+
+typedef struct {
+    int32_t  min, max;          // Rango plausible (unidades del valor)
+    int32_t  paso_min;          // Cambio aceptado siempre entre lecturas (ruido)
+    int32_t  tasa_max;          // Cambio por segundo aceptado ademas de paso_min
+    uint16_t iguales_max;       // Lecturas con el mismo crudo antes de "trabado"
+    uint8_t  malas_para_falla;
+    uint8_t  buenas_para_salir;
+} salud_limites_t;
+
+typedef struct {
+    bool     iniciada;
+    bool     en_falla;
+    uint8_t  malas, buenas;     // Racha actual
+    uint16_t iguales;
+    int32_t  anterior;          // Ultimo valor leido (bueno o malo)
+    int32_t  crudo_anterior;
+    salud_falla_t motivo;       // De la ultima lectura mala
+    uint32_t fallas;            // Veces que entro en falla
+} salud_t;
+
+void salud_init(salud_t *s);
+
+/**
+ * @brief Evalua una lectura.
+ * @param valor Lectura en las unidades de los limites.
+ * @param crudo Valor antes de convertir (p. ej. cuentas promediadas): un
+ *        ADC con ruido nunca repite exactamente el mismo por mucho tiempo.
+ * @param dt_ms Tiempo desde la lectura anterior.
+ * @return SALUD_OK si la lectura es plausible; si no, el motivo.
+ */
+salud_falla_t salud_evaluar(salud_t *s, const salud_limites_t *lim, int32_t valor, int32_t crudo, uint32_t dt_ms);
+
+/**
+ * @brief Registra una lectura que no se pudo hacer (cuenta como mala).
+ */
+void salud_error(salud_t *s, const salud_limites_t *lim);
+
+const char *salud_falla_str(salud_falla_t f);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+#include "salud_sensor.h"
+
+void salud_init(salud_t *s)
+{
+    *s = (salud_t){ .motivo = SALUD_OK };
+}
+
+// Racha de buenas o malas con histeresis para entrar y salir de la falla
+static void contar(salud_t *s, const salud_limites_t *lim, salud_falla_t r)
+{
+    if (r == SALUD_OK) {
+        s->malas = 0;
+        if (s->en_falla && ++s->buenas >= lim->buenas_para_salir) {
+            s->en_falla = false;
+            s->buenas = 0;
+        }
+        return;
+    }
+    s->buenas = 0;
+    s->motivo = r;
+    if (!s->en_falla && ++s->malas >= lim->malas_para_falla) {
+        s->en_falla = true;
+        s->malas = 0;
+        s->fallas++;
+    }
+}
+
+salud_falla_t salud_evaluar(salud_t *s, const salud_limites_t *lim, int32_t valor, int32_t crudo, uint32_t dt_ms)
+{
+    salud_falla_t r = SALUD_OK;
+
+    if (valor < lim->min || valor > lim->max) {
+        r = SALUD_FUERA_RANGO;
+    } else if (s->iniciada) {
+        // Trabado: se compara el crudo, el valor ya convertido puede repetirse
+        if (crudo == s->crudo_anterior) {
+            if (s->iguales < UINT16_MAX) s->iguales++;
+        } else {
+            s->iguales = 0;
+        }
+        // Se compara con la lectura anterior y no con la ultima buena: tras
+        // un cambio real solo la lectura del salto cuenta como mala
+        int64_t paso = (int64_t)valor - s->anterior;
+        if (paso < 0) paso = -paso;
+        int64_t permitido = lim->paso_min + (int64_t)lim->tasa_max * dt_ms / 1000;
+        if (s->iguales >= lim->iguales_max) r = SALUD_TRABADO;
+        else if (paso > permitido) r = SALUD_SALTO;
+    }
+
+    s->anterior = valor;
+    s->crudo_anterior = crudo;
+    s->iniciada = true;
+    contar(s, lim, r);
+    return r;
+}
+
+void salud_error(salud_t *s, const salud_limites_t *lim)
+{
+    contar(s, lim, SALUD_ERROR_LECTURA);
+}
+
+const char *salud_falla_str(salud_falla_t f)
+{
+    switch (f) {
+        case SALUD_OK:            return "ok";
+        case SALUD_ERROR_LECTURA: return "lectura";
+        case SALUD_FUERA_RANGO:   return "rango";
+        case SALUD_TRABADO:       return "trabado";
+        case SALUD_SALTO:         return "salto";
+    }
+    return "?";
+}